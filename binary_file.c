@@ -30,6 +30,9 @@
 #include "grid.h"
 #include "interaction_data.h"
 
+/** number of particles that readmd sends to the nodes at once */
+#define READMD_CHUNK 65536
+
 /* cwz-build-comman: ssh chakotay "builtin cd /nhomes/janeway/axel/progs/Espresso; make" 
    cwz-build-command: make
 */
@@ -39,7 +42,7 @@ int writemd(ClientData data, Tcl_Interp *interp,
 {
   static int end_num = -1;
   char *row;
-  int p, i;
+  int p, i, j, fields, *order;
   struct MDHeader header;
   int tcl_file_mode;
   Tcl_Channel channel;
@@ -140,8 +143,27 @@ int writemd(ClientData data, Tcl_Interp *interp,
     argv++;
   }
 
-  if (!particle_node)
-    build_particle_node();
+  /* fetch only the fields that are written */
+  fields = 0;
+  for (i = 0; i < argc; i++) {
+    switch (row[i]) {
+    case POSX: case POSY: case POSZ: fields |= PCFG_POS; break;
+    case VX:   case VY:   case VZ:   fields |= PCFG_V; break;
+    case FX:   case FY:   case FZ:   fields |= PCFG_F; break;
+    case MASSES: fields |= PCFG_MASS; break;
+    case Q:      fields |= PCFG_Q; break;
+    case MX:   case MY:   case MZ:   fields |= PCFG_DIP; break;
+    case TYPE:   fields |= PCFG_TYPE; break;
+    }
+  }
+  updatePartCfgFields(fields);
+
+  /* write the particles ordered by identity */
+  order = malloc((max_seen_particle + 1)*sizeof(int));
+  for (p = 0; p <= max_seen_particle; p++)
+    order[p] = -1;
+  for (j = 0; j < partCfgFields.n; j++)
+    order[partCfgFields.identity[j]] = j;
 
   /* write header and row data */
   memcpy(header.magic, MDMAGIC, 4*sizeof(char));
@@ -150,41 +172,38 @@ int writemd(ClientData data, Tcl_Interp *interp,
   Tcl_Write(channel, row, header.n_rows*sizeof(char));
 
   for (p = 0; p <= max_seen_particle; p++) {
-    Particle data;
-    if (get_particle_data(p, &data)) {
-      unfold_position(data.r.p, data.l.i);
-
+    if ((j = order[p]) >= 0) {
       /* write particle index */
       Tcl_Write(channel, (char *)&p, sizeof(int));
 
       for (i = 0; i < header.n_rows; i++) {
 	switch (row[i]) {
-	case POSX: Tcl_Write(channel, (char *)&data.r.p[0], sizeof(double)); break;
-	case POSY: Tcl_Write(channel, (char *)&data.r.p[1], sizeof(double)); break;
-	case POSZ: Tcl_Write(channel, (char *)&data.r.p[2], sizeof(double)); break;
-	case VX:   Tcl_Write(channel, (char *)&data.m.v[0], sizeof(double)); break;
-	case VY:   Tcl_Write(channel, (char *)&data.m.v[1], sizeof(double)); break;
-	case VZ:   Tcl_Write(channel, (char *)&data.m.v[2], sizeof(double)); break;
-	case FX:   Tcl_Write(channel, (char *)&data.f.f[0], sizeof(double)); break;
-	case FY:   Tcl_Write(channel, (char *)&data.f.f[1], sizeof(double)); break;
-	case FZ:   Tcl_Write(channel, (char *)&data.f.f[2], sizeof(double)); break;
+	case POSX: Tcl_Write(channel, (char *)&partCfgFields.pos[3*j], sizeof(double)); break;
+	case POSY: Tcl_Write(channel, (char *)&partCfgFields.pos[3*j+1], sizeof(double)); break;
+	case POSZ: Tcl_Write(channel, (char *)&partCfgFields.pos[3*j+2], sizeof(double)); break;
+	case VX:   Tcl_Write(channel, (char *)&partCfgFields.v[3*j], sizeof(double)); break;
+	case VY:   Tcl_Write(channel, (char *)&partCfgFields.v[3*j+1], sizeof(double)); break;
+	case VZ:   Tcl_Write(channel, (char *)&partCfgFields.v[3*j+2], sizeof(double)); break;
+	case FX:   Tcl_Write(channel, (char *)&partCfgFields.f[3*j], sizeof(double)); break;
+	case FY:   Tcl_Write(channel, (char *)&partCfgFields.f[3*j+1], sizeof(double)); break;
+	case FZ:   Tcl_Write(channel, (char *)&partCfgFields.f[3*j+2], sizeof(double)); break;
 #ifdef MASS
-	case MASSES: Tcl_Write(channel, (char *)&data.p.mass, sizeof(double)); break;
+	case MASSES: Tcl_Write(channel, (char *)&partCfgFields.mass[j], sizeof(double)); break;
 #endif
 #ifdef ELECTROSTATICS
-	case Q:    Tcl_Write(channel, (char *)&data.p.q, sizeof(double)); break;
+	case Q:    Tcl_Write(channel, (char *)&partCfgFields.q[j], sizeof(double)); break;
 #endif
 #ifdef DIPOLES
-	case MX:   Tcl_Write(channel, (char *)&data.r.dip[0], sizeof(double)); break;
-	case MY:   Tcl_Write(channel, (char *)&data.r.dip[1], sizeof(double)); break;
-	case MZ:   Tcl_Write(channel, (char *)&data.r.dip[2], sizeof(double)); break;
+	case MX:   Tcl_Write(channel, (char *)&partCfgFields.dip[3*j], sizeof(double)); break;
+	case MY:   Tcl_Write(channel, (char *)&partCfgFields.dip[3*j+1], sizeof(double)); break;
+	case MZ:   Tcl_Write(channel, (char *)&partCfgFields.dip[3*j+2], sizeof(double)); break;
 #endif
-	case TYPE: Tcl_Write(channel, (char *)&data.p.type, sizeof(int)); break;
+	case TYPE: Tcl_Write(channel, (char *)&partCfgFields.type[j], sizeof(int)); break;
 	}
       }
-      free_particle(&data);
     }
   }
+  free(order);
   /* end marker */
   Tcl_Write(channel, (char *)&end_num, sizeof(int));
   free(row);
@@ -207,9 +226,9 @@ int readmd(ClientData dummy, Tcl_Interp *interp,
   #endif
   av_mass=0, av_f = 0, av_q = 0, av_type = 0;
   
-  int node, i;
+  int node, i, fields, n_chunk;
   struct MDHeader header;
-  Particle data;
+  Particle *chunk;
   int tcl_file_mode;
   Tcl_Channel channel;
 
@@ -282,35 +301,57 @@ int readmd(ClientData dummy, Tcl_Interp *interp,
   #endif
 
 
+  fields = 0;
+  if (av_pos)  fields |= PART_BULK_POS;
+  if (av_v)    fields |= PART_BULK_V;
+  if (av_f)    fields |= PART_BULK_F;
+  if (av_type) fields |= PART_BULK_TYPE;
+#ifdef MASS
+  if (av_mass) fields |= PART_BULK_MASS;
+#endif
+#ifdef ELECTROSTATICS
+  if (av_q)    fields |= PART_BULK_Q;
+#endif
+#ifdef DIPOLES
+  if (av_dip)  fields |= PART_BULK_DIP;
+#endif
+
+  /* the particles are sent to the nodes in chunks */
+  chunk = malloc(READMD_CHUNK*sizeof(Particle));
+  n_chunk = 0;
+
   while (!Tcl_Eof(channel)) {
-    Tcl_Read(channel, (char *)&data.p.identity, sizeof(int));
-    if (data.p.identity == -1)
+    Particle *data = &chunk[n_chunk];
+
+    Tcl_Read(channel, (char *)&data->p.identity, sizeof(int));
+    if (data->p.identity == -1)
       break;
 
-    /* printf("id=%d\n", data.identity); */
+    /* printf("id=%d\n", data->identity); */
 
-    if (data.p.identity < 0) {
+    if (data->p.identity < 0) {
       Tcl_AppendResult(interp, "illegal data format in data file \"", argv[1],
 		       "\", perhaps wrong file?",
 		       (char *) NULL);
+      free(chunk);
       free(row);
       return (TCL_ERROR);
     }
 
     for (i = 0; i < header.n_rows; i++) {
       switch (row[i]) {
-      case POSX: Tcl_Read(channel, (char *)&data.r.p[0], sizeof(double)); break;
-      case POSY: Tcl_Read(channel, (char *)&data.r.p[1], sizeof(double)); break;
-      case POSZ: Tcl_Read(channel, (char *)&data.r.p[2], sizeof(double)); break;
-      case   VX: Tcl_Read(channel, (char *)&data.m.v[0], sizeof(double)); break;
-      case   VY: Tcl_Read(channel, (char *)&data.m.v[1], sizeof(double)); break;
-      case   VZ: Tcl_Read(channel, (char *)&data.m.v[2], sizeof(double)); break;
-      case   FX: Tcl_Read(channel, (char *)&data.f.f[0], sizeof(double)); break;
-      case   FY: Tcl_Read(channel, (char *)&data.f.f[1], sizeof(double)); break;
-      case   FZ: Tcl_Read(channel, (char *)&data.f.f[2], sizeof(double)); break;
+      case POSX: Tcl_Read(channel, (char *)&data->r.p[0], sizeof(double)); break;
+      case POSY: Tcl_Read(channel, (char *)&data->r.p[1], sizeof(double)); break;
+      case POSZ: Tcl_Read(channel, (char *)&data->r.p[2], sizeof(double)); break;
+      case   VX: Tcl_Read(channel, (char *)&data->m.v[0], sizeof(double)); break;
+      case   VY: Tcl_Read(channel, (char *)&data->m.v[1], sizeof(double)); break;
+      case   VZ: Tcl_Read(channel, (char *)&data->m.v[2], sizeof(double)); break;
+      case   FX: Tcl_Read(channel, (char *)&data->f.f[0], sizeof(double)); break;
+      case   FY: Tcl_Read(channel, (char *)&data->f.f[1], sizeof(double)); break;
+      case   FZ: Tcl_Read(channel, (char *)&data->f.f[2], sizeof(double)); break;
       case MASSES:
 #ifdef MASS
-          Tcl_Read(channel, (char *)&data.p.mass, sizeof(double)); break;
+          Tcl_Read(channel, (char *)&data->p.mass, sizeof(double)); break;
 #else
           {
               double dummy_mass;
@@ -318,50 +359,39 @@ int readmd(ClientData dummy, Tcl_Interp *interp,
           }
 #endif
 #ifdef ELECTROSTATICS
-      case    Q: Tcl_Read(channel, (char *)&data.p.q, sizeof(double)); break;
+      case    Q: Tcl_Read(channel, (char *)&data->p.q, sizeof(double)); break;
 #endif
 #ifdef DIPOLES
-      case   MX: Tcl_Read(channel, (char *)&data.r.dip[0], sizeof(double)); break;
-      case   MY: Tcl_Read(channel, (char *)&data.r.dip[1], sizeof(double)); break;
-      case   MZ: Tcl_Read(channel, (char *)&data.r.dip[2], sizeof(double)); break;
+      case   MX: Tcl_Read(channel, (char *)&data->r.dip[0], sizeof(double)); break;
+      case   MY: Tcl_Read(channel, (char *)&data->r.dip[1], sizeof(double)); break;
+      case   MZ: Tcl_Read(channel, (char *)&data->r.dip[2], sizeof(double)); break;
 #endif
 
-      case TYPE: Tcl_Read(channel, (char *)&data.p.type, sizeof(int)); break;
+      case TYPE: Tcl_Read(channel, (char *)&data->p.type, sizeof(int)); break;
       }
     }
 
-    node = (data.p.identity <= max_seen_particle) ? particle_node[data.p.identity] : -1;
+    node = (data->p.identity <= max_seen_particle) ? particle_node[data->p.identity] : -1;
     if (node == -1) {
       if (!av_pos) {
 	Tcl_AppendResult(interp, "new particle without position data",
 			 (char *) NULL);
+	free(chunk);
 	free(row);
 	return (TCL_ERROR);
       }
     }
 
-    if (av_pos)
-      place_particle(data.p.identity, data.r.p);
-#ifdef MASS
-    if (av_mass)
-      set_particle_mass(data.p.identity, data.p.mass);
-#endif
-#ifdef ELECTROSTATICS
-    if (av_q)
-      set_particle_q(data.p.identity, data.p.q);
-#endif
-#ifdef DIPOLES
-    if (av_dip)
-      set_particle_dip(data.p.identity, data.r.dip);
-#endif
-    if (av_v)
-      set_particle_v(data.p.identity, data.m.v);
-    if (av_f)
-      set_particle_f(data.p.identity, data.f.f);
-    if (av_type)
-      set_particle_type(data.p.identity, data.p.type);
+    if (++n_chunk == READMD_CHUNK) {
+      place_particles(n_chunk, chunk, fields);
+      n_chunk = 0;
+    }
   }
 
+  if (n_chunk > 0)
+    place_particles(n_chunk, chunk, fields);
+
+  free(chunk);
   free(row);
   return TCL_OK;
 }
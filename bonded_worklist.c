@@ -0,0 +1,152 @@
+// This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+// It is therefore subject to the ESPResSo license agreement which you accepted upon receiving the distribution
+// and by which you are legally bound while utilizing this file in any form or way.
+// There is NO WARRANTY, not even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// You should have received a copy of that license along with this program;
+// if not, refer to http://www.espresso.mpg.de/license.html where its current version can be found, or
+// write to Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148, 55021 Mainz, Germany.
+// Copyright (c) 2002-2009; all rights reserved unless otherwise stated.
+/** \file bonded_worklist.c   Work list of the bonded interactions.
+ *  For more information see  \ref bonded_worklist.h "bonded_worklist.h"
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "utils.h"
+#include "bonded_worklist.h"
+#include "cells.h"
+#include "particle_data.h"
+#include "interaction_data.h"
+#include "communication.h"
+#include "forces.h"
+
+/*****************************************
+ * Variables
+ *****************************************/
+
+int rebuild_bonded_worklist = 1;
+
+/** One bonded interaction: the particle storing the bond, followed by
+    its partners. Unused partners are NULL. */
+typedef struct {
+  Particle *p[4];
+} BondedWork;
+
+/** The bonds of all local particles, sorted by bonded interaction type. */
+static BondedWork *bw_list = NULL;
+static int max_bw_list = 0;
+/** The bonds of type t are bw_list[bw_start[t]] ... bw_list[bw_end[t]-1]. */
+static int *bw_start = NULL;
+static int *bw_end = NULL;
+/** Number of bonded interaction types the work list was built for. */
+static int n_bw_types = 0;
+
+/*****************************************
+ * Functions
+ *****************************************/
+
+/** Collect the bonds of the local particles into \ref bw_list. The
+    bonds are counted per type first, so that they can be stored
+    sorted in a second pass. If a partner is not present on this node,
+    the bond is left out, and the list is rebuilt next time, so that
+    the error is reported in each time step as before. */
+static void build_bonded_worklist()
+{
+  Particle *p;
+  Cell *cell;
+  BondedWork *bw;
+  int c, np, n, i, k, t, n_partners, total;
+  char *errtxt;
+
+  n_bw_types = n_bonded_ia;
+  bw_start = (int *)realloc(bw_start, (n_bw_types + 1)*sizeof(int));
+  bw_end   = (int *)realloc(bw_end, (n_bw_types + 1)*sizeof(int));
+  for (t = 0; t <= n_bw_types; t++)
+    bw_end[t] = 0;
+
+  /* count the bonds of each type */
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for (n = 0; n < np; n++) {
+      i = 0;
+      while (i < p[n].bl.n) {
+	t = p[n].bl.e[i];
+	bw_end[t]++;
+	i += 1 + bonded_ia_params[t].num;
+      }
+    }
+  }
+
+  total = 0;
+  for (t = 0; t < n_bw_types; t++) {
+    bw_start[t] = total;
+    total += bw_end[t];
+    bw_end[t] = bw_start[t];
+  }
+  bw_start[n_bw_types] = total;
+
+  if (total > max_bw_list) {
+    max_bw_list = total;
+    bw_list = (BondedWork *)realloc(bw_list, max_bw_list*sizeof(BondedWork));
+  }
+
+  rebuild_bonded_worklist = 0;
+
+  /* store the bonds, resolving the partners */
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for (n = 0; n < np; n++) {
+      i = 0;
+      while (i < p[n].bl.n) {
+	t = p[n].bl.e[i++];
+	n_partners = bonded_ia_params[t].num;
+	bw = &bw_list[bw_end[t]];
+	bw->p[0] = &p[n];
+	bw->p[2] = bw->p[3] = NULL;
+	for (k = 1; k <= n_partners; k++)
+	  if (!(bw->p[k] = local_particles[p[n].bl.e[i + k - 1]]))
+	    break;
+	if (k <= n_partners) {
+	  switch (n_partners) {
+	  case 1:
+	    errtxt = runtime_error(128 + 2*TCL_INTEGER_SPACE);
+	    ERROR_SPRINTF(errtxt,"{078 bond broken between particles %d and %d (particles not stored on the same node)} ",
+			  p[n].p.identity, p[n].bl.e[i]);
+	    break;
+	  case 2:
+	    errtxt = runtime_error(128 + 3*TCL_INTEGER_SPACE);
+	    ERROR_SPRINTF(errtxt,"{079 bond broken between particles %d, %d and %d (particles not stored on the same node)} ",
+			  p[n].p.identity, p[n].bl.e[i], p[n].bl.e[i+1]);
+	    break;
+	  default:
+	    errtxt = runtime_error(128 + 4*TCL_INTEGER_SPACE);
+	    ERROR_SPRINTF(errtxt,"{080 bond broken between particles %d, %d, %d and %d (particles not stored on the same node)} ",
+			  p[n].p.identity, p[n].bl.e[i], p[n].bl.e[i+1], p[n].bl.e[i+2]);
+	  }
+	  rebuild_bonded_worklist = 1;
+	}
+	else
+	  bw_end[t]++;
+	i += n_partners;
+      }
+    }
+  }
+}
+
+void calc_bonded_worklist_forces()
+{
+  BondedWork *bw, *end;
+  int t;
+
+  if (rebuild_bonded_worklist || n_bw_types != n_bonded_ia)
+    build_bonded_worklist();
+
+  for (t = 0; t < n_bw_types; t++) {
+    end = &bw_list[bw_end[t]];
+    for (bw = &bw_list[bw_start[t]]; bw < end; bw++)
+      add_bond_force(bw->p[0], bw->p[1], bw->p[2], bw->p[3], t);
+  }
+}
@@ -0,0 +1,37 @@
+// This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+// It is therefore subject to the ESPResSo license agreement which you accepted upon receiving the distribution
+// and by which you are legally bound while utilizing this file in any form or way.
+// There is NO WARRANTY, not even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// You should have received a copy of that license along with this program;
+// if not, refer to http://www.espresso.mpg.de/license.html where its current version can be found, or
+// write to Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148, 55021 Mainz, Germany.
+// Copyright (c) 2002-2009; all rights reserved unless otherwise stated.
+#ifndef BONDED_WORKLIST_H
+#define BONDED_WORKLIST_H
+/** \file bonded_worklist.h
+ *
+ *  Work list of the bonded interactions of the local particles.
+ *
+ *  Instead of interpreting the bond list \ref Particle::bl of every
+ *  local particle in each time step, the bonds are collected once
+ *  after each resort into a list which stores the pointers to all
+ *  particles involved. The list is sorted by the bonded interaction
+ *  type, so that the force calculation loops over the bonds of one
+ *  type after the other. Since the pointers go into the cells, the
+ *  list is only valid until the next resort.
+ *
+ *  The energies and virials are still calculated from the bond lists.
+ *
+ *  For more information see \ref bonded_worklist.c "bonded_worklist.c".
+ */
+
+/** If non-zero, the bonded work list has to be rebuilt before the
+    next force calculation. Set whenever the particles are resorted or
+    changed, or the bonded interactions change. */
+extern int rebuild_bonded_worklist;
+
+/** Calculate the forces of the bonded interactions of all local
+    particles, rebuilding the work list if necessary. */
+void calc_bonded_worklist_forces();
+
+#endif
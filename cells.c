@@ -175,20 +175,32 @@ int cellsystem(ClientData data, Tcl_Interp *interp,
   }
 
   if (ARG1_IS_S("domain_decomposition")) {
-    if (argc > 2) {
-      if (ARG_IS_S(2,"-verlet_list"))
+    int i;
+    /** by default use verlet list */
+    dd.use_vList = 1;
+#ifdef VIRTUAL_SITES_COM
+    dd.migrate_molecules = 0;
+#endif
+    for (i = 2; i < argc; i++) {
+      if (ARG_IS_S(i,"-verlet_list"))
 	dd.use_vList = 1;
-      else if(ARG_IS_S(2,"-no_verlet_list")) 
+      else if(ARG_IS_S(i,"-no_verlet_list")) 
 	dd.use_vList = 0;
+#ifdef VIRTUAL_SITES_COM
+      else if(ARG_IS_S(i,"-migrate_molecules"))
+	dd.migrate_molecules = 1;
+#endif
       else{
 	Tcl_AppendResult(interp, "wrong flag to",argv[0],
+#ifdef VIRTUAL_SITES_COM
+			 " : should be \" -verlet_list, -no_verlet_list or -migrate_molecules \"",
+#else
 			 " : should be \" -verlet_list or -no_verlet_list \"",
+#endif
 			 (char *) NULL);
 	return (TCL_ERROR);
       }
     }
-    /** by default use verlet list */
-    else dd.use_vList = 1;
     mpi_bcast_cell_structure(CELL_STRUCTURE_DOMDEC);
   }
   else if (ARG1_IS_S("nsquare"))
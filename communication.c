@@ -35,6 +35,7 @@
 #include "p3m.h"
 #include "ewald.h"
 #include "statistics.h"
+#include "mpiio.h"
 #include "energy.h"
 #include "pressure.h"
 #include "random.h"
@@ -191,10 +192,20 @@ typedef void (SlaveCallback)(int node, int param);
 #define REQ_SET_RINERTIA  54
 /** Action for sending virtual sites-relative properties */
 #define REQ_SET_VS_RELATIVE 55
+/** Action number for \ref mpi_lb_checkpoint. */
+#define REQ_LB_CHECKPOINT 56
+/** Action number for \ref mpi_place_particles. */
+#define REQ_PLACE_BULK 57
+/** Action number for \ref mpi_gather_observable. */
+#define REQ_GET_OBSERVABLE 58
+/** Action number for \ref mpi_get_particle_fields. */
+#define REQ_GETPARTFIELDS 59
+/** Action number for \ref mpi_mpiio. */
+#define REQ_MPIIO 60
 
 
 /** Total number of action numbers. */
-#define REQ_MAXIMUM 56
+#define REQ_MAXIMUM 61
 
 /*@}*/
 
@@ -259,6 +270,11 @@ void mpi_send_isVirtual_slave(int node, int parm);
 void mpi_bcast_tf_params_slave(int node, int parm);
 void mpi_send_rotational_inertia_slave(int node, int parm);
 void mpi_send_vs_relative_slave(int pnode, int part);
+void mpi_lb_checkpoint_slave(int node, int parm);
+void mpi_place_particles_slave(int node, int parm);
+void mpi_gather_observable_slave(int node, int parm);
+void mpi_get_particle_fields_slave(int node, int parm);
+void mpi_mpiio_slave(int node, int parm);
 /*@}*/
 
 /** A list of which function has to be called for
@@ -320,6 +336,11 @@ static SlaveCallback *slave_callbacks[] = {
   mpi_iccp3m_init_slave,            /* 53: REQ_ICCP3M_INIT */
   mpi_send_rotational_inertia_slave,/* 54: REQ_SET_RINERTIA */
   mpi_send_vs_relative_slave,/* 55: REQ_SET_RINERTIA */
+  mpi_lb_checkpoint_slave,          /* 56: REQ_LB_CHECKPOINT */
+  mpi_place_particles_slave,        /* 57: REQ_PLACE_BULK */
+  mpi_gather_observable_slave,      /* 58: REQ_GET_OBSERVABLE */
+  mpi_get_particle_fields_slave,    /* 59: REQ_GETPARTFIELDS */
+  mpi_mpiio_slave,                  /* 60: REQ_MPIIO */
 };
 
 /** Names to be printed when communication debugging is on. */
@@ -389,6 +410,13 @@ char *names[] = {
   "REQ_ICCP3M_ITERATION", /* 52 */
   "REQ_ICCP3M_INIT",      /* 53 */
   "SET_RINERTIA",   /* 54 */
+
+  "SET_VS_RELATIVE", /* 55 */
+  "LB_CHECKPOINT",  /* 56 */
+  "PLACE_BULK",     /* 57 */
+  "GET_OBSERVABLE", /* 58 */
+  "GETPARTFIELDS",  /* 59 */
+  "MPIIO",          /* 60 */
 };
 
 /** the requests are compiled here. So after a crash you get the last issued request */
@@ -654,6 +682,114 @@ void mpi_place_particle_slave(int pnode, int part)
   on_particle_change();
 }
 
+/****************** REQ_PLACE_BULK ************/
+
+void mpi_place_particles(int n, Particle *parts, int *pnodes,
+			 int n_new, int *new_ids, int fields)
+{
+  int i, node, n_local, *count, *start, *fill;
+  Particle *sorted;
+  IntList bonds;
+
+  mpi_issue(REQ_PLACE_BULK, -1, fields);
+
+  MPI_Bcast(&n_new, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (n_new > 0)
+    MPI_Bcast(new_ids, n_new, MPI_INT, 0, MPI_COMM_WORLD);
+  for (i = 0; i < n_new; i++)
+    added_particle(new_ids[i]);
+
+  /* sort the particles by their nodes, keeping the order on each node */
+  count = malloc(3*n_nodes*sizeof(int));
+  start = count + n_nodes;
+  fill  = start + n_nodes;
+  for (node = 0; node < n_nodes; node++)
+    count[node] = 0;
+  for (i = 0; i < n; i++)
+    count[pnodes[i]]++;
+  start[0] = 0;
+  for (node = 1; node < n_nodes; node++)
+    start[node] = start[node - 1] + count[node - 1];
+  memcpy(fill, start, n_nodes*sizeof(int));
+
+  sorted = malloc(n*sizeof(Particle));
+  for (i = 0; i < n; i++)
+    memcpy(&sorted[fill[pnodes[i]]++], &parts[i], sizeof(Particle));
+
+  MPI_Scatter(count, 1, MPI_INT, &n_local, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  init_intlist(&bonds);
+  for (node = n_nodes - 1; node >= 0; node--) {
+    if (count[node] == 0)
+      continue;
+    if (fields & PART_BULK_BONDS) {
+      bonds.n = 0;
+      for (i = start[node]; i < start[node] + count[node]; i++) {
+	realloc_intlist(&bonds, bonds.n + sorted[i].bl.n);
+	memcpy(bonds.e + bonds.n, sorted[i].bl.e, sorted[i].bl.n*sizeof(int));
+	bonds.n += sorted[i].bl.n;
+      }
+    }
+    if (node == this_node)
+      local_place_particles(count[node], &sorted[start[node]], bonds.e, fields);
+    else {
+      MPI_Send(&sorted[start[node]], count[node]*sizeof(Particle), MPI_BYTE,
+	       node, REQ_PLACE_BULK, MPI_COMM_WORLD);
+      if (bonds.n > 0)
+	MPI_Send(bonds.e, bonds.n, MPI_INT, node, REQ_PLACE_BULK, MPI_COMM_WORLD);
+    }
+  }
+  realloc_intlist(&bonds, 0);
+
+  free(sorted);
+  free(count);
+
+  on_particle_change();
+}
+
+void mpi_place_particles_slave(int node, int fields)
+{
+  int i, n_new, *new_ids, n;
+  Particle *parts;
+  IntList bonds;
+  MPI_Status status;
+
+  MPI_Bcast(&n_new, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (n_new > 0) {
+    new_ids = malloc(n_new*sizeof(int));
+    MPI_Bcast(new_ids, n_new, MPI_INT, 0, MPI_COMM_WORLD);
+    for (i = 0; i < n_new; i++)
+      added_particle(new_ids[i]);
+    free(new_ids);
+  }
+
+  MPI_Scatter(NULL, 1, MPI_INT, &n, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  if (n > 0) {
+    parts = malloc(n*sizeof(Particle));
+    MPI_Recv(parts, n*sizeof(Particle), MPI_BYTE, 0, REQ_PLACE_BULK,
+	     MPI_COMM_WORLD, &status);
+
+    init_intlist(&bonds);
+    if (fields & PART_BULK_BONDS) {
+      for (i = 0; i < n; i++)
+	bonds.n += parts[i].bl.n;
+      if (bonds.n > 0) {
+	alloc_intlist(&bonds, bonds.n);
+	MPI_Recv(bonds.e, bonds.n, MPI_INT, 0, REQ_PLACE_BULK,
+		 MPI_COMM_WORLD, &status);
+      }
+    }
+
+    local_place_particles(n, parts, bonds.e, fields);
+
+    realloc_intlist(&bonds, 0);
+    free(parts);
+  }
+
+  on_particle_change();
+}
+
 /****************** REQ_SET_V ************/
 void mpi_send_v(int pnode, int part, double v[3])
 {
@@ -1273,20 +1409,20 @@ void mpi_remove_particle_slave(int pnode, int part)
 }
 
 /********************* REQ_INTEGRATE ********/
-int mpi_integrate(int n_steps)
+int mpi_integrate(int n_steps, int observables)
 {
-  mpi_issue(REQ_INTEGRATE, -1, n_steps);
+  mpi_issue(REQ_INTEGRATE, observables, n_steps);
 
-  integrate_vv(n_steps);
+  integrate_vv(n_steps, observables);
 
   COMM_TRACE(fprintf(stderr, "%d: integration task %d done.\n", this_node, n_steps));
 
   return check_runtime_errors();
 }
 
-void mpi_integrate_slave(int pnode, int task)
+void mpi_integrate_slave(int observables, int task)
 {
-  integrate_vv(task);
+  integrate_vv(task, observables);
   COMM_TRACE(fprintf(stderr, "%d: integration task %d done.\n", this_node, task));
 
   check_runtime_errors();
@@ -1319,6 +1455,9 @@ void mpi_bcast_ia_params(int i, int j)
       /* Communicate the data */
       MPI_Bcast(tabulated_forces.e,tablesize, MPI_DOUBLE, 0 , MPI_COMM_WORLD);
       MPI_Bcast(tabulated_energies.e,tablesize, MPI_DOUBLE, 0 , MPI_COMM_WORLD);
+
+      if (get_ia_param(i,j)->TAB_spline)
+	tabulated_calc_splines(get_ia_param(i,j));
     }    
 #endif
 #ifdef INTERFACE_CORRECTION
@@ -1380,6 +1519,9 @@ void mpi_bcast_ia_params_slave(int i, int j)
 	/* Now communicate the data */
 	MPI_Bcast(tabulated_forces.e,tablesize, MPI_DOUBLE, 0 , MPI_COMM_WORLD);
 	MPI_Bcast(tabulated_energies.e,tablesize, MPI_DOUBLE, 0 , MPI_COMM_WORLD);
+
+	if (get_ia_param(i,j)->TAB_spline)
+	  tabulated_calc_splines(get_ia_param(i,j));
       }
     }
 #endif
@@ -1580,6 +1722,59 @@ void mpi_gather_stats_slave(int ana_num, int job)
   }
 }
 
+/*************** REQ_GET_OBSERVABLE ************/
+void mpi_gather_observable(int job, int n_ipar, int *ipar, int n_dpar, double *dpar,
+			   int n_result, double *result)
+{
+  int i, sizes[3];
+  double *local;
+
+  mpi_issue(REQ_GET_OBSERVABLE, -1, job);
+
+  sizes[0] = n_ipar;
+  sizes[1] = n_dpar;
+  sizes[2] = n_result;
+  MPI_Bcast(sizes, 3, MPI_INT, 0, MPI_COMM_WORLD);
+  if (n_ipar > 0)
+    MPI_Bcast(ipar, n_ipar, MPI_INT, 0, MPI_COMM_WORLD);
+  if (n_dpar > 0)
+    MPI_Bcast(dpar, n_dpar, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+  local = malloc(n_result*sizeof(double));
+  for (i = 0; i < n_result; i++)
+    local[i] = 0;
+  local_observable(job, ipar, dpar, local);
+
+  MPI_Reduce(local, result, n_result, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  free(local);
+}
+
+void mpi_gather_observable_slave(int node, int job)
+{
+  int i, sizes[3];
+  int *ipar;
+  double *dpar, *local;
+
+  MPI_Bcast(sizes, 3, MPI_INT, 0, MPI_COMM_WORLD);
+  ipar = malloc(sizes[0]*sizeof(int));
+  if (sizes[0] > 0)
+    MPI_Bcast(ipar, sizes[0], MPI_INT, 0, MPI_COMM_WORLD);
+  dpar = malloc(sizes[1]*sizeof(double));
+  if (sizes[1] > 0)
+    MPI_Bcast(dpar, sizes[1], MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+  local = malloc(sizes[2]*sizeof(double));
+  for (i = 0; i < sizes[2]; i++)
+    local[i] = 0;
+  local_observable(job, ipar, dpar, local);
+
+  MPI_Reduce(local, NULL, sizes[2], MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+  free(local);
+  free(dpar);
+  free(ipar);
+}
+
 /*************** REQ_GET_LOCAL_STRESS_TENSOR ************/
 void mpi_local_stress_tensor(DoubleList *TensorInBin, int bins[3], int periodic[3], double range_start[3], double range[3]) {
   
@@ -1654,6 +1849,183 @@ void mpi_local_stress_tensor_slave(int ana_num, int job) {
   free(TensorInBin);
 }
 
+/*************** REQ_GETPARTFIELDS ************/
+
+/** gather one floating point field. If single is set, the values are
+    transferred in single precision and converted back on the master. */
+static void gather_particle_doubles(double *local, int n, double *result,
+				    int *sizes, int *displs, int single)
+{
+  int i, tot_size = 0;
+  float *lf, *rf = NULL;
+
+  if (!single) {
+    MPI_Gatherv(local, n, MPI_DOUBLE, result, sizes, displs, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    return;
+  }
+
+  lf = malloc(n*sizeof(float));
+  for (i = 0; i < n; i++)
+    lf[i] = local[i];
+  if (this_node == 0) {
+    tot_size = displs[n_nodes-1] + sizes[n_nodes-1];
+    rf = malloc(tot_size*sizeof(float));
+  }
+  MPI_Gatherv(lf, n, MPI_FLOAT, rf, sizes, displs, MPI_FLOAT, 0, MPI_COMM_WORLD);
+  for (i = 0; i < tot_size; i++)
+    result[i] = rf[i];
+  free(rf);
+  free(lf);
+}
+
+/** common part of \ref mpi_get_particle_fields and its slave. result
+    is only used on the master node. */
+static void gather_particle_fields(int fields, PartCfgFields *result)
+{
+  PartCfgFields local;
+  int *sizes = NULL, *displs = NULL, *vsizes = NULL, *vdispls = NULL;
+  int n_part, tot_size, i, single = fields & PCFG_FLOAT;
+
+  n_part = cells_get_n_particles();
+
+  /* first collect number of particles on each node */
+  if (this_node == 0) {
+    sizes   = malloc(n_nodes*sizeof(int));
+    displs  = malloc(n_nodes*sizeof(int));
+    vsizes  = malloc(n_nodes*sizeof(int));
+    vdispls = malloc(n_nodes*sizeof(int));
+  }
+  MPI_Gather(&n_part, 1, MPI_INT, sizes, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  if (this_node == 0) {
+    tot_size = 0;
+    for (i = 0; i < n_nodes; i++) {
+      displs[i]  = tot_size;
+      vsizes[i]  = 3*sizes[i];
+      vdispls[i] = 3*tot_size;
+      tot_size  += sizes[i];
+    }
+    if (tot_size!=n_total_particles) {
+      fprintf(stderr,"%d: ERROR: mpi_get_particle_fields: n_total_particles %d, but I counted %d. Exiting...\n",
+	      this_node, n_total_particles, tot_size);
+      errexit();
+    }
+    alloc_particle_fields(result, fields, tot_size);
+  }
+
+  local_get_particle_fields(fields, &local);
+
+  /* and collect them field by field */
+  MPI_Gatherv(local.identity, n_part, MPI_INT, result ? result->identity : NULL,
+	      sizes, displs, MPI_INT, 0, MPI_COMM_WORLD);
+  if (fields & PCFG_TYPE)
+    MPI_Gatherv(local.type, n_part, MPI_INT, result ? result->type : NULL,
+		sizes, displs, MPI_INT, 0, MPI_COMM_WORLD);
+  if (fields & PCFG_MOL_ID)
+    MPI_Gatherv(local.mol_id, n_part, MPI_INT, result ? result->mol_id : NULL,
+		sizes, displs, MPI_INT, 0, MPI_COMM_WORLD);
+  if (fields & PCFG_POS)
+    gather_particle_doubles(local.pos, 3*n_part, result ? result->pos : NULL,
+			    vsizes, vdispls, single);
+  if (fields & PCFG_V)
+    gather_particle_doubles(local.v, 3*n_part, result ? result->v : NULL,
+			    vsizes, vdispls, single);
+  if (fields & PCFG_F)
+    gather_particle_doubles(local.f, 3*n_part, result ? result->f : NULL,
+			    vsizes, vdispls, single);
+  if (fields & PCFG_Q)
+    gather_particle_doubles(local.q, n_part, result ? result->q : NULL,
+			    sizes, displs, single);
+  if (fields & PCFG_MASS)
+    gather_particle_doubles(local.mass, n_part, result ? result->mass : NULL,
+			    sizes, displs, single);
+  if (fields & PCFG_DIP)
+    gather_particle_doubles(local.dip, 3*n_part, result ? result->dip : NULL,
+			    vsizes, vdispls, single);
+  if (fields & PCFG_VIRTUAL)
+    MPI_Gatherv(local.isVirtual, n_part, MPI_INT, result ? result->isVirtual : NULL,
+		sizes, displs, MPI_INT, 0, MPI_COMM_WORLD);
+
+  free_particle_fields(&local);
+  free(vdispls);
+  free(vsizes);
+  free(displs);
+  free(sizes);
+}
+
+void mpi_get_particle_fields(int fields, PartCfgFields *result)
+{
+  mpi_issue(REQ_GETPARTFIELDS, -1, fields);
+  gather_particle_fields(fields, result);
+}
+
+void mpi_get_particle_fields_slave(int node, int fields)
+{
+  gather_particle_fields(fields, NULL);
+}
+
+/*************** REQ_MPIIO ************/
+int mpi_mpiio(int job, char *filename, int fields)
+{
+  int len, pending, ret = 1;
+
+  mpi_issue(REQ_MPIIO, -1, job);
+
+  switch (job) {
+  case MPIIO_OPEN:
+    MPI_Bcast(&fields, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    len = strlen(filename) + 1;
+    MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(filename, len, MPI_CHAR, 0, MPI_COMM_WORLD);
+    ret = mpiio_open(filename, fields);
+    break;
+  case MPIIO_WRITE:
+    mpiio_write_frame();
+    break;
+  case MPIIO_CLOSE:
+    mpiio_close();
+    break;
+  case MPIIO_PENDING:
+    pending = mpiio_pending();
+    MPI_Reduce(&pending, &ret, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+    break;
+  case MPIIO_WAIT:
+    mpiio_wait();
+    break;
+  }
+  return ret;
+}
+
+void mpi_mpiio_slave(int node, int job)
+{
+  int len, fields, pending;
+  char *filename;
+
+  switch (job) {
+  case MPIIO_OPEN:
+    MPI_Bcast(&fields, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    filename = malloc(len);
+    MPI_Bcast(filename, len, MPI_CHAR, 0, MPI_COMM_WORLD);
+    mpiio_open(filename, fields);
+    free(filename);
+    break;
+  case MPIIO_WRITE:
+    mpiio_write_frame();
+    break;
+  case MPIIO_CLOSE:
+    mpiio_close();
+    break;
+  case MPIIO_PENDING:
+    pending = mpiio_pending();
+    MPI_Reduce(&pending, NULL, 1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+    break;
+  case MPIIO_WAIT:
+    mpiio_wait();
+    break;
+  }
+}
+
 /*************** REQ_GETPARTS ************/
 void mpi_get_particles(Particle *result, IntList *bi)
 {
@@ -1958,9 +2330,9 @@ void mpi_send_ext(int pnode, int part, int flag, int mask, double force[3])
   if (pnode == this_node) {
     Particle *p = local_particles[part];
     /* mask out old flags */
-    p->l.ext_flag &= ~mask;
+    p->p.ext_flag &= ~mask;
     /* set new values */
-    p->l.ext_flag |= flag;
+    p->p.ext_flag |= flag;
     if (mask & PARTICLE_EXT_FORCE)
       memcpy(p->l.ext_force, force, 3*sizeof(double));
   }
@@ -1984,9 +2356,9 @@ void mpi_send_ext_slave(int pnode, int part)
     MPI_Status status;
     MPI_Recv(s_buf, 2, MPI_INT, 0, REQ_SET_EXT, MPI_COMM_WORLD, &status);
     /* mask out old flags */
-    p->l.ext_flag &= ~s_buf[1];
+    p->p.ext_flag &= ~s_buf[1];
     /* set new values */
-    p->l.ext_flag |= s_buf[0];
+    p->p.ext_flag |= s_buf[0];
     
     if (s_buf[1] & PARTICLE_EXT_FORCE)
       MPI_Recv(p->l.ext_force, 3, MPI_DOUBLE, 0, REQ_SET_EXT, MPI_COMM_WORLD, &status);
@@ -2592,6 +2964,40 @@ void mpi_recv_fluid_slave(int node, int index) {
 #endif
 }
 
+/************** REQ_LB_CHECKPOINT **************/
+void mpi_lb_checkpoint(char *filename, int load) {
+#ifdef LB
+  int len = strlen(filename) + 1;
+
+  mpi_issue(REQ_LB_CHECKPOINT, -1, load);
+  MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(filename, len, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+  if (load)
+    lb_load_checkpoint(filename);
+  else
+    lb_save_checkpoint(filename);
+#endif
+}
+
+void mpi_lb_checkpoint_slave(int node, int load) {
+#ifdef LB
+  int len;
+  char *filename;
+
+  MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  filename = malloc(len);
+  MPI_Bcast(filename, len, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+  if (load)
+    lb_load_checkpoint(filename);
+  else
+    lb_save_checkpoint(filename);
+
+  free(filename);
+#endif
+}
+
 /********************* REQ_ICCP3M_ITERATION ********/
 int mpi_iccp3m_iteration(int dummy)
 {
@@ -121,6 +121,19 @@ void mpi_bcast_event(int event);
 */
 void mpi_place_particle(int node, int id, int new, double pos[3]);
 
+/** Issue REQ_PLACE_BULK: create or modify many particles in one go.
+    The particles are sent to their nodes in a single pass, and
+    \ref on_particle_change is called only once.
+    \param n       number of particles.
+    \param parts   the particle data, see \ref place_particles.
+    \param nodes   for each particle the node to attach it to.
+    \param n_new   number of particles that do not exist yet.
+    \param new_ids the identities of the new particles.
+    \param fields  which fields to set, see \ref PART_BULK_POS etc.
+*/
+void mpi_place_particles(int n, Particle *parts, int *nodes,
+			 int n_new, int *new_ids, int fields);
+
 /** Issue REQ_SET_V: send particle velocity.
     Also calls \ref on_particle_change.
     \param part the particle.
@@ -270,9 +283,11 @@ void mpi_recv_part(int node, int part, Particle *part_data);
 
 /** Issue REQ_INTEGRATE: start integrator.
     @param n_steps how many steps to do.
+    @param observables which observables to calculate along with the
+    last step, see \ref integrate_vv.
     @return nonzero on error
 */
-int mpi_integrate(int n_steps);
+int mpi_integrate(int n_steps, int observables);
 
 /** Issue REQ_BCAST_IA: send new ia params.
     Also calls \ref on_short_range_ia_change.
@@ -338,6 +353,21 @@ void mpi_bcast_n_particle_types(int s);
 */
 void mpi_gather_stats(int job, void *result, void *result_t, void *result_nb, void *result_t_nb);
 
+/** Issue REQ_GET_OBSERVABLE: calculate an observable that is a sum over
+    the particles without gathering them. Every node adds up the
+    contribution of its local particles by \ref local_observable, and the
+    results are summed up on the master node.
+    \param job      the observable, see \ref OBS_CENTERMASS etc.
+    \param n_ipar   number of integer parameters
+    \param ipar     the integer parameters
+    \param n_dpar   number of double parameters
+    \param dpar     the double parameters
+    \param n_result number of values of the observable
+    \param result   where to store the summed up values
+*/
+void mpi_gather_observable(int job, int n_ipar, int *ipar, int n_dpar, double *dpar,
+			   int n_result, double *result);
+
 /** Issue GET_LOCAL_STRESS_TENSOR: gather the contribution to the local stress tensors from
     each node.
  */
@@ -356,6 +386,28 @@ void mpi_local_stress_tensor(DoubleList *TensorInBin, int bins[3], int periodic[
 */
 void mpi_get_particles(Particle *result, IntList *il);
 
+/** Issue REQ_GETPARTFIELDS: gather selected properties of all
+    particles into compact arrays. In contrast to \ref
+    mpi_get_particles, only the requested fields are transferred, each
+    by a single collective operation. Use \ref updatePartCfgFields
+    instead of calling this directly.
+    \param fields or'ed \ref PCFG_POS etc.
+    \param result where to store the data, allocated by this function
+*/
+void mpi_get_particle_fields(int fields, PartCfgFields *result);
+
+/** Issue REQ_MPIIO: open, write to or close the parallel trajectory
+    file on all nodes, see \ref mpiio.h "mpiio.h".
+    \param job      \ref MPIIO_OPEN, \ref MPIIO_WRITE, \ref MPIIO_CLOSE,
+                    \ref MPIIO_PENDING or \ref MPIIO_WAIT
+    \param filename the file to open (\ref MPIIO_OPEN only)
+    \param fields   or'ed \ref PCFG_POS etc. (\ref MPIIO_OPEN only)
+    \return for \ref MPIIO_PENDING the maximal number of frames still
+    being written on any node, for \ref MPIIO_OPEN 0 if the file could
+    not be opened, otherwise 1
+*/
+int mpi_mpiio(int job, char *filename, int fields);
+
 /** Issue REQ_SET_TIME_STEP: send new \ref time_step and rescale the
     velocities accordingly. 
 */
@@ -440,6 +492,12 @@ void mpi_send_fluid(int node, int index, double rho, double *j, double *pi);
  */
 void mpi_recv_fluid(int node, int index, double *rho, double *j, double *pi);
 
+/** Issue REQ_LB_CHECKPOINT: Write or read a checkpoint of the Lattice Boltzmann fluid.
+ * @param filename name of the checkpoint file
+ * @param load     0 to write the checkpoint, 1 to read it
+ */
+void mpi_lb_checkpoint(char *filename, int load);
+
 /** Issue REQ_ICCP3M_ITERATION: performs iccp3m iteration.
     @return nonzero on error
 */
@@ -245,6 +245,12 @@ int compilation_callback(Tcl_Interp *interp)
 #ifdef VIRTUAL_SITES
   Tcl_AppendResult(interp, "{ VIRTUAL_SITES } ", (char *) NULL);
 #endif
+#ifdef VIRTUAL_SITES_COM
+  Tcl_AppendResult(interp, "{ VIRTUAL_SITES_COM } ", (char *) NULL);
+#endif
+#ifdef VIRTUAL_SITES_RELATIVE
+  Tcl_AppendResult(interp, "{ VIRTUAL_SITES_RELATIVE } ", (char *) NULL);
+#endif
 #ifdef METADYNAMICS
   Tcl_AppendResult(interp, "{ METADYNAMICS } ", (char *) NULL);
 #endif
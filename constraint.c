@@ -18,11 +18,128 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>. 
 */
 /** \file constraint.c
-    Implementation of \ref constraint.h "constraint.h", here it's just the parsing stuff.
+    Implementation of \ref constraint.h "constraint.h", here it's the
+    parsing stuff and the constraint buckets.
 */
 #include "constraint.h"
 
 #ifdef CONSTRAINTS
+int rebuild_constraint_buckets = 1;
+int con_bucket_grid[3] = { 1, 1, 1 };
+double con_bucket_inv_size[3] = { 0, 0, 0 };
+int *con_bucket_start = NULL;
+int *con_bucket_list = NULL;
+
+/** Determine the bounding box of the region in which a constraint can
+    interact with or is violated by a particle.
+    @return 0 if the region is unbounded */
+static int constraint_bounding_box(Constraint *con, double cut, double lo[3], double hi[3])
+{
+  int d;
+  double ext;
+
+  switch (con->type) {
+  case CONSTRAINT_SPH:
+    if (con->c.sph.direction == -1)
+      return 0;
+    for (d = 0; d < 3; d++) {
+      lo[d] = con->c.sph.pos[d] - con->c.sph.rad - cut;
+      hi[d] = con->c.sph.pos[d] + con->c.sph.rad + cut;
+    }
+    return 1;
+  case CONSTRAINT_CYL:
+    if (con->c.cyl.direction == -1)
+      return 0;
+    /* extension of the cylinder along d, the axis is normalized */
+    for (d = 0; d < 3; d++) {
+      ext = con->c.cyl.length*fabs(con->c.cyl.axis[d])
+	+ con->c.cyl.rad*sqrt(dmax(0, 1 - SQR(con->c.cyl.axis[d])));
+      lo[d] = con->c.cyl.pos[d] - ext - cut;
+      hi[d] = con->c.cyl.pos[d] + ext + cut;
+    }
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/** Range of buckets in direction d overlapped by the interval [lo, hi]. */
+static void constraint_bucket_range(int d, double lo, double hi, int *first, int *last)
+{
+  *first = (int)floor(lo*con_bucket_inv_size[d]);
+  *last  = (int)floor(hi*con_bucket_inv_size[d]);
+  if (*first < 0) *first = 0;
+  if (*last >= con_bucket_grid[d]) *last = con_bucket_grid[d] - 1;
+  if (*first >= con_bucket_grid[d]) *first = con_bucket_grid[d] - 1;
+  if (*last < 0) *last = 0;
+}
+
+void build_constraint_buckets()
+{
+  int n, d, b, pass, n_buckets, bounded = 0;
+  int first[3], last[3], i[3];
+  double cut = dmax(max_cut_non_bonded, 0), lo[3], hi[3], size;
+
+  for (n = 0; n < n_constraints; n++)
+    if (constraint_bounding_box(&constraints[n], cut, lo, hi))
+      bounded = 1;
+
+  /* without constraints of finite range, a single bucket is sufficient.
+     Otherwise the buckets are about as large as the cutoff. */
+  for (d = 0; d < 3; d++) {
+    con_bucket_grid[d] = 1;
+    if (bounded) {
+      size = dmax(cut, box_l[d]/CONSTRAINT_MAX_BUCKETS);
+      con_bucket_grid[d] = (int)(box_l[d]/size);
+      if (con_bucket_grid[d] < 1) con_bucket_grid[d] = 1;
+      if (con_bucket_grid[d] > CONSTRAINT_MAX_BUCKETS) con_bucket_grid[d] = CONSTRAINT_MAX_BUCKETS;
+    }
+    con_bucket_inv_size[d] = con_bucket_grid[d]/box_l[d];
+  }
+  n_buckets = con_bucket_grid[0]*con_bucket_grid[1]*con_bucket_grid[2];
+  con_bucket_start = (int *)realloc(con_bucket_start, (n_buckets + 1)*sizeof(int));
+
+  /* first count the constraints per bucket, then store them. Since the
+     constraints are looped in order, the bucket lists are sorted. */
+  for (pass = 0; pass < 2; pass++) {
+    if (pass == 0)
+      for (b = 0; b <= n_buckets; b++)
+	con_bucket_start[b] = 0;
+    for (n = 0; n < n_constraints; n++) {
+      if (constraint_bounding_box(&constraints[n], cut, lo, hi))
+	for (d = 0; d < 3; d++)
+	  constraint_bucket_range(d, lo[d], hi[d], &first[d], &last[d]);
+      else
+	for (d = 0; d < 3; d++) {
+	  first[d] = 0;
+	  last[d] = con_bucket_grid[d] - 1;
+	}
+      for (i[2] = first[2]; i[2] <= last[2]; i[2]++)
+	for (i[1] = first[1]; i[1] <= last[1]; i[1]++)
+	  for (i[0] = first[0]; i[0] <= last[0]; i[0]++) {
+	    b = (i[2]*con_bucket_grid[1] + i[1])*con_bucket_grid[0] + i[0];
+	    if (pass == 0)
+	      con_bucket_start[b + 1]++;
+	    else
+	      con_bucket_list[con_bucket_start[b]++] = n;
+	  }
+    }
+    if (pass == 0) {
+      for (b = 0; b < n_buckets; b++)
+	con_bucket_start[b + 1] += con_bucket_start[b];
+      con_bucket_list = (int *)realloc(con_bucket_list, (con_bucket_start[n_buckets] + 1)*sizeof(int));
+    }
+    else {
+      /* the start indices have been advanced to the ends */
+      for (b = n_buckets; b > 0; b--)
+	con_bucket_start[b] = con_bucket_start[b - 1];
+      con_bucket_start[0] = 0;
+    }
+  }
+
+  rebuild_constraint_buckets = 0;
+}
+
 int printConstraintToResult(Tcl_Interp *interp, int i)
 {
   Constraint *con = &constraints[i];
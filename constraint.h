@@ -30,10 +30,66 @@
  *  Routines for handling of constraints.
  *  Only active if the feature CONSTRAINTS is activated.
  *  see also \ref interaction_data.h
+ *
+ *  To avoid testing every particle against every constraint, the box
+ *  is divided into a grid of buckets. Each bucket lists the
+ *  constraints a particle inside it can interact with, see \ref
+ *  get_constraint_bucket.
  */
 
 #ifdef CONSTRAINTS
 
+/** \name Constraint buckets */
+/*@{*/
+
+/** maximal number of constraint buckets per direction */
+#define CONSTRAINT_MAX_BUCKETS 32
+
+/** If non-zero, the constraint buckets have to be rebuilt before the
+    next use. Set whenever the constraints, the box or the short ranged
+    interactions change. */
+extern int rebuild_constraint_buckets;
+/** number of constraint buckets in each direction */
+extern int con_bucket_grid[3];
+/** inverse size of a constraint bucket in each direction */
+extern double con_bucket_inv_size[3];
+/** The constraints of bucket b are con_bucket_list[con_bucket_start[b]]
+    ... con_bucket_list[con_bucket_start[b+1]-1], in increasing order. */
+extern int *con_bucket_start;
+extern int *con_bucket_list;
+
+/** Sort the constraints into the buckets. Spheres and cylinders which
+    repel the particles to the outside only interact with particles
+    within their bounding box, enlarged by \ref max_cut_non_bonded, and
+    are only listed in the buckets overlapping it. All other constraints
+    are listed in every bucket. */
+void build_constraint_buckets();
+
+/** Get the constraints which a particle at a given folded position can
+    interact with. Positions outside the box, which occur for
+    non-periodic directions, belong to the boundary buckets.
+    @param pos the folded position
+    @param n   returns the number of constraints
+    @return the indices of the constraints
+*/
+MDINLINE int *get_constraint_bucket(double pos[3], int *n)
+{
+  int i, d, b = 0;
+
+  if (rebuild_constraint_buckets)
+    build_constraint_buckets();
+
+  for (d = 2; d >= 0; d--) {
+    i = (int)floor(pos[d]*con_bucket_inv_size[d]);
+    if (i < 0) i = 0;
+    else if (i >= con_bucket_grid[d]) i = con_bucket_grid[d] - 1;
+    b = b*con_bucket_grid[d] + i;
+  }
+  *n = con_bucket_start[b + 1] - con_bucket_start[b];
+  return con_bucket_list + con_bucket_start[b];
+}
+/*@}*/
+
 // for the charged rod "constraint"
 #define C_GAMMA   0.57721566490153286060651209008
 
@@ -379,7 +435,7 @@ MDINLINE double ext_magn_field_energy(Particle *p1, Constraint_ext_magn_field *c
 
 MDINLINE void add_constraints_forces(Particle *p1)
 {
-  int n, j;
+  int n, j, k, n_near, *near;
   double dist, vec[3], force[3], torque1[3], torque2[3];
 
   IA_parameters *ia_params;
@@ -392,7 +448,9 @@ MDINLINE void add_constraints_forces(Particle *p1)
   memcpy(img, p1->l.i, 3*sizeof(int));
   fold_position(folded_pos, img);
 
-  for(n=0;n<n_constraints;n++) {
+  near = get_constraint_bucket(folded_pos, &n_near);
+  for(k=0;k<n_near;k++) {
+    n = near[k];
     ia_params=get_ia_param(p1->p.type, (&constraints[n].part_rep)->p.type);
     dist=0.;
     for (j = 0; j < 3; j++) {
@@ -524,7 +582,7 @@ MDINLINE void add_constraints_forces(Particle *p1)
 
 MDINLINE double add_constraints_energy(Particle *p1)
 {
-  int n, type;
+  int n, k, n_near, *near, type;
   double dist, vec[3];
   double nonbonded_en, coulomb_en;
   IA_parameters *ia_params;
@@ -537,7 +595,9 @@ MDINLINE double add_constraints_energy(Particle *p1)
   memcpy(img, p1->l.i, 3*sizeof(int));
   fold_position(folded_pos, img);
 
-  for(n=0;n<n_constraints;n++) { 
+  near = get_constraint_bucket(folded_pos, &n_near);
+  for(k=0;k<n_near;k++) {
+    n = near[k];
     ia_params = get_ia_param(p1->p.type, (&constraints[n].part_rep)->p.type);
     nonbonded_en = 0;
     coulomb_en   = 0;
@@ -32,6 +32,7 @@
 #include "cells.h"
 #include "grid.h"
 #include "integrate.h"
+#include "domain_decomposition.h"
 
 #if defined FORCE_CORE || defined MPI_CORE
 int regular_exit = 0;
@@ -191,6 +192,11 @@ void check_particle_consistency()
 	errexit();
       }
       for(dir=0;dir<3;dir++) {
+#ifdef VIRTUAL_SITES_COM
+	/* particles of molecules are stored next to their center of mass site */
+	if(cell_structure.type == CELL_STRUCTURE_DOMDEC && dd.migrate_molecules && part[n].p.mol_id >= 0)
+	  continue;
+#endif
 	if(PERIODIC(dir) && (part[n].r.p[dir] < -ROUND_ERROR_PREC || part[n].r.p[dir] - box_l[dir] > ROUND_ERROR_PREC)) {
 	  fprintf(stderr,"%d: check_particle_consistency: ERROR: illegal pos[%d]=%f of part %d id=%d in cell %d\n",
 		  this_node,dir,part[n].r.p[dir],n,part[n].p.identity,c);
@@ -29,6 +29,8 @@
 #include "pressure.h"
 #include "energy.h"
 #include "constraint.h"
+#include "topology.h"
+#include "virtual_sites.h"
 
 /************************************************/
 /** \name Defines */
@@ -509,6 +511,194 @@ Cell *dd_position_to_cell(double pos[3])
 
 /*************************************************/
 
+#ifdef VIRTUAL_SITES_COM
+/** Positions of the center of mass sites of the molecules as far as known
+    on this node, for \ref DomainDecomposition::migrate_molecules. The
+    position of molecule m is valid if dd_mol_com_known[m] is non-zero. */
+static double *dd_mol_com = NULL;
+static int *dd_mol_com_known = NULL;
+static int dd_n_mol_com = 0, dd_max_mol_com = 0;
+
+/** Collect the positions of the center of mass sites among the local
+    particles. If global is set, the positions are exchanged between all
+    nodes, then this has to be called on all nodes at the same time. */
+static void dd_collect_mol_com(int global)
+{
+  int c, p, m;
+  Cell *cell;
+  Particle *part;
+
+  dd_n_mol_com = n_molecules > 0 ? n_molecules : 0;
+  if (dd_n_mol_com > dd_max_mol_com) {
+    dd_max_mol_com = dd_n_mol_com;
+    dd_mol_com = realloc(dd_mol_com, 3*dd_max_mol_com*sizeof(double));
+    dd_mol_com_known = realloc(dd_mol_com_known, dd_max_mol_com*sizeof(int));
+  }
+  for (m = 0; m < 3*dd_n_mol_com; m++) dd_mol_com[m] = 0;
+  for (m = 0; m < dd_n_mol_com; m++) dd_mol_com_known[m] = 0;
+
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    for (p = 0; p < cell->n; p++) {
+      part = &cell->part[p];
+      m = part->p.mol_id;
+      if (ifParticleIsVirtual(part) && m >= 0 && m < dd_n_mol_com) {
+	memcpy(&dd_mol_com[3*m], part->r.p, 3*sizeof(double));
+	dd_mol_com_known[m] = 1;
+      }
+    }
+  }
+
+  if (global && dd_n_mol_com > 0) {
+    double *com = malloc(3*dd_n_mol_com*sizeof(double));
+    int *known  = malloc(dd_n_mol_com*sizeof(int));
+    MPI_Allreduce(dd_mol_com, com, 3*dd_n_mol_com, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(dd_mol_com_known, known, dd_n_mol_com, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    memcpy(dd_mol_com, com, 3*dd_n_mol_com*sizeof(double));
+    memcpy(dd_mol_com_known, known, dd_n_mol_com*sizeof(int));
+    free(com);
+    free(known);
+  }
+}
+
+/** Fold the known center of mass positions in direction dir in the same
+    way as the center of mass sites themselves. */
+static void dd_fold_mol_com(int dir)
+{
+  int m, image_box[3] = {0, 0, 0};
+
+  for (m = 0; m < dd_n_mol_com; m++)
+    if (dd_mol_com_known[m])
+      fold_coordinate(&dd_mol_com[3*m], image_box, dir);
+}
+
+/** The position deciding on node and cell of a particle. This is the
+    position of the center of mass site of its molecule, if known, or
+    the position of the particle itself. */
+MDINLINE double *dd_migration_position(Particle *part)
+{
+  int m = part->p.mol_id;
+  if (dd.migrate_molecules && m >= 0 && m < dd_n_mol_com && dd_mol_com_known[m])
+    return &dd_mol_com[3*m];
+  return part->r.p;
+}
+
+/** Move a particle to the periodic image closest to the center of mass
+    site of its molecule, in all directions in which the domain is split
+    between nodes. */
+static void dd_unfold_to_mol_com(Particle *part, double com[3])
+{
+  int i;
+
+  for (i = 0; i < 3; i++) {
+    if (node_grid[i] == 1
+#ifdef PARTIAL_PERIODIC
+	|| !PERIODIC(i)
+#endif
+	)
+      continue;
+    while (part->r.p[i] - com[i] > 0.5*box_l[i]) {
+      part->r.p[i] -= box_l[i];
+      part->l.i[i]++;
+    }
+    while (part->r.p[i] - com[i] < -0.5*box_l[i]) {
+      part->r.p[i] += box_l[i];
+      part->l.i[i]--;
+    }
+  }
+}
+
+/** Returns the cell closest to the position in the nodes spatial
+    domain. */
+static Cell *dd_clamped_position_to_cell(double pos[3])
+{
+  int i, cpos[3];
+
+  for (i = 0; i < 3; i++) {
+    cpos[i] = (int)((pos[i] - my_left[i])*dd.inv_cell_size[i]) + 1;
+    if (cpos[i] < 1)
+      cpos[i] = 1;
+    else if (cpos[i] > dd.cell_grid[i])
+      cpos[i] = dd.cell_grid[i];
+  }
+  return &cells[get_linear_index(cpos[0], cpos[1], cpos[2], dd.ghost_cell_grid)];
+}
+
+/** Returns the cell of a particle of a molecule, or NULL if the center
+    of mass site of the molecule is not in the nodes spatial domain. The
+    particle itself may stick out of the domain, as long as all its
+    interaction partners still are in the neighbor cells. */
+static Cell *dd_mol_particle_to_cell(Particle *part, double com[3])
+{
+  int i;
+  double out;
+
+  if (dd_save_position_to_cell(com) == NULL)
+    return NULL;
+
+  dd_unfold_to_mol_com(part, com);
+  for (i = 0; i < 3; i++) {
+    out = my_left[i] - part->r.p[i];
+    if (part->r.p[i] - my_right[i] > out)
+      out = part->r.p[i] - my_right[i];
+    if (out > dd.cell_size[i] - max_range + ROUND_ERROR_PREC) {
+      char *errtext = runtime_error(128 + 2*TCL_INTEGER_SPACE + TCL_DOUBLE_SPACE);
+      ERROR_SPRINTF(errtext, "{119 particle %d of molecule %d sticks out of the node domain by %g, more than the cell size minus the interaction range} ",
+		    part->p.identity, part->p.mol_id, out);
+      break;
+    }
+  }
+  return dd_clamped_position_to_cell(part->r.p);
+}
+#endif
+
+/** Returns the cell a local particle has to be sorted into, or NULL if it
+    does not belong to this node. */
+MDINLINE Cell *dd_particle_to_cell(Particle *part)
+{
+#ifdef VIRTUAL_SITES_COM
+  double *pos = dd_migration_position(part);
+  if (pos != part->r.p)
+    return dd_mol_particle_to_cell(part, pos);
+#endif
+  return dd_save_position_to_cell(part->r.p);
+}
+
+#ifdef VIRTUAL_SITES_COM
+/** Version of \ref dd_append_particles for \ref
+    DomainDecomposition::migrate_molecules. The received center of mass
+    sites are registered first, since the particles of their molecules
+    come along. */
+static int dd_append_molecules(ParticleList *pl, int fold_dir)
+{
+  int p, m, flag=0;
+  Particle *part;
+  Cell *cell;
+
+  for(p=0; p<pl->n; p++) {
+    part = &pl->part[p];
+    if(boundary[fold_dir] != 0)
+      fold_coordinate(part->r.p, part->l.i, fold_dir/2);
+    m = part->p.mol_id;
+    if (ifParticleIsVirtual(part) && m >= 0 && m < dd_n_mol_com) {
+      memcpy(&dd_mol_com[3*m], part->r.p, 3*sizeof(double));
+      dd_mol_com_known[m] = 1;
+    }
+  }
+
+  for(p=0; p<pl->n; p++) {
+    part = &pl->part[p];
+    cell = dd_particle_to_cell(part);
+    if (cell == NULL) {
+      flag = 1;
+      cell = dd_clamped_position_to_cell(dd_migration_position(part));
+    }
+    append_indexed_particle(cell, part);
+  }
+  return flag;
+}
+#endif
+
 /** Append the particles in pl to \ref local_cells and update \ref local_particles.  
     @return 0 if all particles in pl reside in the nodes domain otherwise 1.*/
 int dd_append_particles(ParticleList *pl, int fold_dir)
@@ -517,6 +707,11 @@ int dd_append_particles(ParticleList *pl, int fold_dir)
 
   CELL_TRACE(fprintf(stderr, "%d: dd_append_particles %d\n", this_node, pl->n));
 
+#ifdef VIRTUAL_SITES_COM
+  if (dd.migrate_molecules)
+    return dd_append_molecules(pl, fold_dir);
+#endif
+
   for(p=0; p<pl->n; p++) {
     if(boundary[fold_dir] != 0)
       fold_coordinate(pl->part[p].r.p, pl->part[p].l.i, fold_coord);
@@ -646,6 +841,9 @@ void dd_topology_init(CellPList *old)
 
   /** broadcast the flag for using verlet list */
   MPI_Bcast(&dd.use_vList, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#ifdef VIRTUAL_SITES_COM
+  MPI_Bcast(&dd.migrate_molecules, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
  
   cell_structure.type             = CELL_STRUCTURE_DOMDEC;
   cell_structure.position_to_node = map_position_node_array;
@@ -729,6 +927,7 @@ void  dd_exchange_and_sort_particles(int global_flag)
   int dir, c, p, i, finished=0;
   ParticleList *cell,*sort_cell, send_buf_l, send_buf_r, recv_buf_l, recv_buf_r;
   Particle *part;
+  double *pos;
   CELL_TRACE(fprintf(stderr,"%d: dd_exchange_and_sort_particles(%d):\n",this_node,global_flag));
 
   init_particlelist(&send_buf_l);
@@ -739,6 +938,10 @@ void  dd_exchange_and_sort_particles(int global_flag)
     finished=1;
     /* direction loop: x, y, z */  
     for(dir=0; dir<3; dir++) { 
+#ifdef VIRTUAL_SITES_COM
+      if (dd.migrate_molecules)
+	dd_collect_mol_com(global_flag == CELL_GLOBAL_EXCHANGE);
+#endif
       if(node_grid[dir] > 1) {
 	/* Communicate particles that have left the node domain */
 	/* particle loop */
@@ -746,8 +949,13 @@ void  dd_exchange_and_sort_particles(int global_flag)
 	  cell = local_cells.cell[c];
 	  for (p = 0; p < cell->n; p++) {
 	    part = &cell->part[p];
+#ifdef VIRTUAL_SITES_COM
+	    pos = dd_migration_position(part);
+#else
+	    pos = part->r.p;
+#endif
 	    /* Move particles to the left side */
-	    if(part->r.p[dir] - my_left[dir] < -ROUND_ERROR_PREC) {
+	    if(pos[dir] - my_left[dir] < -ROUND_ERROR_PREC) {
 #ifdef PARTIAL_PERIODIC 
 	      if( PERIODIC(dir) || (boundary[2*dir]==0) ) 
 #endif
@@ -759,7 +967,7 @@ void  dd_exchange_and_sort_particles(int global_flag)
 		}
 	    }
 	    /* Move particles to the right side */
-	    else if(part->r.p[dir] - my_right[dir] >= ROUND_ERROR_PREC) {
+	    else if(pos[dir] - my_right[dir] >= ROUND_ERROR_PREC) {
 #ifdef PARTIAL_PERIODIC 
 	      if( PERIODIC(dir) || (boundary[2*dir+1]==0) ) 
 #endif
@@ -772,7 +980,7 @@ void  dd_exchange_and_sort_particles(int global_flag)
 	    }
 	    /* Sort particles in cells of this node during last direction */
 	    else if(dir==2) {
-	      sort_cell = dd_save_position_to_cell(part->r.p);
+	      sort_cell = dd_particle_to_cell(part);
 	      if(sort_cell != cell) {
 		if(sort_cell==NULL) {
 		  CELL_TRACE(fprintf(stderr,"%d: dd_exchange_and_sort_particles: Take another loop",this_node));
@@ -818,6 +1026,10 @@ void  dd_exchange_and_sort_particles(int global_flag)
       }
       else {
 	/* Single node direction case (no communication) */
+#ifdef VIRTUAL_SITES_COM
+	if (dd.migrate_molecules)
+	  dd_fold_mol_com(dir);
+#endif
 	/* Fold particles that have left the box */
 	/* particle loop */
 	for(c=0; c<local_cells.n; c++) {
@@ -831,7 +1043,7 @@ void  dd_exchange_and_sort_particles(int global_flag)
 		fold_coordinate(part->r.p, part->l.i, dir);
 	      }
 	    if (dir==2) {
-	      sort_cell = dd_save_position_to_cell(part->r.p);
+	      sort_cell = dd_particle_to_cell(part);
 	      if(sort_cell != cell) {
 		if(sort_cell==NULL) {
 		  CELL_TRACE(fprintf(stderr, "%d: dd_exchange_and_sort_particles: CP2 Particle %d (%f,%f,%f) not inside node domain.\n",
@@ -965,9 +1177,8 @@ void calc_link_cell()
       /* Loop cell particles */
       for(i=0; i < np1; i++) {
 	j_start = 0;
-	/* Tasks within cell: bonded forces */
+	/* Tasks within cell: constraints */
 	if(n == 0) {
-	  add_bonded_force(&p1[i]);
 #ifdef CONSTRAINTS
 	  add_constraints_forces(&p1[i]);
 #endif
@@ -975,16 +1186,16 @@ void calc_link_cell()
 	}
 	/* Loop neighbor cell particles */
 	for(j = j_start; j < np2; j++) {
+	  dist2 = distance2vec(p1[i].r.p, p2[j].r.p, vec21);
+	  /* exclusions are only checked for pairs in range */
+	  if(dist2 <= max_range_non_bonded2
 #ifdef EXCLUSIONS
-          if(do_nonbonded(&p1[i], &p2[j]))
+	     && do_nonbonded(&p1[i], &p2[j])
 #endif
-	    {
-	      dist2 = distance2vec(p1[i].r.p, p2[j].r.p, vec21);
-	      if(dist2 <= max_range_non_bonded2) {
-		/* calc non bonded interactions */
-		add_non_bonded_pair_force(&(p1[i]), &(p2[j]), vec21, sqrt(dist2), dist2);
-	      }
-	    }
+	     ) {
+	    /* calc non bonded interactions */
+	    add_non_bonded_pair_force(&(p1[i]), &(p2[j]), vec21, sqrt(dist2), dist2);
+	  }
 	}
       }
     }
@@ -113,6 +113,11 @@ typedef struct {
   double inv_cell_size[3];
   /** Array containing information about the interactions between the cells. */
   IA_Neighbor_List *cell_inter;
+#ifdef VIRTUAL_SITES_COM
+  /** flag for migrating the particles of a molecule together with its
+      center of mass site, see \ref dd_exchange_and_sort_particles. */
+  int migrate_molecules;
+#endif
 }  DomainDecomposition;
 
 /************************************************************/
@@ -185,6 +190,14 @@ void dd_topology_release();
     DD_NEIGHBOR_EXCHANGE for neighbor exchange (recommended for use within
     Molecular dynamics, or any other integration scheme using only local
     particle moves) 
+
+    With \ref DomainDecomposition::migrate_molecules, the node of a
+    particle of a molecule is decided by the center of mass site of the
+    molecule, so that all particles of the molecule reside on the node of
+    its center of mass site. They are stored at the periodic image closest
+    to the center of mass site, in the boundary cells if they stick out of
+    the node domain. This is only allowed by the cell size minus the
+    interaction range.
 */
 void dd_exchange_and_sort_particles(int global_flag);
 
@@ -43,6 +43,48 @@ extern double dpd_tr_cut;
 /** trans DPD thermostat weight function */
 extern int dpd_twf;
 
+#if defined(DPD) || defined(INTER_DPD)
+/** uniform noise in (-0.5,0.5) for the pair p1, p2. With the counter
+    based generator, it only depends on the pair, not on the order of
+    the particles. */
+MDINLINE double dpd_pair_noise(Particle *p1, Particle *p2)
+{
+  double r[4];
+  if (!counter_rng_seed)
+    return d_random() - 0.5;
+  if (p1->p.identity < p2->p.identity)
+    c_random4(p1->p.identity, p2->p.identity, COUNTER_RNG_DPD, r);
+  else
+    c_random4(p2->p.identity, p1->p.identity, COUNTER_RNG_DPD, r);
+  return r[0] - 0.5;
+}
+
+/** uniform noise vector with components in (-0.5,0.5) for the pair
+    p1, p2. With the counter based generator, it changes sign if p1
+    and p2 are exchanged, so that the transversal random forces do not
+    depend on the order of the particles. */
+MDINLINE void dpd_pair_noise_vec(Particle *p1, Particle *p2, double noise_vec[3])
+{
+  double r[4];
+  int i;
+  if (!counter_rng_seed) {
+    for (i = 0; i < 3; i++)
+      noise_vec[i] = d_random() - 0.5;
+    return;
+  }
+  if (p1->p.identity < p2->p.identity) {
+    c_random4(p1->p.identity, p2->p.identity, COUNTER_RNG_TRANS_DPD, r);
+    for (i = 0; i < 3; i++)
+      noise_vec[i] = r[i] - 0.5;
+  }
+  else {
+    c_random4(p2->p.identity, p1->p.identity, COUNTER_RNG_TRANS_DPD, r);
+    for (i = 0; i < 3; i++)
+      noise_vec[i] = 0.5 - r[i];
+  }
+}
+#endif
+
 #ifdef DPD
 extern double dpd_r_cut_inv;
 extern double dpd_pref1;
@@ -95,7 +137,7 @@ MDINLINE void add_dpd_thermo_pair_force(Particle *p1, Particle *p2, double d[3],
   // if any of the two particles is fixed in some direction then
   // do not add any dissipative or stochastic dpd force part
   // because dissipation-fluctuation theorem is violated
-  if ( (p1->l.ext_flag | p2->l.ext_flag) & COORDS_FIX_MASK) return;
+  if ( (p1->p.ext_flag | p2->p.ext_flag) & COORDS_FIX_MASK) return;
 #endif
 
 #ifdef VIRTUAL_SITES
@@ -131,7 +173,7 @@ MDINLINE void add_dpd_thermo_pair_force(Particle *p1, Particle *p2, double d[3],
     for(j=0; j<3; j++)  vel12_dot_d12 += (p1->m.v[j] - p2->m.v[j]) * d[j];
     friction = dpd_pref1 * omega2 * vel12_dot_d12;
     // random force prefactor
-    noise    = dpd_pref2 * omega      * (d_random()-0.5);
+    noise    = dpd_pref2 * omega      * dpd_pair_noise(p1, p2);
     for(j=0; j<3; j++) {
        p1->f.f[j] += ( tmp = (noise - friction)*d[j] );
        p2->f.f[j] -= tmp;
@@ -152,9 +194,9 @@ MDINLINE void add_dpd_thermo_pair_force(Particle *p1, Particle *p2, double d[3],
       omega*=sqrt(massf);
 #endif
       omega2   = SQR(omega);
+      //noise vector
+      dpd_pair_noise_vec(p1, p2, noise_vec);
       for (i=0;i<3;i++){
-        //noise vector
-        noise_vec[i]=d_random()-0.5;
         // Projection Matrix
         for (j=0;j<3;j++){
           P_times_dist_sqr[i][j]-=d[i]*d[j];
@@ -224,7 +266,7 @@ MDINLINE void add_interdpd_pair_force(Particle *p1, Particle *p2, IA_parameters
   // if any of the two particles is fixed in some direction then
   // do not add any dissipative or stochastic dpd force part
   // because dissipation-fluctuation theorem is violated
-  if ( (p1->l.ext_flag | p2->l.ext_flag) & COORDS_FIX_MASK) return;
+  if ( (p1->p.ext_flag | p2->p.ext_flag) & COORDS_FIX_MASK) return;
 #endif
 
 #ifdef DPD_MASS_RED
@@ -257,7 +299,7 @@ MDINLINE void add_interdpd_pair_force(Particle *p1, Particle *p2, IA_parameters
     for(j=0; j<3; j++)  vel12_dot_d12 += (p1->m.v[j] - p2->m.v[j]) * d[j];
     friction = ia_params->dpd_pref1 * omega2 * vel12_dot_d12;
     // random force prefactor
-    noise    = ia_params->dpd_pref2 * omega      * (d_random()-0.5);
+    noise    = ia_params->dpd_pref2 * omega      * dpd_pair_noise(p1, p2);
     for(j=0; j<3; j++) {
        p1->f.f[j] += ( tmp = (noise - friction)*d[j] );
        p2->f.f[j] -= tmp;
@@ -277,9 +319,9 @@ MDINLINE void add_interdpd_pair_force(Particle *p1, Particle *p2, IA_parameters
       omega*=sqrt(massf);
 #endif
       omega2   = SQR(omega);
+      //noise vector
+      dpd_pair_noise_vec(p1, p2, noise_vec);
       for (i=0;i<3;i++){
-        //noise vector
-        noise_vec[i]=d_random()-0.5;
         // Projection Matrix
         for (j=0;j<3;j++){
           P_times_dist_sqr[i][j]-=d[i]*d[j];
@@ -20,6 +20,7 @@
 #include "elc.h"
 #include "magnetic_non_p3m__methods.h"
 #include "mdlc_correction.h"
+#include "constraint.h"
 
 Observable_stat energy = {0, {NULL,0,0}, 0,0,0};
 Observable_stat total_energy = {0, {NULL,0,0}, 0,0,0};
@@ -37,6 +38,10 @@ void init_energies(Observable_stat *stat);
 /** on the master node: calc energies only if necessary */
 void master_energy_calc();
 
+/** rescale the kinetic energy, add the long range energies and
+    gather the energies of all nodes */
+static void finish_energies(double *result);
+
 /************************************************************/
 
 void energy_calc(double *result)
@@ -64,6 +69,12 @@ void energy_calc(double *result)
   case CELL_STRUCTURE_NSQUARE:
     nsq_calculate_energies();
   }
+
+  finish_energies(result);
+}
+
+static void finish_energies(double *result)
+{
   /* rescale kinetic energy */
   energy.data.e[0] /= (2.0*time_step*time_step);
 
@@ -75,6 +86,45 @@ void energy_calc(double *result)
 
 /************************************************************/
 
+void fused_energy_init()
+{
+  init_energies(&energy);
+}
+
+void add_fused_pair_energy(Particle *p1, Particle *p2, double d[3], double dist, double dist2)
+{
+  add_non_bonded_pair_energy(p1, p2, d, dist, dist2);
+}
+
+void fused_energy_finish()
+{
+  Cell *cell;
+  Particle *p;
+  int c, i, np;
+
+  /* the pair energies are known from the force calculation */
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for (i = 0; i < np; i++) {
+      add_kinetic_energy(&p[i]);
+      add_bonded_energy(&p[i]);
+#ifdef CONSTRAINTS
+      add_constraints_energy(&p[i]);
+#endif
+    }
+  }
+
+  if (this_node == 0)
+    init_energies(&total_energy);
+  finish_energies(total_energy.data.e);
+  if (this_node == 0)
+    total_energy.init_status = 1;
+}
+
+/************************************************************/
+
 void calc_long_range_energies()
 {
 #ifdef ELECTROSTATICS  
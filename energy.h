@@ -64,6 +64,15 @@ extern Observable_stat energy, total_energy;
     @param result non-zero only on master node; will contain the cumulative over all nodes. */
 void energy_calc(double *result);
 
+/** Prepare the energy calculation along with the next force
+    calculation, see \ref fused_observables. */
+void fused_energy_init();
+
+/** Complete the energy calculation started by \ref fused_energy_init
+    after the force calculation and the velocity update. The result is
+    stored in \ref total_energy on the master node. */
+void fused_energy_finish();
+
 /** Calculate non bonded energies between a pair of particles.
     @param p1        pointer to particle 1.
     @param p2        pointer to particle 2.
@@ -78,6 +87,7 @@ MDINLINE double calc_non_bonded_pair_energy(Particle *p1, Particle *p2,
 					    double d[3], double dist, double dist2)
 {
   double ret = 0;
+  int pots = ia_params->pair_pots;
 
 #ifdef NO_INTRA_NB
   if (p1->p.mol_id==p2->p.mol_id) return 0;
@@ -88,73 +98,90 @@ MDINLINE double calc_non_bonded_pair_energy(Particle *p1, Particle *p2,
   if (checkIfParticlesInteractViaMolCut(p1,p2,ia_params)==0) return 0;
 #endif
 
+  if (!pots)
+    return 0;
+
 #ifdef LENNARD_JONES
   /* lennard jones */
-  ret += lj_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_LJ)
+    ret += lj_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef LENNARD_JONES_GENERIC
   /* Generic lennard jones */
-  ret += ljgen_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_LJGEN)
+    ret += ljgen_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef LJ_ANGLE
   /* Directional LJ */
-  ret += ljangle_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_LJANGLE)
+    ret += ljangle_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef SMOOTH_STEP
   /* smooth step */
-  ret += SmSt_pair_energy(p1,p2,ia_params,d,dist,dist2);
+  if (pots & PAIR_POT_SMST)
+    ret += SmSt_pair_energy(p1,p2,ia_params,d,dist,dist2);
 #endif
 
 #ifdef HERTZIAN
   /* Hertzian potential */
-  ret += hertzian_pair_energy(p1,p2,ia_params,d,dist,dist2);
+  if (pots & PAIR_POT_HERTZIAN)
+    ret += hertzian_pair_energy(p1,p2,ia_params,d,dist,dist2);
 #endif
 
 #ifdef BMHTF_NACL
   /* BMHTF NaCl */
-  ret += BMHTF_pair_energy(p1,p2,ia_params,d,dist,dist2);
+  if (pots & PAIR_POT_BMHTF)
+    ret += BMHTF_pair_energy(p1,p2,ia_params,d,dist,dist2);
 #endif
 
 #ifdef MORSE
   /* morse */
-  ret +=morse_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_MORSE)
+    ret += morse_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef BUCKINGHAM
   /* lennard jones */
-  ret  += buck_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_BUCK)
+    ret += buck_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef SOFT_SPHERE
   /* soft-sphere */
-  ret  += soft_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_SOFT)
+    ret += soft_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef LJCOS2
   /* lennard jones */
-  ret += ljcos2_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_LJCOS2)
+    ret += ljcos2_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef TABULATED
   /* tabulated */
-  ret += tabulated_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_TAB)
+    ret += tabulated_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef LJCOS
   /* lennard jones cosine */
-  ret += ljcos_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_LJCOS)
+    ret += ljcos_pair_energy(p1,p2,ia_params,d,dist);
 #endif
   
 #ifdef GAY_BERNE
   /* Gay-Berne */
-  ret += gb_pair_energy(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_GB)
+    ret += gb_pair_energy(p1,p2,ia_params,d,dist);
 #endif
 
 #ifdef INTER_RF
-  ret += interrf_pair_energy(p1,p2,ia_params,dist);
+  if (pots & PAIR_POT_INTER_RF)
+    ret += interrf_pair_energy(p1,p2,ia_params,dist);
 #endif
 
   return ret;
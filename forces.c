@@ -21,6 +21,7 @@
 #include "communication.h"
 #include "ghosts.h" 
 #include "verlet.h"
+#include "bonded_worklist.h"
 #include "grid.h"
 #include "cells.h"
 #include "particle_data.h"
@@ -38,6 +39,10 @@
 #include "virtual_sites.h"
 #include "constraint.h"
 
+/************************************************************/
+
+int fused_observables = 0;
+
 /************************************************************/
 /* local prototypes                                         */
 /************************************************************/
@@ -53,6 +58,9 @@ void init_forces();
 
 void force_calc()
 {
+  /* new random numbers for the counter based generator */
+  counter_rng_step++;
+
   init_forces();
   
   switch (cell_structure.type) {
@@ -73,6 +81,8 @@ void force_calc()
     nsq_calculate_ia();
     
   }
+
+  calc_bonded_worklist_forces();
   
   calc_long_range_forces();
 
@@ -250,7 +260,8 @@ MDINLINE void init_local_particle_force(Particle *part)
     part->p.adress_weight=new_weight;
   }
 #endif
-  if ( thermo_switch & THERMO_LANGEVIN )
+  /* with the BAOAB splitting, the thermostat acts in the propagation */
+  if ( (thermo_switch & THERMO_LANGEVIN) && !(thermo_switch & THERMO_BAOAB) )
     friction_thermo_langevin(part);
   else {
     part->f.f[0] = 0;
@@ -259,7 +270,7 @@ MDINLINE void init_local_particle_force(Particle *part)
   }
 
 #ifdef EXTERNAL_FORCES   
-  if(part->l.ext_flag & PARTICLE_EXT_FORCE) {
+  if(part->p.ext_flag & PARTICLE_EXT_FORCE) {
     part->f.f[0] += part->l.ext_force[0];
     part->f.f[1] += part->l.ext_force[1];
     part->f.f[2] += part->l.ext_force[2];
@@ -72,7 +72,8 @@
  *  <ol>
  *  <li> Initialize forces with: \ref friction_thermo_langevin (ghost forces with zero).
  *  <li> Calculate \ref tcl_bonded "bonded interaction" forces:<br>
- *       Loop all local particles (not the ghosts). 
+ *       Loop the bonds of all local particles (not the ghosts), using
+ *       the work list of \ref bonded_worklist.h "bonded_worklist.h".
  *       <ul>
  *       <li> FENE
  *       <li> ANGLE (cos bend potential)
@@ -95,71 +96,113 @@ void force_calc();
 */
 void init_forces_ghosts();
 
+/** \name Observables calculated along with the forces
+    Flags for \ref fused_observables.
+*/
+/*@{*/
+#define FUSED_OBS_ENERGY   1
+#define FUSED_OBS_PRESSURE 2
+/*@}*/
+
+/** The observables which are calculated in the pair loops of the
+    force calculation, a combination of the FUSED_OBS_* flags. Only
+    set during the last force calculation of an integration, see \ref
+    integrate_vv. */
+extern int fused_observables;
+
+/** Add the non-bonded energy of a pair to \ref energy.
+    Implemented in \ref energy.c "energy.c". */
+void add_fused_pair_energy(Particle *p1, Particle *p2, double d[3], double dist, double dist2);
+
+/** Add the non-bonded virials of a pair to \ref virials and \ref p_tensor.
+    Implemented in \ref pressure.c "pressure.c". */
+void add_fused_pair_virials(Particle *p1, Particle *p2, double d[3], double dist, double dist2);
+
 MDINLINE void calc_non_bonded_pair_force_parts(Particle *p1, Particle *p2, IA_parameters *ia_params,double d[3],
 					 double dist, double dist2, double force[3],double torgue1[3],double torgue2[3])
 {
+  int pots = ia_params->pair_pots;
+
 #ifdef NO_INTRA_NB
   if (p1->p.mol_id==p2->p.mol_id) return;
 #endif
+  if (!pots)
+    return;
+
   /* lennard jones */
 #ifdef LENNARD_JONES
-  add_lj_pair_force(p1,p2,ia_params,d,dist, force);
+  if (pots & PAIR_POT_LJ)
+    add_lj_pair_force(p1,p2,ia_params,d,dist, force);
 #endif
   /* lennard jones generic */
 #ifdef LENNARD_JONES_GENERIC
-  add_ljgen_pair_force(p1,p2,ia_params,d,dist, force);
+  if (pots & PAIR_POT_LJGEN)
+    add_ljgen_pair_force(p1,p2,ia_params,d,dist, force);
 #endif
   /* Directional LJ */
 #ifdef LJ_ANGLE
   /* The forces are propagated within the function */
-  add_ljangle_pair_force(p1,p2,ia_params,d,dist);
+  if (pots & PAIR_POT_LJANGLE)
+    add_ljangle_pair_force(p1,p2,ia_params,d,dist);
 #endif
   /* smooth step */
 #ifdef SMOOTH_STEP
-  add_SmSt_pair_force(p1,p2,ia_params,d,dist,dist2, force);
+  if (pots & PAIR_POT_SMST)
+    add_SmSt_pair_force(p1,p2,ia_params,d,dist,dist2, force);
 #endif
   /* Hertzian force */
 #ifdef HERTZIAN
-  add_hertzian_pair_force(p1,p2,ia_params,d,dist,dist2, force);
+  if (pots & PAIR_POT_HERTZIAN)
+    add_hertzian_pair_force(p1,p2,ia_params,d,dist,dist2, force);
 #endif
   /* BMHTF NaCl */
 #ifdef BMHTF_NACL
-  add_BMHTF_pair_force(p1,p2,ia_params,d,dist,dist2, force);
+  if (pots & PAIR_POT_BMHTF)
+    add_BMHTF_pair_force(p1,p2,ia_params,d,dist,dist2, force);
 #endif
   /* buckingham*/
 #ifdef BUCKINGHAM
-  add_buck_pair_force(p1,p2,ia_params,d,dist,force);
+  if (pots & PAIR_POT_BUCK)
+    add_buck_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* morse*/
 #ifdef MORSE
-  add_morse_pair_force(p1,p2,ia_params,d,dist,force);
+  if (pots & PAIR_POT_MORSE)
+    add_morse_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
  /*soft-sphere potential*/
 #ifdef SOFT_SPHERE
-  add_soft_pair_force(p1,p2,ia_params,d,dist,force);
+  if (pots & PAIR_POT_SOFT)
+    add_soft_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* lennard jones cosine */
 #ifdef LJCOS
-  add_ljcos_pair_force(p1,p2,ia_params,d,dist,force);
+  if (pots & PAIR_POT_LJCOS)
+    add_ljcos_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* lennard jones cosine */
 #ifdef LJCOS2
-  add_ljcos2_pair_force(p1,p2,ia_params,d,dist,force);
+  if (pots & PAIR_POT_LJCOS2)
+    add_ljcos2_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* tabulated */
 #ifdef TABULATED
-  add_tabulated_pair_force(p1,p2,ia_params,d,dist,force);
+  if (pots & PAIR_POT_TAB)
+    add_tabulated_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
   /* Gay-Berne */
 #ifdef GAY_BERNE
-  add_gb_pair_force(p1,p2,ia_params,d,dist,force,torgue1,torgue2);
+  if (pots & PAIR_POT_GB)
+    add_gb_pair_force(p1,p2,ia_params,d,dist,force,torgue1,torgue2);
 #endif
 #ifdef INTER_RF
-  add_interrf_pair_force(p1,p2,ia_params,d,dist, force);
+  if (pots & PAIR_POT_INTER_RF)
+    add_interrf_pair_force(p1,p2,ia_params,d,dist, force);
 #endif
 #ifdef ADRESS
 #ifdef INTERFACE_CORRECTION
-  add_adress_tab_pair_force(p1,p2,ia_params,d,dist,force);
+  if (pots & PAIR_POT_ADRESS_TAB)
+    add_adress_tab_pair_force(p1,p2,ia_params,d,dist,force);
 #endif
 #endif
 }
@@ -370,12 +413,28 @@ MDINLINE void add_non_bonded_pair_force(Particle *p1, Particle *p2,
     p2->f.torque[j] += torque2[j];
 #endif
   }
+
+  /***********************************************/
+  /* observables requested for this step         */
+  /***********************************************/
+
+  if (fused_observables) {
+    if (fused_observables & FUSED_OBS_ENERGY)
+      add_fused_pair_energy(p1, p2, d, dist, dist2);
+    if (fused_observables & FUSED_OBS_PRESSURE)
+      add_fused_pair_virials(p1, p2, d, dist, dist2);
+  }
 }
 
-/** Calculate bonded forces for one particle.
-    @param p1 particle for which to calculate forces
+/** Calculate the force of one bonded interaction and add it to the
+    particles involved.
+    @param p1 particle which stores the bond
+    @param p2 first partner
+    @param p3 second partner or NULL
+    @param p4 third partner or NULL
+    @param type_num number of the bonded interaction type
 */
-MDINLINE void add_bonded_force(Particle *p1)
+MDINLINE void add_bond_force(Particle *p1, Particle *p2, Particle *p3, Particle *p4, int type_num)
 {
   double dx[3]     = { 0., 0., 0. };
   double force[3]  = { 0., 0., 0. };
@@ -386,9 +445,8 @@ MDINLINE void add_bonded_force(Particle *p1)
   double torque2[3] = { 0., 0., 0. };
 #endif
   char *errtxt;
-  Particle *p2, *p3 = NULL, *p4 = NULL;
-  Bonded_ia_parameters *iaparams;
-  int i, j, type_num, type, n_partners, bond_broken;
+  Bonded_ia_parameters *iaparams = &bonded_ia_params[type_num];
+  int j, type = iaparams->type, n_partners = iaparams->num, bond_broken;
 
 #ifdef ADRESS
   double tmp, force_weight=1;
@@ -396,229 +454,190 @@ MDINLINE void add_bonded_force(Particle *p1)
   //if (force_weight<ROUND_ERROR_PREC) return;
 #endif
 
-  i = 0;
-  while(i<p1->bl.n) {
-    type_num = p1->bl.e[i++];
-    iaparams = &bonded_ia_params[type_num];
-    type = iaparams->type;
-    n_partners = iaparams->num;
-
-    /* fetch particle 2, which is always needed */
-    p2 = local_particles[p1->bl.e[i++]];
-    if (!p2) {
-      errtxt = runtime_error(128 + 2*TCL_INTEGER_SPACE);
-      ERROR_SPRINTF(errtxt,"{078 bond broken between particles %d and %d (particles not stored on the same node)} ",
-	      p1->p.identity, p1->bl.e[i-1]);
-      return;
-    }
-
-    /* fetch particle 3 eventually */
-    if (n_partners >= 2) {
-      p3 = local_particles[p1->bl.e[i++]];
-      if (!p3) {
-	errtxt = runtime_error(128 + 3*TCL_INTEGER_SPACE);
-	ERROR_SPRINTF(errtxt,"{079 bond broken between particles %d, %d and %d (particles not stored on the same node)} ",
-		p1->p.identity, p1->bl.e[i-2], p1->bl.e[i-1]);
-	return;
-      }
-    }
-
-    /* fetch particle 4 eventually */
-    if (n_partners >= 3) {
-      p4 = local_particles[p1->bl.e[i++]];
-      if (!p4) {
-	errtxt = runtime_error(128 + 4*TCL_INTEGER_SPACE);
-	ERROR_SPRINTF(errtxt,"{080 bond broken between particles %d, %d, %d and %d (particles not stored on the same node)} ",
-		p1->p.identity, p1->bl.e[i-3], p1->bl.e[i-2], p1->bl.e[i-1]);
-	return;
-      }
-    }
-
-    if (n_partners == 1) {
-      /* because of the NPT pressure calculation for pair forces, we need the
-	 1->2 distance vector here. For many body interactions this vector is not needed,
-	 and the pressure calculation not yet clear. */
-      get_mi_vector(dx, p1->r.p, p2->r.p);
-    }
+  if (n_partners == 1) {
+    /* because of the NPT pressure calculation for pair forces, we need the
+       1->2 distance vector here. For many body interactions this vector is not needed,
+       and the pressure calculation not yet clear. */
+    get_mi_vector(dx, p1->r.p, p2->r.p);
+  }
 
-    switch (type) {
-    case BONDED_IA_FENE:
-      bond_broken = calc_fene_pair_force(p1, p2, iaparams, dx, force);
-      break;
-    case BONDED_IA_HARMONIC:
-      bond_broken = calc_harmonic_pair_force(p1, p2, iaparams, dx, force);
-      break;
+  switch (type) {
+  case BONDED_IA_FENE:
+    bond_broken = calc_fene_pair_force(p1, p2, iaparams, dx, force);
+    break;
+  case BONDED_IA_HARMONIC:
+    bond_broken = calc_harmonic_pair_force(p1, p2, iaparams, dx, force);
+    break;
 #ifdef LENNARD_JONES
-    case BONDED_IA_SUBT_LJ:
-      bond_broken = calc_subt_lj_pair_force(p1, p2, iaparams, dx, force);
-      break;
+  case BONDED_IA_SUBT_LJ:
+    bond_broken = calc_subt_lj_pair_force(p1, p2, iaparams, dx, force);
+    break;
 #endif
 #ifdef BOND_ANGLE
-    case BONDED_IA_ANGLE:
-      bond_broken = calc_angle_force(p1, p2, p3, iaparams, force, force2);
-      break;
+  case BONDED_IA_ANGLE:
+    bond_broken = calc_angle_force(p1, p2, p3, iaparams, force, force2);
+    break;
 #endif
 #ifdef BOND_ANGLEDIST
-    case BONDED_IA_ANGLEDIST:
-      bond_broken = calc_angledist_force(p1, p2, p3, iaparams, force, force2);
-      break;
+  case BONDED_IA_ANGLEDIST:
+    bond_broken = calc_angledist_force(p1, p2, p3, iaparams, force, force2);
+    break;
 #endif
 #ifdef BOND_ENDANGLEDIST
-    case BONDED_IA_ENDANGLEDIST:
-      bond_broken = calc_endangledist_pair_force(p1, p2, iaparams, dx, force, force2);
-      break;
+  case BONDED_IA_ENDANGLEDIST:
+    bond_broken = calc_endangledist_pair_force(p1, p2, iaparams, dx, force, force2);
+    break;
 #endif
-    case BONDED_IA_DIHEDRAL:
-      bond_broken = calc_dihedral_force(p1, p2, p3, p4, iaparams, force, force2, force3);
-      break;
+  case BONDED_IA_DIHEDRAL:
+    bond_broken = calc_dihedral_force(p1, p2, p3, p4, iaparams, force, force2, force3);
+    break;
 #ifdef BOND_CONSTRAINT
-    case BONDED_IA_RIGID_BOND:
-      //add_rigid_bond_pair_force(p1,p2, iaparams, force, force2);
-      bond_broken = 0; 
-      force[0]=force[1]=force[2]=0.0;
-      break;
+  case BONDED_IA_RIGID_BOND:
+    //add_rigid_bond_pair_force(p1,p2, iaparams, force, force2);
+    bond_broken = 0; 
+    force[0]=force[1]=force[2]=0.0;
+    break;
 #endif
 #ifdef TABULATED
-    case BONDED_IA_TABULATED:
-      switch(iaparams->p.tab.type) {
-      case TAB_BOND_LENGTH:
-	bond_broken = calc_tab_bond_force(p1, p2, iaparams, dx, force);
-	break;
-      case TAB_BOND_ANGLE:
-	bond_broken = calc_tab_angle_force(p1, p2, p3, iaparams, force, force2);
-	break;
-      case TAB_BOND_DIHEDRAL:
-	bond_broken = calc_tab_dihedral_force(p1, p2, p3, p4, iaparams, force, force2, force3);
-	break;
-      default:
-	errtxt = runtime_error(128 + TCL_INTEGER_SPACE);
-	ERROR_SPRINTF(errtxt,"{081 add_bonded_force: tabulated bond type of atom %d unknown\n", p1->p.identity);
-	return;
-      }
+  case BONDED_IA_TABULATED:
+    switch(iaparams->p.tab.type) {
+    case TAB_BOND_LENGTH:
+      bond_broken = calc_tab_bond_force(p1, p2, iaparams, dx, force);
+      break;
+    case TAB_BOND_ANGLE:
+      bond_broken = calc_tab_angle_force(p1, p2, p3, iaparams, force, force2);
       break;
+    case TAB_BOND_DIHEDRAL:
+      bond_broken = calc_tab_dihedral_force(p1, p2, p3, p4, iaparams, force, force2, force3);
+      break;
+    default:
+      errtxt = runtime_error(128 + TCL_INTEGER_SPACE);
+      ERROR_SPRINTF(errtxt,"{081 add_bond_force: tabulated bond type of atom %d unknown\n", p1->p.identity);
+      return;
+    }
+    break;
 #endif
 #ifdef OVERLAPPED
-    case BONDED_IA_OVERLAPPED:
-      switch(iaparams->p.overlap.type) {
-      case OVERLAP_BOND_LENGTH:
-        bond_broken = calc_overlap_bond_force(p1, p2, iaparams, dx, force);
-        break;
-      case OVERLAP_BOND_ANGLE:
-        bond_broken = calc_overlap_angle_force(p1, p2, p3, iaparams, force, force2);
-        break;
-      case OVERLAP_BOND_DIHEDRAL:
-        bond_broken = calc_overlap_dihedral_force(p1, p2, p3, p4, iaparams, force, force2, force3);
-        break;
-      default:
-        errtxt = runtime_error(128 + TCL_INTEGER_SPACE);
-        ERROR_SPRINTF(errtxt,"{081 add_bonded_force: overlapped bond type of atom %d unknown\n", p1->p.identity);
-        return;
-      }
+  case BONDED_IA_OVERLAPPED:
+    switch(iaparams->p.overlap.type) {
+    case OVERLAP_BOND_LENGTH:
+      bond_broken = calc_overlap_bond_force(p1, p2, iaparams, dx, force);
       break;
-#endif
-#ifdef BOND_VIRTUAL
-    case BONDED_IA_VIRTUAL_BOND:
-      bond_broken = 0;
-      force[0]=force[1]=force[2]=0.0;
+    case OVERLAP_BOND_ANGLE:
+      bond_broken = calc_overlap_angle_force(p1, p2, p3, iaparams, force, force2);
       break;
-#endif
-    default :
+    case OVERLAP_BOND_DIHEDRAL:
+      bond_broken = calc_overlap_dihedral_force(p1, p2, p3, p4, iaparams, force, force2, force3);
+      break;
+    default:
       errtxt = runtime_error(128 + TCL_INTEGER_SPACE);
-      ERROR_SPRINTF(errtxt,"{082 add_bonded_force: bond type of atom %d unknown\n", p1->p.identity);
+      ERROR_SPRINTF(errtxt,"{081 add_bond_force: overlapped bond type of atom %d unknown\n", p1->p.identity);
       return;
     }
+    break;
+#endif
+#ifdef BOND_VIRTUAL
+  case BONDED_IA_VIRTUAL_BOND:
+    bond_broken = 0;
+    force[0]=force[1]=force[2]=0.0;
+    break;
+#endif
+  default :
+    errtxt = runtime_error(128 + TCL_INTEGER_SPACE);
+    ERROR_SPRINTF(errtxt,"{082 add_bond_force: bond type of atom %d unknown\n", p1->p.identity);
+    return;
+  }
 
-    switch (n_partners) {
-    case 1:
-      if (bond_broken) {
-	char *errtext = runtime_error(128 + 2*TCL_INTEGER_SPACE);
-	ERROR_SPRINTF(errtext,"{083 bond broken between particles %d and %d} ",
-		p1->p.identity, p2->p.identity); 
-	continue;
-      }
-      
+  switch (n_partners) {
+  case 1:
+    if (bond_broken) {
+      char *errtext = runtime_error(128 + 2*TCL_INTEGER_SPACE);
+      ERROR_SPRINTF(errtext,"{083 bond broken between particles %d and %d} ",
+	      p1->p.identity, p2->p.identity); 
+      return;
+    }
+    
 #ifdef ADRESS
-      if((get_mol_com_particle(p1))->p.identity == (get_mol_com_particle(p2))->p.identity)
-	force_weight = 1.0;
-      else 
-	force_weight = adress_non_bonded_force_weight(p1,p2);
+    if((get_mol_com_particle(p1))->p.identity == (get_mol_com_particle(p2))->p.identity)
+      force_weight = 1.0;
+    else 
+      force_weight = adress_non_bonded_force_weight(p1,p2);
 #endif
 
-      for (j = 0; j < 3; j++) {
+    for (j = 0; j < 3; j++) {
 #ifdef ADRESS
-        tmp=force_weight*force[j];
-	p1->f.f[j] += tmp;
-	p2->f.f[j] -= tmp;
+      tmp=force_weight*force[j];
+      p1->f.f[j] += tmp;
+      p2->f.f[j] -= tmp;
 #else // ADRESS
 
-	switch (type) {
+      switch (type) {
 #ifdef BOND_ENDANGLEDIST
-	case BONDED_IA_ENDANGLEDIST:
-          p1->f.f[j] += force[j];
-          p2->f.f[j] += force2[j];
-	  break;
+      case BONDED_IA_ENDANGLEDIST:
+        p1->f.f[j] += force[j];
+        p2->f.f[j] += force2[j];
+        break;
 #endif // BOND_ENDANGLEDIST
-	default:
-	  p1->f.f[j] += force[j];
-	  p2->f.f[j] -= force[j];
+      default:
+        p1->f.f[j] += force[j];
+        p2->f.f[j] -= force[j];
 #ifdef ROTATION
-	  p1->f.torque[j] += torque1[j];
-	  p2->f.torque[j] += torque2[j];
+        p1->f.torque[j] += torque1[j];
+        p2->f.torque[j] += torque2[j];
 #endif
-	}
+      }
 #endif // NOT ADRESS
 
 #ifdef NPT
-	if(integ_switch == INTEG_METHOD_NPT_ISO)
-	  nptiso.p_vir[j] += force[j] * dx[j];
+      if(integ_switch == INTEG_METHOD_NPT_ISO)
+        nptiso.p_vir[j] += force[j] * dx[j];
 #endif
-      }
-      break;
-    case 2:
-      if (bond_broken) {
-	char *errtext = runtime_error(128 + 3*TCL_INTEGER_SPACE);
-	ERROR_SPRINTF(errtext,"{084 bond broken between particles %d, %d and %d} ",
-		p1->p.identity, p2->p.identity, p3->p.identity); 
-	continue;
-      }
+    }
+    break;
+  case 2:
+    if (bond_broken) {
+      char *errtext = runtime_error(128 + 3*TCL_INTEGER_SPACE);
+      ERROR_SPRINTF(errtext,"{084 bond broken between particles %d, %d and %d} ",
+	      p1->p.identity, p2->p.identity, p3->p.identity); 
+      return;
+    }
 
-      for (j = 0; j < 3; j++) {
+    for (j = 0; j < 3; j++) {
 #ifdef ADRESS
-	p1->f.f[j] += force_weight*force[j];
-	p2->f.f[j] += force_weight*force2[j];
-	p3->f.f[j] -= force_weight*(force[j] + force2[j]);
+      p1->f.f[j] += force_weight*force[j];
+      p2->f.f[j] += force_weight*force2[j];
+      p3->f.f[j] -= force_weight*(force[j] + force2[j]);
 #else
-	p1->f.f[j] += force[j];
-	p2->f.f[j] += force2[j];
-	p3->f.f[j] -= (force[j] + force2[j]);
+      p1->f.f[j] += force[j];
+      p2->f.f[j] += force2[j];
+      p3->f.f[j] -= (force[j] + force2[j]);
 #endif
-      }
-      break;
-    case 3:
-      if (bond_broken) {
-	char *errtext = runtime_error(128 + 4*TCL_INTEGER_SPACE);
-	ERROR_SPRINTF(errtext,"{085 bond broken between particles %d, %d, %d and %d} ",
-		p1->p.identity, p2->p.identity, p3->p.identity, p4->p.identity); 
-	continue;
-      }
+    }
+    break;
+  case 3:
+    if (bond_broken) {
+      char *errtext = runtime_error(128 + 4*TCL_INTEGER_SPACE);
+      ERROR_SPRINTF(errtext,"{085 bond broken between particles %d, %d, %d and %d} ",
+	      p1->p.identity, p2->p.identity, p3->p.identity, p4->p.identity); 
+      return;
+    }
 
-      for (j = 0; j < 3; j++) {
+    for (j = 0; j < 3; j++) {
 #ifdef ADRESS
-	p1->f.f[j] += force_weight*force[j];
-	p2->f.f[j] += force_weight*force2[j];
-	p3->f.f[j] += force_weight*force3[j];
-	p4->f.f[j] -= force_weight*(force[j] + force2[j] + force3[j]);
+      p1->f.f[j] += force_weight*force[j];
+      p2->f.f[j] += force_weight*force2[j];
+      p3->f.f[j] += force_weight*force3[j];
+      p4->f.f[j] -= force_weight*(force[j] + force2[j] + force3[j]);
 #else
-	p1->f.f[j] += force[j];
-	p2->f.f[j] += force2[j];
-	p3->f.f[j] += force3[j];
-	p4->f.f[j] -= (force[j] + force2[j] + force3[j]);
+      p1->f.f[j] += force[j];
+      p2->f.f[j] += force2[j];
+      p3->f.f[j] += force3[j];
+      p4->f.f[j] -= (force[j] + force2[j] + force3[j]);
 #endif
-      }
-      break;
     }
+    break;
   }
-}  
+}
 
 /** add force to another. This is used when collecting ghost forces. */
 MDINLINE void add_force(ParticleForce *F_to, ParticleForce *F_add)
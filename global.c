@@ -28,6 +28,7 @@
 #include "imd.h"
 #include "tuning.h"
 #include "domain_decomposition.h"
+#include "random.h"
 #include "layered.h"
 #include "pressure.h"
 #include "rattle.h"
@@ -90,6 +91,8 @@ const Datafield fields[] = {
   {&dpd_twf,            TYPE_INT, 1, "dpd_twf",    ro_callback,     6 },         /* 40 from thermostat.c */
   {&dpd_wf,             TYPE_INT, 1, "dpd_wf",    ro_callback,     5 },         /* 41 from thermostat.c */
   {adress_vars,      TYPE_DOUBLE, 7, "adress_vars",ro_callback,  1 },         /* 42  from adresso.c */
+  {&counter_rng_seed,   TYPE_INT, 1, "counter_rng_seed", counter_rng_seed_callback, 14 }, /* 43 from random.c */
+  {&counter_rng_step,   TYPE_INT, 1, "counter_rng_step", counter_rng_step_callback, 14 }, /* 44 from random.c */
   { NULL, 0, 0, NULL, NULL, 0 }
 };
 
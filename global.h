@@ -160,6 +160,10 @@ extern const Datafield fields[];
 #define FIELD_DPD_WF           41
 /** index of \ref address_var in \ref #fields */
 #define FIELD_ADRESS           42
+/** index of \ref counter_rng_seed in \ref #fields */
+#define FIELD_COUNTER_RNG_SEED 43
+/** index of \ref counter_rng_step in \ref #fields */
+#define FIELD_COUNTER_RNG_STEP 44
 /*@}*/
 
 /**********************************************
@@ -162,6 +162,27 @@ MDINLINE void halo_dtcopy(void *r_buffer, void *s_buffer, Fieldtype type) {
  * @param datatype   MPI datatype for the lattice data (Input)
  */
 void prepare_halo_communication(HaloCommunicator *hc, Lattice *lattice, Fieldtype fieldtype, MPI_Datatype datatype) {
+  int n;
+  Fieldtype fieldtypes[6];
+  MPI_Datatype datatypes[6];
+
+  for (n=0; n<6; n++) {
+    fieldtypes[n] = fieldtype;
+    datatypes[n] = datatype;
+  }
+
+  prepare_halo_communication_faces(hc, lattice, fieldtypes, datatypes);
+
+}
+
+/** Preparation of a halo parallelization scheme with different data
+ *  exchanged across the faces of the local domain.
+ * @param hc         halo communicator beeing created (Input/Output)
+ * @param lattice    lattice the communcation is created for (Input)
+ * @param fieldtypes field layouts of the data exchanged per face (Input)
+ * @param datatypes  MPI datatypes of the data exchanged per face (Input)
+ */
+void prepare_halo_communication_faces(HaloCommunicator *hc, Lattice *lattice, Fieldtype fieldtypes[6], MPI_Datatype datatypes[6]) {
   int k, n, dir, lr, cnt, num = 0 ;
   int *grid  = lattice->grid ;
   int *period = lattice->halo_grid ;
@@ -176,13 +197,13 @@ void prepare_halo_communication(HaloCommunicator *hc, Lattice *lattice, Fieldtyp
   hc->num = num ;
   hc->halo_info = realloc(hc->halo_info,num*sizeof(HaloInfo)) ;
 
-  int extent = fieldtype->extent;
-
   cnt = 0 ;
   for (dir=0; dir<3; dir++) {
     for (lr=0; lr<2; lr++) {
 
 	      HaloInfo *hinfo = &(hc->halo_info[cnt]) ;
+	      Fieldtype fieldtype = fieldtypes[cnt];
+	      int extent = fieldtype->extent;
 
 	      int nblocks = 1 ;
 	      for (k=dir+1;k<3;k++) {
@@ -211,8 +232,9 @@ void prepare_halo_communication(HaloCommunicator *hc, Lattice *lattice, Fieldtyp
 	      hinfo->dest_node = node_neighbors[2*dir+lr];
 
 	      halo_create_field_vector(nblocks, stride, skip, fieldtype, &hinfo->fieldtype);
+	      hinfo->request[0] = hinfo->request[1] = MPI_REQUEST_NULL;
 	      
-	      MPI_Type_vector(nblocks, stride, skip, datatype, &hinfo->datatype);
+	      MPI_Type_vector(nblocks, stride, skip, datatypes[cnt], &hinfo->datatype);
 	      MPI_Type_commit(&hinfo->datatype);
 			       
 #ifdef PARTIAL_PERIODIC
@@ -274,80 +296,91 @@ void release_halo_communication(HaloCommunicator *hc) {
  * @param hc halo communicator describing the parallelization scheme
  */
 void halo_communication(HaloCommunicator *hc) {
+  int dir;
+
+  HALO_TRACE(fprintf(stderr, "%d: halo_comm %p (num=%d)\n", this_node, hc, hc->num)) ;
+
+  for (dir=0; dir<3; dir++) {
+    halo_communication_start(hc, dir);
+    halo_communication_finish(hc, dir);
+  }
+
+  HALO_TRACE(fprintf(stderr, "%d: halo_comm %p finished\n", this_node, hc));
+
+}
+
+/** Start the non-blocking halo exchange in one space direction.
+ *  Local copies and open boundaries are handled immediately.
+ * @param hc  halo communicator describing the parallelization scheme
+ * @param dir space direction of the exchange
+ */
+void halo_communication_start(HaloCommunicator *hc, int dir) {
   int n, comm_type, s_node, r_node;
   void *s_buffer, *r_buffer ;
+  HaloInfo *hinfo;
 
-  Fieldtype fieldtype;
-  MPI_Datatype datatype;
-  MPI_Request request;
-  MPI_Status status;
-
-    HALO_TRACE(fprintf(stderr, "%d: halo_comm %p (num=%d)\n", this_node, hc, hc->num)) ;
+  for (n = 2*dir; n < 2*dir+2; n++) {
 
-    for (n = 0; n < hc->num; n++) {
+    HALO_TRACE(fprintf(stderr, "%d: halo_comm round %d\n", this_node, n)) ;
 
-	HALO_TRACE(fprintf(stderr, "%d: halo_comm round %d\n", this_node, n)) ;
+    hinfo = &(hc->halo_info[n]);
+    comm_type = hinfo->type ;
+    s_buffer = hinfo->send_buffer ;
+    r_buffer = hinfo->recv_buffer ;
+    s_node = hinfo->source_node ;
+    r_node = hinfo->dest_node ;
 
-	comm_type = hc->halo_info[n].type ;
-	s_buffer = hc->halo_info[n].send_buffer ;
-	r_buffer = hc->halo_info[n].recv_buffer ;
+    hinfo->request[0] = hinfo->request[1] = MPI_REQUEST_NULL;
 
-	switch (comm_type) {
+    switch (comm_type) {
 
-	    case HALO_LOCL:
-	      fieldtype = hc->halo_info[n].fieldtype;
-	      halo_dtcopy(r_buffer,s_buffer,fieldtype);
-	      break ;
+    case HALO_LOCL:
+      halo_dtcopy(r_buffer,s_buffer,hinfo->fieldtype);
+      break ;
 
-	    case HALO_SENDRECV:
-	      datatype = hc->halo_info[n].datatype;
-	      s_node = hc->halo_info[n].source_node ;
-	      r_node = hc->halo_info[n].dest_node ;
-	      
-	      HALO_TRACE(fprintf(stderr,"%d: halo_comm sendrecv %d to %d (%d) (%p)\n",this_node,s_node,r_node,REQ_HALO_SPREAD,&datatype));
-
-	      MPI_Sendrecv(s_buffer, 1, datatype, r_node, REQ_HALO_SPREAD,
-			   r_buffer, 1, datatype, s_node, REQ_HALO_SPREAD,
-			   MPI_COMM_WORLD, &status);
-	      break ;
-
-	    case HALO_SEND:
-	      datatype = hc->halo_info[n].datatype;
-	      fieldtype = hc->halo_info[n].fieldtype;
-	      s_node = hc->halo_info[n].source_node ;
-	      r_node = hc->halo_info[n].dest_node ;
-	      
-	      HALO_TRACE(fprintf(stderr,"%d: halo_comm send to %d.\n",this_node,r_node));
+    case HALO_SENDRECV:
+      HALO_TRACE(fprintf(stderr,"%d: halo_comm sendrecv %d to %d (%d)\n",this_node,s_node,r_node,REQ_HALO_SPREAD));
 
-	      MPI_Isend(s_buffer, 1, datatype, r_node, REQ_HALO_SPREAD, MPI_COMM_WORLD, &request);
-	      halo_dtset(r_buffer,0,fieldtype);
-	      MPI_Wait(&request,&status);
-	      break;
+      MPI_Irecv(r_buffer, 1, hinfo->datatype, s_node, REQ_HALO_SPREAD, MPI_COMM_WORLD, &hinfo->request[0]);
+      MPI_Isend(s_buffer, 1, hinfo->datatype, r_node, REQ_HALO_SPREAD, MPI_COMM_WORLD, &hinfo->request[1]);
+      break ;
 
-	    case HALO_RECV:
-	      datatype = hc->halo_info[n].datatype;
-	      s_node = hc->halo_info[n].source_node ;
-	      r_node = hc->halo_info[n].dest_node ;
+    case HALO_SEND:
+      HALO_TRACE(fprintf(stderr,"%d: halo_comm send to %d.\n",this_node,r_node));
 
-	      HALO_TRACE(fprintf(stderr,"%d: halo_comm recv from %d.\n",this_node,s_node));
+      MPI_Isend(s_buffer, 1, hinfo->datatype, r_node, REQ_HALO_SPREAD, MPI_COMM_WORLD, &hinfo->request[1]);
+      halo_dtset(r_buffer,0,hinfo->fieldtype);
+      break;
 
-	      MPI_Irecv(r_buffer, 1, datatype, s_node, REQ_HALO_SPREAD, MPI_COMM_WORLD, &request);
-	      MPI_Wait(&request,&status);
-	      break;
+    case HALO_RECV:
+      HALO_TRACE(fprintf(stderr,"%d: halo_comm recv from %d.\n",this_node,s_node));
 
-	    case HALO_OPEN:
-	      fieldtype = hc->halo_info[n].fieldtype;
+      MPI_Irecv(r_buffer, 1, hinfo->datatype, s_node, REQ_HALO_SPREAD, MPI_COMM_WORLD, &hinfo->request[0]);
+      break;
 
-	      HALO_TRACE(fprintf(stderr,"%d: halo_comm open boundaries\n",this_node));
+    case HALO_OPEN:
+      HALO_TRACE(fprintf(stderr,"%d: halo_comm open boundaries\n",this_node));
 
-	      halo_dtset(r_buffer,0,fieldtype);
-	      break;
+      halo_dtset(r_buffer,0,hinfo->fieldtype);
+      break;
 	      
-	}
-
     }
 
-    HALO_TRACE(fprintf(stderr, "%d: halo_comm %p finished\n", this_node, hc));
+  }
+
+}
+
+/** Complete the halo exchange in one space direction.
+ * @param hc  halo communicator describing the parallelization scheme
+ * @param dir space direction of the exchange
+ */
+void halo_communication_finish(HaloCommunicator *hc, int dir) {
+  int n;
+  MPI_Status status[2];
+
+  for (n = 2*dir; n < 2*dir+2; n++) {
+    MPI_Waitall(2, hc->halo_info[n].request, status);
+  }
 
 }
 
@@ -81,6 +81,8 @@ typedef struct {
   Fieldtype fieldtype;   /**< type layout of the data beeing exchanged */
   MPI_Datatype datatype; /**< MPI datatype of data beeing communicated */
 
+  MPI_Request request[2]; /**< pending requests of a non-blocking exchange */
+
 } HaloInfo ;
 
 /** Structure holding a set of \ref HaloInfo which comprise a certain
@@ -125,6 +127,18 @@ void halo_free_fieldtype(Fieldtype *ftype);
  */
 void prepare_halo_communication(HaloCommunicator *hc, Lattice *lattice, Fieldtype fieldtype, MPI_Datatype datatype);
 
+/** Preparation of a halo parallelization scheme where the data
+ *  exchanged differs between the faces of the local domain. The data
+ *  received in the halo behind face \f$2\cdot dir+lr\f$, with lr=0 for
+ *  the right and lr=1 for the left halo, is described by the entry
+ *  \f$2\cdot dir+lr\f$ of the type arrays.
+ * @param hc         halo communicator beeing created (Input/Output)
+ * @param lattice    lattice the communcation is created for (Input)
+ * @param fieldtypes field layouts of the data exchanged per face (Input)
+ * @param datatypes  MPI datatypes of the data exchanged per face (Input)
+ */
+void prepare_halo_communication_faces(HaloCommunicator *hc, Lattice *lattice, Fieldtype fieldtypes[6], MPI_Datatype datatypes[6]);
+
 /** Frees datastrutures associated with a halo communicator 
  * @param hc halo communicator to be released
  */
@@ -136,6 +150,24 @@ void release_halo_communication(HaloCommunicator *hc);
  */
 void halo_communication(HaloCommunicator *hc);
 
+/** Start the non-blocking halo exchange in one space direction.
+ *  The send buffers must not be modified and the halo regions must not
+ *  be accessed before the exchange is completed by \ref
+ *  halo_communication_finish. The exchange in a direction has to be
+ *  finished before the next direction is started, since the halo
+ *  regions of the earlier directions are forwarded to the edges.
+ * @param hc  halo communicator describing the parallelization scheme
+ * @param dir space direction of the exchange
+ */
+void halo_communication_start(HaloCommunicator *hc, int dir);
+
+/** Complete the halo exchange in one space direction started by \ref
+ *  halo_communication_start.
+ * @param hc  halo communicator describing the parallelization scheme
+ * @param dir space direction of the exchange
+ */
+void halo_communication_finish(HaloCommunicator *hc, int dir);
+
 #endif /* LATTICE */
 
 #endif /* HALO_H */
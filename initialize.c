@@ -19,6 +19,7 @@
 #include "particle_data.h"
 #include "interaction_data.h"
 #include "binary_file.h"
+#include "mpiio.h"
 #include "integrate.h"
 #include "statistics.h"
 #include "energy.h"
@@ -56,6 +57,9 @@
 #include "iccp3m.h" /* -iccp3m- */
 #include "adresso.h"
 #include "metadynamics.h"
+#include "virtual_sites.h"
+#include "bonded_worklist.h"
+#include "constraint.h"
 
 /** whether before integration the thermostat has to be reinitialized */
 static int reinit_thermo = 1;
@@ -166,6 +170,12 @@ void on_integration_start()
   
 #endif /*NPT*/
 
+  if ((thermo_switch & THERMO_BAOAB) &&
+      (integ_switch == INTEG_METHOD_NPT_ISO || nemd_method != NEMD_METHOD_OFF)) {
+    errtext = runtime_error(128);
+    ERROR_SPRINTF(errtext,"{120 the BAOAB Langevin splitting only works with the NVT integrator without NEMD} ");
+  }
+
   if (!check_obs_calc_initialized()) return;
 
 #ifdef LB
@@ -186,6 +196,8 @@ void on_integration_start()
       errtext = runtime_error(128);
       ERROR_SPRINTF(errtext,"{101 Lattice Boltzmann fluid viscosity not set} ");
     }
+    /* the fluid may have been changed since the last integration */
+    update_fluid_fields = 1;
   }
 #endif
 
@@ -211,6 +223,7 @@ void on_integration_start()
   /* Update particle and observable information for routines in statistics.c */
   invalidate_obs();
   freePartCfg();
+  freePartCfgFields();
 
   on_observable_calc();
 }
@@ -270,11 +283,16 @@ void on_particle_change()
   reinit_electrostatics = 1;
   reinit_magnetostatics = 1;
   rebuild_verletlist = 1;
+  rebuild_bonded_worklist = 1;
+#ifdef VIRTUAL_SITES
+  rebuild_vs_list = 1;
+#endif
 
   invalidate_obs();
 
   /* the particle information is no longer valid */
   freePartCfg();
+  freePartCfgFields();
 }
 
 void on_coulomb_change()
@@ -350,6 +368,13 @@ void on_short_range_ia_change()
   integrate_vv_recalc_maxrange();
   on_parameter_change(FIELD_MAXRANGE);
 
+  /* the bonded work list depends on the number of partners per bond type */
+  rebuild_bonded_worklist = 1;
+#ifdef CONSTRAINTS
+  /* the constraint buckets depend on the cutoff */
+  rebuild_constraint_buckets = 1;
+#endif
+
   recalc_forces = 1;
 }
 
@@ -358,10 +383,15 @@ void on_constraint_change()
   EVENT_TRACE(fprintf(stderr, "%d: on_constraint_change\n", this_node));
   invalidate_obs();
 
+#ifdef CONSTRAINTS
+  rebuild_constraint_buckets = 1;
+#endif
+
 #ifdef LB
 #ifdef CONSTRAINTS
   if(lattice_switch & LATTICE_LB) {
     lb_init_constraints();
+    lb_init_fluid_sites();
   }
 #endif
 #endif
@@ -378,6 +408,14 @@ void on_cell_structure_change()
 void on_resort_particles()
 {
   EVENT_TRACE(fprintf(stderr, "%d: on_resort_particles\n", this_node));
+
+  /* the bonded work list points into the cells */
+  rebuild_bonded_worklist = 1;
+
+#ifdef VIRTUAL_SITES
+  /* the virtual site list points into the cells */
+  rebuild_vs_list = 1;
+#endif
 #ifdef ELECTROSTATICS
   switch (coulomb.method) {
 #ifdef ELP3M
@@ -412,6 +450,10 @@ void on_resort_particles()
 #ifdef NPT
 void on_NpT_boxl_change(double scal1) {
   grid_changed_box_l();
+
+#ifdef CONSTRAINTS
+  rebuild_constraint_buckets = 1;
+#endif
   
 #ifdef ELECTROSTATICS
   switch(coulomb.method) {
@@ -464,6 +506,10 @@ void on_parameter_change(int field)
     grid_changed_n_nodes();
   if (field == FIELD_BOXL || field == FIELD_NODEGRID)
     grid_changed_box_l();
+#ifdef CONSTRAINTS
+  if (field == FIELD_BOXL)
+    rebuild_constraint_buckets = 1;
+#endif
   if (field == FIELD_TIMESTEP || field == FIELD_TEMPERATURE || field == FIELD_LANGEVIN_GAMMA || field == FIELD_DPD_TGAMMA
       || field == FIELD_DPD_GAMMA || field == FIELD_NPTISO_G0 || field == FIELD_NPTISO_GV || field == FIELD_NPTISO_PISTON )
     reinit_thermo = 1;
@@ -559,6 +605,14 @@ void on_parameter_change(int field)
     cells_re_init(CELL_STRUCTURE_CURRENT);
   }
 
+#ifdef BOND_CONSTRAINT
+  /* rigid bonds need ghost velocities */
+  if (field == FIELD_RIGIDBONDS) {
+    on_ghost_flags_change();
+    cells_re_init(CELL_STRUCTURE_CURRENT);
+  }
+#endif
+
   if (field == FIELD_MAXRANGE)
     rebuild_verletlist = 1;
 
@@ -588,7 +642,7 @@ void on_parameter_change(int field)
   }
 
   if (lattice_switch & LATTICE_LB) {
-    if (field == FIELD_TEMPERATURE) {
+    if (field == FIELD_TEMPERATURE || field == FIELD_TIMESTEP) {
       lb_reinit_parameters();
     }
 
@@ -676,6 +730,8 @@ static void init_tcl(Tcl_Interp *interp)
   /* in file binaryfile.c */
   REGISTER_COMMAND("writemd", writemd);
   REGISTER_COMMAND("readmd", readmd);
+  /* in file mpiio.c */
+  REGISTER_COMMAND("mpiio", mpiio);
   /* in file statistics.c */
   REGISTER_COMMAND("analyze", analyze);
   /* in file polymer.c */
@@ -706,6 +762,7 @@ static void init_tcl(Tcl_Interp *interp)
   REGISTER_COMMAND("bin", bin);
   /* in lb.c */
   REGISTER_COMMAND("lbfluid", lbfluid_cmd);
+  REGISTER_COMMAND("lbnode", lbnode_cmd);
   /* in utils.h */
   REGISTER_COMMAND("replacestdchannel", replacestdchannel);
   /* in iccp3m.h */
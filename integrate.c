@@ -29,6 +29,8 @@
 #include "rotation.h"
 #include "ghosts.h"
 #include "pressure.h"
+#include "energy.h"
+#include "statistics_accumulate.h"
 #include "p3m.h"
 #include "maggs.h"
 #include "thermostat.h"
@@ -94,6 +96,16 @@ void propagate_pos();
     \f[ v(t+0.5 \Delta t) = v(t) + 0.5 \Delta t f(t) \f] <br>
     \f[ p(t+\Delta t) = p(t) + \Delta t  v(t+0.5 \Delta t) \f] */
 void propagate_vel_pos();
+/** Propagate the velocities and positions with the BAOAB splitting of
+    the Langevin equation (Leimkuhler and Matthews, J. Chem. Phys. 138,
+    174102 (2013)). The half kick, the half drift, the exact
+    Ornstein-Uhlenbeck step of the thermostat and the second half drift
+    are done in one pass over the particles: <br>
+    \f[ v = v(t) + 0.5 \Delta t f(t), \quad p = p(t) + 0.5 \Delta t v \f] <br>
+    \f[ v' = e^{-\gamma\Delta t} v + \sqrt{(1 - e^{-2\gamma\Delta t}) k_B T/m}\, \xi \f] <br>
+    \f[ p(t+\Delta t) = p + 0.5 \Delta t v' \f]
+    The final half kick is done by \ref rescale_forces_propagate_vel. */
+void propagate_vel_pos_baoab();
 /** Rescale all particle forces with \f[ 0.5 \Delta t^2 \f] and propagate the velocities.
     Integration step 4 of the Velocity Verletintegrator:<br> 
     \f[ v(t+\Delta t) = v(t+0.5 \Delta t) + 0.5 \Delta t f(t+\Delta t) \f] */
@@ -125,7 +137,7 @@ void local_invalidate_system()
 int integrate_usage(Tcl_Interp *interp) 
 {
   Tcl_AppendResult(interp, "Usage of tcl-command integrate:\n", (char *)NULL);
-  Tcl_AppendResult(interp, "'integrate <INT n steps>' for integrating n steps \n", (char *)NULL);
+  Tcl_AppendResult(interp, "'integrate <INT n steps> [energy] [pressure]' for integrating n steps \n", (char *)NULL);
   Tcl_AppendResult(interp, "'integrate set' for printing integrator status \n", (char *)NULL);
   Tcl_AppendResult(interp, "'integrate set nvt' for enabling NVT integration or \n" , (char *)NULL);
 #ifdef NPT
@@ -276,7 +288,7 @@ int integrate_parse_npt_isotropic(Tcl_Interp *interp, int argc, char **argv)
 
 int integrate(ClientData data, Tcl_Interp *interp, int argc, char **argv) 
 {
-  int  n_steps;
+  int  n_steps, observables = 0, i;
   
   INTEG_TRACE(fprintf(stderr,"%d: integrate:\n",this_node));
 
@@ -302,9 +314,24 @@ int integrate(ClientData data, Tcl_Interp *interp, int argc, char **argv)
     Tcl_AppendResult(interp, "illegal number of steps (must be >0) \n", (char *) NULL);
     return integrate_usage(interp);;
   }
+
+  /* observables to calculate along with the last step */
+  for (i = 2; i < argc; i++) {
+    if (ARG_IS_S(i, "energy"))
+      observables |= FUSED_OBS_ENERGY;
+    else if (ARG_IS_S(i, "pressure"))
+      observables |= FUSED_OBS_PRESSURE;
+    else
+      return integrate_usage(interp);
+  }
+  /* and the ones of the active accumulators */
+  observables |= accumulated_observables();
+
   /* perform integration */
-  if (mpi_integrate(n_steps))
+  if (mpi_integrate(n_steps, observables))
     return mpi_gather_runtime_errors(interp, TCL_OK);
+  if (n_steps > 0)
+    accumulate_observables(observables);
   return TCL_OK;
 }
 
@@ -316,6 +343,7 @@ void integrate_vv_recalc_maxrange()
 
   /* maximal interaction cutoff */
   calc_maximal_cutoff();
+  calc_pair_potentials();
   if (max_cut <= 0.0) {
     max_range  = -1.0;
     max_range2 = -1.0;
@@ -358,7 +386,7 @@ void integrate_ensemble_init()
 
 /************************************************************/
 
-void integrate_vv(int n_steps)
+void integrate_vv(int n_steps, int observables)
 {
   int i;
 
@@ -386,7 +414,8 @@ void integrate_vv(int n_steps)
 //VIRTUAL_SITES pos (and vel for DPD) update for security reason !!!
 #ifdef VIRTUAL_SITES
     update_mol_vel_pos();
-    ghost_communicator(&cell_structure.update_ghost_pos_comm);
+    if (!vs_ghosts_local)
+      ghost_communicator(&cell_structure.update_ghost_pos_comm);
     if (check_runtime_errors()) return;
 #ifdef ADRESS
     //    adress_update_weights();
@@ -400,8 +429,10 @@ void integrate_vv(int n_steps)
    
    //VIRTUAL_SITES distribute forces
 #ifdef VIRTUAL_SITES
-   ghost_communicator(&cell_structure.collect_ghost_force_comm);
-   init_forces_ghosts();
+   if (!vs_ghosts_local) {
+     ghost_communicator(&cell_structure.collect_ghost_force_comm);
+     init_forces_ghosts();
+   }
    distribute_mol_force();
    if (check_runtime_errors()) return;
 #endif
@@ -450,6 +481,8 @@ void integrate_vv(int n_steps)
     */
     if(integ_switch == INTEG_METHOD_NPT_ISO || nemd_method != NEMD_METHOD_OFF) {
       propagate_vel();  propagate_pos(); }
+    else if(thermo_switch & THERMO_BAOAB)
+      propagate_vel_pos_baoab();
     else
       propagate_vel_pos();
 #ifdef ROTATION
@@ -458,7 +491,6 @@ void integrate_vv(int n_steps)
 
 #ifdef BOND_CONSTRAINT
     /**Correct those particle positions that participate in a rigid/constrained bond */
-    ghost_communicator(&cell_structure.update_ghost_pos_comm);
     correct_pos_shake();
 #endif
 
@@ -480,7 +512,8 @@ void integrate_vv(int n_steps)
 //VIRTUAL_SITES update pos and vel (for DPD)
 #ifdef VIRTUAL_SITES
    update_mol_vel_pos();
-   ghost_communicator(&cell_structure.update_ghost_pos_comm);
+   if (!vs_ghosts_local)
+     ghost_communicator(&cell_structure.update_ghost_pos_comm);
    if (check_runtime_errors()) break;
 #ifdef ADRESS
    //adress_update_weights();
@@ -494,12 +527,25 @@ void integrate_vv(int n_steps)
     transfer_momentum = 1;
 #endif
 
+    /* the requested observables share the pair loops of the last step */
+    if (i == n_steps - 1 && observables) {
+      if (observables & FUSED_OBS_ENERGY)
+	fused_energy_init();
+      if (observables & FUSED_OBS_PRESSURE)
+	fused_pressure_init();
+      fused_observables = observables;
+    }
+
     force_calc();
 
+    fused_observables = 0;
+
 //VIRTUAL_SITES distribute forces
 #ifdef VIRTUAL_SITES
-   ghost_communicator(&cell_structure.collect_ghost_force_comm);
-   init_forces_ghosts();
+   if (!vs_ghosts_local) {
+     ghost_communicator(&cell_structure.collect_ghost_force_comm);
+     init_forces_ghosts();
+   }
    distribute_mol_force();
    if (check_runtime_errors()) break;
 #endif
@@ -525,17 +571,9 @@ void integrate_vv(int n_steps)
 #endif
 
 #ifdef BOND_CONSTRAINT
-    ghost_communicator(&cell_structure.update_ghost_pos_comm);
     correct_vel_shake();
 #endif
 
-//VIRTUAL_SITES update vel
-#ifdef VIRTUAL_SITES
-   ghost_communicator(&cell_structure.update_ghost_pos_comm);
-   update_mol_vel();
-   if (check_runtime_errors()) break;
-#endif
-
 #ifdef ELECTROSTATICS
     if(coulomb.method == COULOMB_MAGGS) {
       propagate_B_field(0.5*time_step); 
@@ -557,10 +595,27 @@ void integrate_vv(int n_steps)
     if(this_node==0) sim_time += time_step;
   }
 
+//VIRTUAL_SITES update vel
+#ifdef VIRTUAL_SITES
+  /* during the integration, the velocities of the virtual sites are
+     only needed for the force calculation, and are recalculated by
+     update_mol_vel_pos() before. Update them once for the observables. */
+  ghost_communicator(&cell_structure.update_ghost_pos_comm);
+  update_mol_vel();
+#endif
+
   /* after simulating the forces are necessarily set. Necessary since
      resort_particles sets recalc_forces to 1 */
   recalc_forces = 0;
 
+  /* the velocities are final now, complete the observables */
+  if (i == n_steps && n_steps > 0) {
+    if (observables & FUSED_OBS_ENERGY)
+      fused_energy_finish();
+    if (observables & FUSED_OBS_PRESSURE)
+      fused_pressure_finish();
+  }
+
   /* verlet list statistics */
   if(n_verlet_updates>0) verlet_reuse = n_steps/(double) n_verlet_updates;
   else verlet_reuse = 0;
@@ -621,12 +676,6 @@ int time_step_callback(Tcl_Interp *interp, void *_data)
     Tcl_AppendResult(interp, "time step must be positive.", (char *) NULL);
     return (TCL_ERROR);
   }
-#ifdef LB
-  else if ((lbpar.tau >= 0.0) && (data > lbpar.tau)) {
-    Tcl_AppendResult(interp, "MD time step must be smaller than LB time step.", (char *)NULL);
-    return (TCL_ERROR);
-  }
-#endif
   mpi_set_time_step(data);
 
   return (TCL_OK);
@@ -701,7 +750,7 @@ void rescale_forces_propagate_vel()
 #endif
       for(j = 0; j < 3 ; j++) {
 #ifdef EXTERNAL_FORCES
-	if (!(p[i].l.ext_flag & COORD_FIXED(j))) {
+	if (!(p[i].p.ext_flag & COORD_FIXED(j))) {
 #endif
 #ifdef NPT
 	  if(integ_switch == INTEG_METHOD_NPT_ISO && ( nptiso.geometry & nptiso.nptgeom_dir[j] )) {
@@ -795,7 +844,7 @@ void propagate_press_box_pos_and_rescale_npt()
 #endif
        for(j=0; j < 3; j++){
 #ifdef EXTERNAL_FORCES
-	if (!(p[i].l.ext_flag & COORD_FIXED(j))) {
+	if (!(p[i].p.ext_flag & COORD_FIXED(j))) {
 #endif	    
 	  if(nptiso.geometry & nptiso.nptgeom_dir[j]) {
 	    p[i].r.p[j]      = scal[1]*(p[i].r.p[j] + scal[2]*p[i].m.v[j]);
@@ -862,7 +911,7 @@ void propagate_vel()
 #endif
       for(j=0; j < 3; j++){
 #ifdef EXTERNAL_FORCES
-	if (!(p[i].l.ext_flag & COORD_FIXED(j)))	
+	if (!(p[i].p.ext_flag & COORD_FIXED(j)))	
 #endif
 	  {
 #ifdef NPT
@@ -925,7 +974,7 @@ void propagate_pos()
 #endif
 	for(j=0; j < 3; j++){
 #ifdef EXTERNAL_FORCES
-	  if (!(p[i].l.ext_flag & COORD_FIXED(j)))
+	  if (!(p[i].p.ext_flag & COORD_FIXED(j)))
 #endif
 	    {
 #ifdef NEMD
@@ -964,7 +1013,7 @@ void propagate_vel_pos()
 #endif
      for(j=0; j < 3; j++){
 #ifdef EXTERNAL_FORCES
-	if (!(p[i].l.ext_flag & COORD_FIXED(j)))
+	if (!(p[i].p.ext_flag & COORD_FIXED(j)))
 #endif
 	  {
 	    /* Propagate velocities: v(t+0.5*dt) = v(t) + 0.5*dt * f(t) */
@@ -994,6 +1043,63 @@ void propagate_vel_pos()
 #endif
 }
 
+void propagate_vel_pos_baoab()
+{
+  Cell *cell;
+  Particle *p;
+  int c, i, j, np;
+  double noise[4], pref;
+
+  INTEG_TRACE(fprintf(stderr,"%d: propagate_vel_pos_baoab:\n",this_node));
+
+  rebuild_verletlist = 0;
+
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for(i = 0; i < np; i++) {
+#ifdef VIRTUAL_SITES
+      if (ifParticleIsVirtual(&p[i])) continue;
+#endif
+      pref = langevin_baoab_pref/sqrt(PMASS(p[i]));
+      if (counter_rng_seed)
+	c_random4(p[i].p.identity, 0, COUNTER_RNG_LANGEVIN, noise);
+      for(j=0; j < 3; j++){
+#ifdef EXTERNAL_FORCES
+	if (!(p[i].p.ext_flag & COORD_FIXED(j)))
+#endif
+	  {
+	    /* B: half kick, A: half drift */
+	    p[i].m.v[j] += p[i].f.f[j];
+	    p[i].r.p[j] += 0.5*p[i].m.v[j];
+	    /* O: friction and noise */
+	    p[i].m.v[j] = langevin_baoab_c1*p[i].m.v[j] +
+	      pref*((counter_rng_seed ? noise[j] : d_random()) - 0.5);
+	    /* A: half drift */
+	    p[i].r.p[j] += 0.5*p[i].m.v[j];
+	  }
+      }
+
+      ONEPART_TRACE(if(p[i].p.identity==check_id) fprintf(stderr,"%d: OPT: PV_1 v_new = (%.3e,%.3e,%.3e)\n",this_node,p[i].m.v[0],p[i].m.v[1],p[i].m.v[2]));
+      ONEPART_TRACE(if(p[i].p.identity==check_id) fprintf(stderr,"%d: OPT: PPOS p = (%.3f,%.3f,%.3f)\n",this_node,p[i].r.p[0],p[i].r.p[1],p[i].r.p[2]));
+
+#ifdef ADDITIONAL_CHECKS
+      force_and_velocity_check(&p[i]);
+#endif
+
+      /* Verlet criterion check */
+      if(distance2(p[i].r.p,p[i].l.p_old) > skin2 ) rebuild_verletlist = 1;
+    }
+  }
+
+  if(dd.use_vList) announce_rebuild_vlist();
+
+#ifdef ADDITIONAL_CHECKS
+  force_and_velocity_display();
+#endif
+}
+
 void force_and_velocity_check(Particle *p)
 {
 #ifdef ADDITIONAL_CHECKS
@@ -81,8 +81,11 @@ void integrate_ensemble_init();
 
 /** integrate with velocity verlet integrator.
     \param n_steps number of steps to integrate.
+    \param observables combination of FUSED_OBS_* flags (see \ref forces.h);
+    these observables are calculated along with the forces of the last
+    step and can afterwards be analyzed without a further calculation.
  */
-void integrate_vv(int n_steps);
+void integrate_vv(int n_steps, int observables);
 
 /** function that rescales all velocities on one node according to a
     new time step. */
@@ -98,6 +98,8 @@ Constraint *constraints = NULL;
 DoubleList tabulated_forces;
 /** Corresponding array containing all tabulated energies*/
 DoubleList tabulated_energies;
+/** Spline coefficients of the tabulated forces and energies*/
+DoubleList tabulated_splines;
 
 #ifdef ADRESS
 #ifdef INTERFACE_CORRECTION
@@ -129,8 +131,62 @@ int printDipolarIAToResult(Tcl_Interp *interp);
 void force_and_energy_tables_init() {
   init_doublelist(&tabulated_forces);
   init_doublelist(&tabulated_energies);
+  init_doublelist(&tabulated_splines);
 }
 
+#ifdef TABULATED
+/** Slope of the tabulated values g[0]...g[n-1] at entry i, times the
+    step size, from fourth order finite differences. */
+static double tabulated_slope(double *g, int n, int i)
+{
+  if (n < 5) {
+    if (i == 0)   return g[1] - g[0];
+    if (i == n-1) return g[n-1] - g[n-2];
+    return 0.5*(g[i+1] - g[i-1]);
+  }
+  if (i == 0)   return (-25*g[0] + 48*g[1] - 36*g[2] + 16*g[3] - 3*g[4])/12;
+  if (i == 1)   return (-3*g[0] - 10*g[1] + 18*g[2] - 6*g[3] + g[4])/12;
+  if (i == n-2) return (3*g[n-1] + 10*g[n-2] - 18*g[n-3] + 6*g[n-4] - g[n-5])/12;
+  if (i == n-1) return (25*g[n-1] - 48*g[n-2] + 36*g[n-3] - 16*g[n-4] + 3*g[n-5])/12;
+  return (g[i-2] - 8*g[i-1] + 8*g[i+1] - g[i+2])/12;
+}
+
+void tabulated_calc_splines(IA_parameters *data)
+{
+  int i, n = data->TAB_npoints, start = data->TAB_startindex;
+  double h = data->TAB_stepsize;
+  double *g, *v, *c, s0, s1, m0, m1;
+
+  if (tabulated_splines.max < 8*tabulated_forces.max)
+    realloc_doublelist(&tabulated_splines, 8*tabulated_forces.max);
+
+  g = &tabulated_forces.e[start];
+  v = &tabulated_energies.e[start];
+  for (i = 0; i < n - 1; i++) {
+    c = &tabulated_splines.e[8*(start + i)];
+    /* slopes times the step size */
+    s0 = tabulated_slope(g, n, i);
+    s1 = tabulated_slope(g, n, i + 1);
+    m0 = -h*(data->TAB_minval + i*h)*g[i];
+    m1 = -h*(data->TAB_minval + (i+1)*h)*g[i+1];
+
+    c[0] = g[i];
+    c[1] = s0;
+    c[2] = 3*(g[i+1] - g[i]) - 2*s0 - s1;
+    c[3] = 2*(g[i] - g[i+1]) + s0 + s1;
+    c[4] = v[i];
+    c[5] = m0;
+    c[6] = 3*(v[i+1] - v[i]) - 2*m0 - m1;
+    c[7] = 2*(v[i] - v[i+1]) + m0 + m1;
+  }
+  /* the last entry is only reached by rounding */
+  c = &tabulated_splines.e[8*(start + n - 1)];
+  c[0] = g[n-1];
+  c[4] = v[n-1];
+  c[1] = c[2] = c[3] = c[5] = c[6] = c[7] = 0;
+}
+#endif
+
 #ifdef ADRESS
 #ifdef INTERFACE_CORRECTION
 /** Initialize adress force and energy tables */
@@ -152,6 +208,8 @@ void tf_tables_init() {
 
 /** Initialize interaction parameters. */
 void initialize_ia_params(IA_parameters *params) {
+  params->pair_pots = 0;
+
 #ifdef LENNARD_JONES
 	params->LJ_eps =
 		params->LJ_sig =
@@ -284,6 +342,7 @@ void initialize_ia_params(IA_parameters *params) {
   params->TAB_maxval = 0.0;
   params->TAB_maxval2 = 0.0;
   params->TAB_stepsize = 0.0;
+  params->TAB_spline = 0;
   strcpy(params->TAB_filename,"");
 #endif
 
@@ -363,6 +422,8 @@ void initialize_tf_params(TF_parameters *params){
 
 /** Copy interaction parameters. */
 void copy_ia_params(IA_parameters *dst, IA_parameters *src) {
+  dst->pair_pots = src->pair_pots;
+
 #ifdef LENNARD_JONES
   dst->LJ_eps = src->LJ_eps;
   dst->LJ_sig = src->LJ_sig;
@@ -495,6 +556,7 @@ void copy_ia_params(IA_parameters *dst, IA_parameters *src) {
   dst->TAB_maxval = src->TAB_maxval;
   dst->TAB_maxval2 = src->TAB_maxval2;
   dst->TAB_stepsize = src->TAB_stepsize;
+  dst->TAB_spline = src->TAB_spline;
   strcpy(dst->TAB_filename,src->TAB_filename);
 #endif
 
@@ -669,6 +731,81 @@ if (data->TUNABLE_SLIP_r_cut != 0)
   return 0;
 }
 
+void calc_pair_potentials()
+{
+  int i, j, pots;
+  IA_parameters *data;
+
+  for (i = 0; i < n_particle_types; i++)
+    for (j = 0; j < n_particle_types; j++) {
+      data = get_ia_param(i, j);
+      pots = 0;
+#ifdef LENNARD_JONES
+      if (data->LJ_cut != 0)
+	pots |= PAIR_POT_LJ;
+#endif
+#ifdef LENNARD_JONES_GENERIC
+      if (data->LJGEN_cut != 0)
+	pots |= PAIR_POT_LJGEN;
+#endif
+#ifdef LJ_ANGLE
+      if (data->LJANGLE_cut != 0)
+	pots |= PAIR_POT_LJANGLE;
+#endif
+#ifdef SMOOTH_STEP
+      if (data->SmSt_cut != 0)
+	pots |= PAIR_POT_SMST;
+#endif
+#ifdef HERTZIAN
+      if (data->Hertzian_sig != 0)
+	pots |= PAIR_POT_HERTZIAN;
+#endif
+#ifdef BMHTF_NACL
+      if (data->BMHTF_cut != 0)
+	pots |= PAIR_POT_BMHTF;
+#endif
+#ifdef BUCKINGHAM
+      if (data->BUCK_cut != 0)
+	pots |= PAIR_POT_BUCK;
+#endif
+#ifdef MORSE
+      if (data->MORSE_cut != 0)
+	pots |= PAIR_POT_MORSE;
+#endif
+#ifdef SOFT_SPHERE
+      if (data->soft_cut != 0)
+	pots |= PAIR_POT_SOFT;
+#endif
+#ifdef LJCOS
+      if (data->LJCOS_cut != 0)
+	pots |= PAIR_POT_LJCOS;
+#endif
+#ifdef LJCOS2
+      if (data->LJCOS2_cut != 0)
+	pots |= PAIR_POT_LJCOS2;
+#endif
+#ifdef TABULATED
+      if (data->TAB_maxval != 0)
+	pots |= PAIR_POT_TAB;
+#endif
+#ifdef GAY_BERNE
+      if (data->GB_cut != 0)
+	pots |= PAIR_POT_GB;
+#endif
+#ifdef INTER_RF
+      if (data->rf_on == 1)
+	pots |= PAIR_POT_INTER_RF;
+#endif
+#ifdef ADRESS
+#ifdef INTERFACE_CORRECTION
+      if (data->ADRESS_TAB_maxval != 0)
+	pots |= PAIR_POT_ADRESS_TAB;
+#endif
+#endif
+      data->pair_pots = pots;
+    }
+}
+
 #ifdef ADRESS
 /** #ifdef THERMODYNAMIC_FORCE */
 int checkIfTF(TF_parameters *data){
@@ -1635,8 +1772,11 @@ int printNonbondedIAToResult(Tcl_Interp *interp, int i, int j)
   if (data->GB_cut != 0) printgbIAToResult(interp,i,j);
 #endif
 #ifdef TABULATED
-  if (data->TAB_maxval != 0)
+  if (data->TAB_maxval != 0) {
     Tcl_AppendResult(interp, "tabulated \"", data->TAB_filename,"\"", (char *) NULL);
+    if (data->TAB_spline)
+      Tcl_AppendResult(interp, " spline", (char *) NULL);
+  }
 #endif
 #ifdef ADRESS
 #ifdef INTERFACE_CORRECTION
@@ -129,6 +129,30 @@
 #endif 
 
 
+/** \name Flags for the non-bonded pair potentials
+    Bits of \ref IA_parameters::pair_pots, which flag the potentials
+    that are switched on for a pair of particle types.
+*/
+/************************************************************/
+/*@{*/
+
+#define PAIR_POT_LJ         (1 << 0)
+#define PAIR_POT_LJGEN      (1 << 1)
+#define PAIR_POT_LJANGLE    (1 << 2)
+#define PAIR_POT_SMST       (1 << 3)
+#define PAIR_POT_HERTZIAN   (1 << 4)
+#define PAIR_POT_BMHTF      (1 << 5)
+#define PAIR_POT_BUCK       (1 << 6)
+#define PAIR_POT_MORSE      (1 << 7)
+#define PAIR_POT_SOFT       (1 << 8)
+#define PAIR_POT_LJCOS      (1 << 9)
+#define PAIR_POT_LJCOS2     (1 << 10)
+#define PAIR_POT_TAB        (1 << 11)
+#define PAIR_POT_GB         (1 << 12)
+#define PAIR_POT_INTER_RF   (1 << 13)
+#define PAIR_POT_ADRESS_TAB (1 << 14)
+
+/*@}*/
 
 /** \name Type codes for constraints
     Enumeration of implemented constraint types.
@@ -167,6 +191,12 @@
  *  nonbonded interactions. Access via
  * get_ia_param(i, j), i,j < n_particle_types */
 typedef struct {
+  /** The pair potentials switched on for this pair of types, a
+      combination of the PAIR_POT_* flags. Set by \ref
+      calc_pair_potentials, so that the force and energy calculation
+      can skip all other potentials. */
+  int pair_pots;
+
 #ifdef LENNARD_JONES
 	/** \name Lennard-Jones with shift */
 	/*@{*/
@@ -340,6 +370,9 @@ typedef struct {
   double TAB_maxval;
   double TAB_maxval2;
   double TAB_stepsize;
+  /** If non-zero, interpolate by cubic splines from \ref tabulated_splines
+      instead of linearly. */
+  int TAB_spline;
   /** The maximum allowable filename length for a tabulated potential file*/
 #define MAXLENGTH_TABFILE_NAME 256
   char TAB_filename[MAXLENGTH_TABFILE_NAME];
@@ -731,6 +764,9 @@ extern Bonded_ia_parameters *bonded_ia_params;
 extern DoubleList tabulated_forces;
 /** Array containing all tabulated energies*/
 extern DoubleList tabulated_energies;
+/** Cubic spline coefficients of the tabulated forces and energies,
+    8 per table entry, see \ref tabulated_calc_splines. */
+extern DoubleList tabulated_splines;
 
 #ifdef ADRESS
 #ifdef INTERFACE_CORRECTION
@@ -801,6 +837,20 @@ extern int ia_excl;
 /** Function for initializing force and energy tables */
 void force_and_energy_tables_init();
 
+#ifdef TABULATED
+/** Calculate the spline coefficients of the force and energy table of
+    a tabulated non-bonded interaction. For each table entry i, the
+    coefficients of the force factor and the energy in the interval
+    from i to i+1 are stored next to each other at \ref
+    tabulated_splines.e[8*i], so that a lookup touches only one cache
+    line. The splines are cubic Hermite interpolants which go through
+    the table values. The slopes of the energy are given by the force
+    table, the slopes of the force factor are fourth order finite
+    differences. The table needs at least two points, which is
+    checked by \ref tabulated_set_params. */
+void tabulated_calc_splines(IA_parameters *data);
+#endif
+
 #ifdef ADRESS
 #ifdef INTERFACE_CORRECTION
 /** Function for initializing adress force and energy tables */
@@ -877,6 +927,11 @@ int check_obs_calc_initialized();
 /**  check if a non bonded interaction is defined */
 int checkIfInteraction(IA_parameters *data);
 
+/** Set \ref IA_parameters::pair_pots for all pairs of particle types
+    from the cutoffs of the pair potentials. Called whenever the
+    maximal cutoff is recalculated. */
+void calc_pair_potentials();
+
 /** check if the types of particles i and j have any non bonded
     interaction defined. */
 MDINLINE int checkIfParticlesInteract(int i, int j) {
@@ -541,7 +541,7 @@ void layered_exchange_and_sort_particles(int global_flag)
   realloc_particlelist(&recv_buf, 0);
 }
 
-/** nonbonded and bonded force calculation using the verlet list */
+/** nonbonded force calculation (and constraints) using the verlet list */
 void layered_calculate_ia()
 {
   int c, i, j;
@@ -567,7 +567,6 @@ void layered_calculate_ia()
       if (rebuild_verletlist)
 	memcpy(p1->l.p_old, p1->r.p, 3*sizeof(double));
 
-      add_bonded_force(p1);
 #ifdef CONSTRAINTS
       add_constraints_forces(p1);
 #endif
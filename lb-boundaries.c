@@ -28,31 +28,129 @@
 #ifdef LB
 #ifdef CONSTRAINTS
 
-/** Initialize a planar boundary specified by a wall constraint.
- * @param plane The \ref Constraint_wall struct describing the boundary.
+/** Number of bounce back links on this node. */
+static int n_bounce_back_links = 0;
+
+/** Bounce back links as pairs of population indices (target in the
+ *  fluid site, source in the boundary site) into the population array. */
+static int *bounce_back_links = NULL;
+
+/** Check whether a given position lies inside of a constraint.
+ * @param pos  folded position (Input).
+ * @param con  the \ref Constraint struct.
+ * @return 1 if the position belongs to the constraint, 0 otherwise.
  */
-static void lb_init_constraint_wall(Constraint_wall* plane) {
+static int lb_position_in_constraint(double pos[3], Constraint *con) {
+
+  double dist, vec[3];
+
+  switch (con->type) {
+  case CONSTRAINT_WAL:
+    /* walls are represented by a single layer of boundary sites */
+    calculate_wall_dist(NULL, pos, NULL, &con->c.wal, &dist, vec);
+    return (fabs(dist) < lblattice.agrid);
+  case CONSTRAINT_SPH:
+    calculate_sphere_dist(NULL, pos, NULL, &con->c.sph, &dist, vec);
+    break;
+  case CONSTRAINT_CYL:
+    calculate_cylinder_dist(NULL, pos, NULL, &con->c.cyl, &dist, vec);
+    break;
+  case CONSTRAINT_MAZE:
+    calculate_maze_dist(NULL, pos, NULL, &con->c.maze, &dist, vec);
+    break;
+  case CONSTRAINT_PORE:
+    calculate_pore_dist(NULL, pos, NULL, &con->c.pore, &dist, vec);
+    break;
+  default:
+    /* constraints without volume don't affect the fluid */
+    return 0;
+  }
+
+  return (dist <= 0.0);
+
+}
+
+/** Mark all sites (halo included) which are covered by a constraint. */
+static void lb_rasterize_constraints() {
 
-  int x, y, z;
-  double pos[3], dist;
+  int x, y, z, n, index, img[3];
+  double pos[3];
 
-  for (x=0;x<lblattice.halo_grid[0];x++) {
+  index = 0;
+  for (z=0;z<lblattice.halo_grid[2];z++) {
     for (y=0;y<lblattice.halo_grid[1];y++) {
-      for (z=0;z<lblattice.halo_grid[2];z++) {
+      for (x=0;x<lblattice.halo_grid[0];x++) {
 
 	pos[0] = my_left[0] + (x-1)*lblattice.agrid;
 	pos[1] = my_left[1] + (y-1)*lblattice.agrid;
 	pos[2] = my_left[2] + (z-1)*lblattice.agrid;
+	img[0] = img[1] = img[2] = 0;
+	fold_position(pos, img);
+
+	lbfluid[index].boundary = 0;
+	for (n=0;n<n_constraints;n++) {
+	  if (lb_position_in_constraint(pos, &constraints[n])) {
+	    lbfluid[index].boundary = 1;
+	    break;
+	  }
+	}
+
+	++index;
+      }
+    }
+  }
+
+}
 
-	dist = scalar(pos,plane->n) - plane->d;
+/** Set up the list of bounce back links. A link exists for every
+ *  velocity pointing from a local fluid site to a boundary site. */
+static void lb_init_bounce_back_links() {
+
+  int x, y, z, i, j, index, next, max_links;
+  int n_veloc = lbmodel.n_veloc;
+  int yperiod = lblattice.halo_grid[0];
+  int zperiod = lblattice.halo_grid[0]*lblattice.halo_grid[1];
+  double (*c)[3] = lbmodel.c;
+  int reverse[n_veloc];
+
+  for (i=0;i<n_veloc;i++) {
+    for (j=0;j<n_veloc;j++) {
+      if (c[j][0]==-c[i][0] && c[j][1]==-c[i][1] && c[j][2]==-c[i][2]) {
+	reverse[i] = j;
+	break;
+      }
+    }
+  }
 
-	if (fabs(dist) < lblattice.agrid) {
-	  //printf("%d %d %d\n",x,y,z);
-	  lbfluid[get_linear_index(x,y,z,lblattice.halo_grid)].boundary = 1;
+  /* count the links first to allocate the list in one go */
+  max_links = 0;
+  for (index=0;index<lblattice.halo_grid_volume;index++) {
+    if (lbfluid[index].boundary) max_links += n_veloc;
+  }
+  bounce_back_links = realloc(bounce_back_links, 2*max_links*sizeof(int));
+
+  n_bounce_back_links = 0;
+  index = lblattice.halo_offset;
+  for (z=1;z<=lblattice.grid[2];z++) {
+    for (y=1;y<=lblattice.grid[1];y++) {
+      for (x=1;x<=lblattice.grid[0];x++) {
+
+	if (!lbfluid[index].boundary) {
+	  for (i=1;i<n_veloc;i++) {
+	    next = index + (int)c[i][0] + yperiod*(int)c[i][1] + zperiod*(int)c[i][2];
+	    if (lbfluid[next].boundary) {
+	      bounce_back_links[2*n_bounce_back_links]   = index*n_veloc + reverse[i];
+	      bounce_back_links[2*n_bounce_back_links+1] = next*n_veloc + i;
+	      ++n_bounce_back_links;
+	    }
+	  }
 	}
 
+	++index;
       }
+      index += 2;
     }
+    index += 2*lblattice.halo_grid[0];
   }
 
 }
@@ -60,22 +158,28 @@ static void lb_init_constraint_wall(Constraint_wall* plane) {
 /** Initialize boundary conditions for all constraints in the system. */
 void lb_init_constraints() {
 
-  int n;
-  char *errtxt;
+  lb_rasterize_constraints();
 
-  for (n=0;n<lblattice.halo_grid_volume;n++) {
-    lbfluid[n].boundary = 0;
-  }
+  lb_init_bounce_back_links();
 
-  for (n=0;n<n_constraints;n++) {
-    switch (constraints[n].type) {
-    case CONSTRAINT_WAL:
-      lb_init_constraint_wall(&constraints[n].c.wal);
-      break;
-    default:
-      errtxt = runtime_error(128);
-      ERROR_SPRINTF(errtxt, "{109 constraint type %d not implemented in lb_init_constraints()\n",constraints[n].type);
-    }
+}
+
+/** Release the bounce back link list. */
+void lb_release_constraints() {
+  free(bounce_back_links);
+  bounce_back_links = NULL;
+  n_bounce_back_links = 0;
+}
+
+/** Apply bounce back boundary conditions on all links. */
+void lb_boundary_conditions() {
+
+  int k;
+  double *n = lbfluid[0].n;
+
+  for (k=0;k<n_bounce_back_links;k++) {
+    n[bounce_back_links[2*k]] = n[bounce_back_links[2*k+1]];
+    n[bounce_back_links[2*k+1]] = 0.0;
   }
 
 }
@@ -74,6 +74,62 @@ static double d3q19_w[19] = { 1./3.,
 			      1./36., 1./36., 1./36., 1./36.,
 			      1./36., 1./36., 1./36., 1./36. };
 
+/** Transformation of the D3Q19 populations into moment space.
+ *  Row i holds the basis polynomials of all modes evaluated on the
+ *  velocity i, i.e. the modes are \f$m_k = \sum_i e_{ik} n_i\f$. The modes
+ *  are mass, momentum (3), bulk and shear stress (6) and the kinetic or
+ *  ghost modes (9). The basis is orthogonal with respect to \ref d3q19_w.
+ *  See Table I in Duenweg, Schiller and Ladd, PRE 76, 036704 (2007).
+ */
+static const double d3q19_modebase[19][19] = {
+  {   1.,   0.,   0.,   0.,  -1.,   0.,   0.,   0.,   0.,   0.,   0.,   0.,   0.,   0.,   0.,   0.,   1.,   0.,   0. },
+  {   1.,   1.,   0.,   0.,   0.,   1.,   1.,   0.,   0.,   0.,  -2.,   0.,   0.,   0.,   0.,   0.,  -2.,  -1.,  -1. },
+  {   1.,  -1.,   0.,   0.,   0.,   1.,   1.,   0.,   0.,   0.,   2.,   0.,   0.,   0.,   0.,   0.,  -2.,  -1.,  -1. },
+  {   1.,   0.,   1.,   0.,   0.,  -1.,   1.,   0.,   0.,   0.,   0.,  -2.,   0.,   0.,   0.,   0.,  -2.,   1.,  -1. },
+  {   1.,   0.,  -1.,   0.,   0.,  -1.,   1.,   0.,   0.,   0.,   0.,   2.,   0.,   0.,   0.,   0.,  -2.,   1.,  -1. },
+  {   1.,   0.,   0.,   1.,   0.,   0.,  -2.,   0.,   0.,   0.,   0.,   0.,  -2.,   0.,   0.,   0.,  -2.,   0.,   2. },
+  {   1.,   0.,   0.,  -1.,   0.,   0.,  -2.,   0.,   0.,   0.,   0.,   0.,   2.,   0.,   0.,   0.,  -2.,   0.,   2. },
+  {   1.,   1.,   1.,   0.,   1.,   0.,   2.,   1.,   0.,   0.,   1.,   1.,   0.,   1.,   1.,   0.,   1.,   0.,   2. },
+  {   1.,  -1.,  -1.,   0.,   1.,   0.,   2.,   1.,   0.,   0.,  -1.,  -1.,   0.,  -1.,  -1.,   0.,   1.,   0.,   2. },
+  {   1.,   1.,  -1.,   0.,   1.,   0.,   2.,  -1.,   0.,   0.,   1.,  -1.,   0.,   1.,  -1.,   0.,   1.,   0.,   2. },
+  {   1.,  -1.,   1.,   0.,   1.,   0.,   2.,  -1.,   0.,   0.,  -1.,   1.,   0.,  -1.,   1.,   0.,   1.,   0.,   2. },
+  {   1.,   1.,   0.,   1.,   1.,   1.,  -1.,   0.,   1.,   0.,   1.,   0.,   1.,  -1.,   0.,   1.,   1.,   1.,  -1. },
+  {   1.,  -1.,   0.,  -1.,   1.,   1.,  -1.,   0.,   1.,   0.,  -1.,   0.,  -1.,   1.,   0.,  -1.,   1.,   1.,  -1. },
+  {   1.,   1.,   0.,  -1.,   1.,   1.,  -1.,   0.,  -1.,   0.,   1.,   0.,  -1.,  -1.,   0.,  -1.,   1.,   1.,  -1. },
+  {   1.,  -1.,   0.,   1.,   1.,   1.,  -1.,   0.,  -1.,   0.,  -1.,   0.,   1.,   1.,   0.,   1.,   1.,   1.,  -1. },
+  {   1.,   0.,   1.,   1.,   1.,  -1.,  -1.,   0.,   0.,   1.,   0.,   1.,   1.,   0.,  -1.,  -1.,   1.,  -1.,  -1. },
+  {   1.,   0.,  -1.,  -1.,   1.,  -1.,  -1.,   0.,   0.,   1.,   0.,  -1.,  -1.,   0.,   1.,   1.,   1.,  -1.,  -1. },
+  {   1.,   0.,   1.,  -1.,   1.,  -1.,  -1.,   0.,   0.,  -1.,   0.,   1.,  -1.,   0.,  -1.,   1.,   1.,  -1.,  -1. },
+  {   1.,   0.,  -1.,   1.,   1.,  -1.,  -1.,   0.,   0.,  -1.,   0.,  -1.,   1.,   0.,   1.,  -1.,   1.,  -1.,  -1. } };
+
+/** Norms \f$b_k = \sum_i w_i e_{ik}^2\f$ of the D3Q19 modes. */
+static const double d3q19_mode_norm[19] = { 1., 1./3., 1./3., 1./3., 2./3., 4./9., 4./3., 1./9., 1./9., 1./9., 2./3., 2./3., 2./3., 2./9., 2./9., 2./9., 2., 4./9., 4./3. };
+
+/** Back transformation of the D3Q19 modes into populations.
+ *  Row k holds \f$w_i e_{ik} / b_k\f$, such that the populations are
+ *  \f$n_i = \sum_k \mathrm{d3q19\_modebase\_inv}[k][i] m_k\f$.
+ */
+static const double d3q19_modebase_inv[19][19] = {
+  {   1./3.,  1./18.,  1./18.,  1./18.,  1./18.,  1./18.,  1./18.,  1./36.,  1./36.,  1./36.,  1./36.,  1./36.,  1./36.,  1./36.,  1./36.,  1./36.,  1./36.,  1./36.,  1./36. },
+  {      0.,   1./6.,  -1./6.,      0.,      0.,      0.,      0.,  1./12., -1./12.,  1./12., -1./12.,  1./12., -1./12.,  1./12., -1./12.,      0.,      0.,      0.,      0. },
+  {      0.,      0.,      0.,   1./6.,  -1./6.,      0.,      0.,  1./12., -1./12., -1./12.,  1./12.,      0.,      0.,      0.,      0.,  1./12., -1./12.,  1./12., -1./12. },
+  {      0.,      0.,      0.,      0.,      0.,   1./6.,  -1./6.,      0.,      0.,      0.,      0.,  1./12., -1./12., -1./12.,  1./12.,  1./12., -1./12., -1./12.,  1./12. },
+  {  -1./2.,      0.,      0.,      0.,      0.,      0.,      0.,  1./24.,  1./24.,  1./24.,  1./24.,  1./24.,  1./24.,  1./24.,  1./24.,  1./24.,  1./24.,  1./24.,  1./24. },
+  {      0.,   1./8.,   1./8.,  -1./8.,  -1./8.,      0.,      0.,      0.,      0.,      0.,      0.,  1./16.,  1./16.,  1./16.,  1./16., -1./16., -1./16., -1./16., -1./16. },
+  {      0.,  1./24.,  1./24.,  1./24.,  1./24., -1./12., -1./12.,  1./24.,  1./24.,  1./24.,  1./24., -1./48., -1./48., -1./48., -1./48., -1./48., -1./48., -1./48., -1./48. },
+  {      0.,      0.,      0.,      0.,      0.,      0.,      0.,   1./4.,   1./4.,  -1./4.,  -1./4.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0. },
+  {      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,   1./4.,   1./4.,  -1./4.,  -1./4.,      0.,      0.,      0.,      0. },
+  {      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,   1./4.,   1./4.,  -1./4.,  -1./4. },
+  {      0.,  -1./6.,   1./6.,      0.,      0.,      0.,      0.,  1./24., -1./24.,  1./24., -1./24.,  1./24., -1./24.,  1./24., -1./24.,      0.,      0.,      0.,      0. },
+  {      0.,      0.,      0.,  -1./6.,   1./6.,      0.,      0.,  1./24., -1./24., -1./24.,  1./24.,      0.,      0.,      0.,      0.,  1./24., -1./24.,  1./24., -1./24. },
+  {      0.,      0.,      0.,      0.,      0.,  -1./6.,   1./6.,      0.,      0.,      0.,      0.,  1./24., -1./24., -1./24.,  1./24.,  1./24., -1./24., -1./24.,  1./24. },
+  {      0.,      0.,      0.,      0.,      0.,      0.,      0.,   1./8.,  -1./8.,   1./8.,  -1./8.,  -1./8.,   1./8.,  -1./8.,   1./8.,      0.,      0.,      0.,      0. },
+  {      0.,      0.,      0.,      0.,      0.,      0.,      0.,   1./8.,  -1./8.,  -1./8.,   1./8.,      0.,      0.,      0.,      0.,  -1./8.,   1./8.,  -1./8.,   1./8. },
+  {      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,      0.,   1./8.,  -1./8.,  -1./8.,   1./8.,  -1./8.,   1./8.,   1./8.,  -1./8. },
+  {   1./6., -1./18., -1./18., -1./18., -1./18., -1./18., -1./18.,  1./72.,  1./72.,  1./72.,  1./72.,  1./72.,  1./72.,  1./72.,  1./72.,  1./72.,  1./72.,  1./72.,  1./72. },
+  {      0.,  -1./8.,  -1./8.,   1./8.,   1./8.,      0.,      0.,      0.,      0.,      0.,      0.,  1./16.,  1./16.,  1./16.,  1./16., -1./16., -1./16., -1./16., -1./16. },
+  {      0., -1./24., -1./24., -1./24., -1./24.,  1./12.,  1./12.,  1./24.,  1./24.,  1./24.,  1./24., -1./48., -1./48., -1./48., -1./48., -1./48., -1./48., -1./48., -1./48. } };
+
 LB_Model d3q19_model = { 19, d3q19_lattice, d3q19_coefficients, d3q19_w, 1./3. };
 
 #endif /* LB */
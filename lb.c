@@ -46,8 +46,12 @@
 /** Flag indicating momentum exchange between particles and fluid */
 int transfer_momentum = 0;
 
+/** Flag indicating that the fluid fields used for the particle coupling
+ *  have to be recalculated */
+int update_fluid_fields = 1;
+
 /** Struct holding the Lattice Boltzmann parameters */
-LB_Parameters lbpar = { 0.0, 0.0, -1.0, -1.0, -1.0, 0.0, { 0.0, 0.0, 0.0} };
+LB_Parameters lbpar = { 0.0, 0.0, -1.0, -1.0, -1.0, 0.0, { 0.0, 0.0, 0.0}, 0, 0.0, 0.0 };
 
 /** The DnQm model to be used. */
 LB_Model lbmodel = { 19, d3q19_lattice, d3q19_coefficients, d3q19_w, 1./3. };
@@ -65,9 +69,24 @@ LB_FluidNode *lbfluid=NULL;
 /** Communicator for halo exchange between processors */
 HaloCommunicator update_halo_comm = { 0, NULL };
 
+/** Communicator for the halo exchange before the streaming step.
+ *  Only the populations streaming into the local domain are exchanged. */
+static HaloCommunicator stream_halo_comm = { 0, NULL };
+
 /** The number of field variables on a local lattice site (counted in doubles). */
 static int n_fields;
 
+/** Number of local fluid sites (halo and boundary sites excluded). */
+static int n_fluid_sites = 0;
+
+/** Number of local fluid sites on the border of the local domain. */
+static int n_border_sites = 0;
+
+/** Linear indices of the local fluid sites, the sites on the border
+ *  of the local domain first, each part in ascending order.
+ *  Loops over the fluid only visit these sites. */
+static int *fluid_sites = NULL;
+
 /** \name Derived parameters */
 /*@{*/
 /** Flag indicating whether fluctuations are present. */
@@ -80,6 +99,12 @@ static double lblambda_bulk = -1;
 static double lb_fluct_pref = 0.0;
 /** amplitude of the bulk fluctuations of the stress tensor */
 static double lb_fluct_pref_bulk = 0.0;
+#ifdef D3Q19
+/** relaxation factors of the modes for the MRT collision */
+static double lb_gamma[19];
+/** amplitudes of the mode fluctuations for the MRT collision */
+static double lb_phi[19];
+#endif
 /** amplitude of the fluctuations in the viscous coupling */
 static double lb_coupl_pref;
 /*@}*/
@@ -96,8 +121,29 @@ static double agrid;
  * This variable is used for convenience instead of having to type lbpar.tau everywhere. */
 static double tau;
 
-/** measures the MD time since the last fluid update */
-static double fluidstep=0.0;
+/** \name Scheduler for the MD and LB time steps
+ *  The ratio of the time steps time_step/tau is represented by the
+ *  fraction \ref lb_sched_lb_steps / \ref lb_sched_md_steps, i.e. the
+ *  fluid is updated \ref lb_sched_lb_steps times during a period of
+ *  \ref lb_sched_md_steps MD steps. */
+/*@{*/
+/** maximal number of MD steps in a period of the scheduler */
+#define LB_SCHED_MAX_MD_STEPS 10000
+/** relative accuracy of the ratio of the time steps */
+#define LB_SCHED_PREC 1e-8
+/** number of MD steps in a period */
+static int lb_sched_md_steps = 1;
+/** number of LB steps in a period */
+static int lb_sched_lb_steps = 1;
+/** number of MD steps done in the current period */
+static int lb_sched_md_count = 0;
+/** number of LB steps done in the current period */
+static int lb_sched_lb_count = 0;
+/*@}*/
+
+/** Flag indicating that momentum from the particles is waiting to
+ *  be added to the populations. */
+static int coupling_pending = 0;
 
 #ifdef ADDITIONAL_CHECKS
 /** counts the random numbers drawn for fluctuating LB and the coupling */
@@ -323,6 +369,38 @@ static void lb_create_fluid() {
 
 }
 
+/** Set up the list of local fluid sites.
+ *  The border sites are sent to the neighbouring nodes, so they are
+ *  listed first and can be updated before the interior. */
+void lb_init_fluid_sites() {
+
+  int x, y, z, index, border, pass;
+  int *grid = lblattice.grid;
+
+  fluid_sites = realloc(fluid_sites,lblattice.grid_volume*sizeof(int));
+
+  n_fluid_sites = 0;
+  for (pass=1;pass>=0;pass--) {
+    index = lblattice.halo_offset;
+    for (z=1;z<=grid[2];z++) {
+      for (y=1;y<=grid[1];y++) {
+	for (x=1;x<=grid[0];x++) {
+	  border = (x==1 || x==grid[0] || y==1 || y==grid[1] || z==1 || z==grid[2]);
+#ifdef CONSTRAINTS
+	  if (lbfluid[index].boundary==0)
+#endif
+	    if (border==pass) fluid_sites[n_fluid_sites++] = index;
+	  ++index;
+	}
+	index += 2;
+      }
+      index += 2*lblattice.halo_grid[0];
+    }
+    if (pass) n_border_sites = n_fluid_sites;
+  }
+
+}
+
 /** Sets up the structures for exchange of the halo regions.
  *  See also \ref halo.c */
 static void lb_prepare_communication() {
@@ -338,6 +416,51 @@ static void lb_prepare_communication() {
  
     halo_free_fieldtype(&fieldtype);
 
+    /* the streaming step only needs the populations which cross the
+     * faces into the local domain, i.e. in the halo behind the right
+     * face those with c[dir]=-1 and behind the left face c[dir]=+1 */
+    int i, dir, lr, cnt;
+    int flens[n_veloc], fdisps[n_veloc];
+    int slens[n_veloc+2];
+    MPI_Aint sdisps[n_veloc+2];
+    MPI_Datatype stypes[n_veloc+2];
+    Fieldtype fieldtypes[6];
+    MPI_Datatype datatypes[6];
+
+    for (dir=0;dir<3;dir++) {
+      for (lr=0;lr<2;lr++) {
+	cnt = 0;
+	for (i=0;i<n_veloc;i++) {
+	  if (lbmodel.c[i][dir] == (lr ? 1.0 : -1.0)) {
+	    slens[cnt+1] = 1;
+	    sdisps[cnt+1] = i*sizeof(double);
+	    stypes[cnt+1] = MPI_DOUBLE;
+	    flens[cnt] = sizeof(double);
+	    fdisps[cnt] = i*sizeof(double);
+	    ++cnt;
+	  }
+	}
+	halo_create_fieldtype(cnt, flens, fdisps, n_veloc*sizeof(double), &fieldtypes[2*dir+lr]);
+
+	/* the extent of the datatype is a whole lattice site */
+	slens[0] = 1;
+	sdisps[0] = 0;
+	stypes[0] = MPI_LB;
+	slens[cnt+1] = 1;
+	sdisps[cnt+1] = n_veloc*sizeof(double);
+	stypes[cnt+1] = MPI_UB;
+	MPI_Type_struct(cnt+2, slens, sdisps, stypes, &datatypes[2*dir+lr]);
+	MPI_Type_commit(&datatypes[2*dir+lr]);
+      }
+    }
+
+    prepare_halo_communication_faces(&stream_halo_comm,&lblattice,fieldtypes,datatypes);
+
+    for (i=0;i<6;i++) {
+      halo_free_fieldtype(&fieldtypes[i]);
+      MPI_Type_free(&datatypes[i]);
+    }
+
 }
 
 /** Release the fluid. */
@@ -345,6 +468,77 @@ static void lb_release_fluid() {
   MPI_Type_free(&lblattice.datatype);
   free(lbfluid[0].n);
   free(lbfluid);
+  free(fluid_sites);
+  fluid_sites = NULL;
+  n_fluid_sites = 0;
+}
+
+#ifdef D3Q19
+/** (Re-)initializes the relaxation factors and the fluctuation
+ *  amplitudes of the modes for the MRT collision.
+ *
+ *  The stress modes relax with the same eigenvalues as in the stress
+ *  tensor update, the kinetic modes with the parameters given by the user.
+ *  See Eq. (59) in Duenweg, Schiller and Ladd, PRE 76, 036704 (2007)
+ *  for the fluctuations. The factor 12 accounts for the variance of the
+ *  uniform random numbers from -0.5 to 0.5.
+ */
+static void lb_reinit_modes() {
+  int k;
+  double mu;
+
+  /* mass and momentum are conserved */
+  for (k=0;k<4;k++) lb_gamma[k] = 0.0;
+  lb_gamma[4] = 1.0 + lblambda_bulk;
+  for (k=5;k<10;k++) lb_gamma[k] = 1.0 + lblambda;
+  for (k=10;k<16;k++) lb_gamma[k] = lbpar.gamma_odd;
+  for (k=16;k<19;k++) lb_gamma[k] = lbpar.gamma_even;
+
+  /* temperature in lattice units */
+  mu = temperature/lbmodel.c_sound_sq*tau*tau/(agrid*agrid);
+
+  for (k=0;k<4;k++) lb_phi[k] = 0.0;
+  for (k=4;k<19;k++) {
+    lb_phi[k] = fluct ? sqrt(12.*mu*d3q19_mode_norm[k]*(1.-SQR(lb_gamma[k]))) : 0.0;
+  }
+
+}
+#endif
+
+/** (Re-)initializes the scheduler for the MD and LB time steps.
+ *  The ratio time_step/tau is approximated by the fraction with the
+ *  smallest denominator within \ref LB_SCHED_PREC. The current period
+ *  is only restarted if the fraction changes.
+ */
+static void lb_reinit_scheduler() {
+  int md_steps, lb_steps, best_md = 1, best_lb = 1;
+  double ratio, err, best_err = -1.0;
+
+  if (time_step <= 0.0 || tau <= 0.0) return;
+
+  ratio = time_step/tau;
+
+  for (md_steps=1; md_steps<=LB_SCHED_MAX_MD_STEPS; md_steps++) {
+    lb_steps = (int)floor(md_steps*ratio + 0.5);
+    if (lb_steps < 1) continue;
+    err = fabs(lb_steps - md_steps*ratio)/(md_steps*ratio);
+    if (best_err < 0.0 || err < best_err) {
+      best_md = md_steps;
+      best_lb = lb_steps;
+      best_err = err;
+    }
+    if (err < LB_SCHED_PREC) break;
+  }
+
+  if (best_md != lb_sched_md_steps || best_lb != lb_sched_lb_steps) {
+    lb_sched_md_steps = best_md;
+    lb_sched_lb_steps = best_lb;
+    lb_sched_md_count = 0;
+    lb_sched_lb_count = 0;
+  }
+
+  LB_TRACE(fprintf(stderr,"%d: lb_reinit_scheduler: %d LB steps per %d MD steps (rel. error %e)\n",this_node,lb_sched_lb_steps,lb_sched_md_steps,best_err));
+
 }
 
 /** (Re-)initializes the fluid. */
@@ -355,6 +549,8 @@ void lb_reinit_parameters() {
 
   n_veloc = lbmodel.n_veloc;
 
+  lb_reinit_scheduler();
+
   /* number of double entries in the data fields */
   n_fields = n_veloc;
 #ifndef D3Q19
@@ -402,6 +598,10 @@ void lb_reinit_parameters() {
     lb_coupl_pref = 0.0;
   }
 
+#ifdef D3Q19
+  lb_reinit_modes();
+#endif
+
 }
 
 /** (Re-)initializes the fluid according to the given value of rho. */
@@ -426,8 +626,15 @@ void lb_reinit_fluid() {
       lb_set_local_fields(k,rho,v,pi);
 #endif
 
+      lbfluid[k].coupling_j[0] = 0.0;
+      lbfluid[k].coupling_j[1] = 0.0;
+      lbfluid[k].coupling_j[2] = 0.0;
+
     }
 
+    coupling_pending = 0;
+    update_fluid_fields = 1;
+
 }
 
 /** Performs a full initialization of
@@ -453,6 +660,9 @@ void lb_init() {
   lb_init_constraints();
 #endif
 
+  /* collect the sites which carry fluid */
+  lb_init_fluid_sites();
+
   /* setup the initial particle velocity distribution */
   lb_reinit_fluid();
 
@@ -464,6 +674,10 @@ void lb_init() {
 /** Release fluid and communication. */
 void lb_release() {
   release_halo_communication(&update_halo_comm);
+  release_halo_communication(&stream_halo_comm);
+#ifdef CONSTRAINTS
+  lb_release_constraints();
+#endif
   lb_release_fluid();
 }
 
@@ -716,73 +930,194 @@ MDINLINE int lb_check_negative_n(LB_FluidNode *local_node) {
 }
 #endif
 
+#ifdef D3Q19
+/** Transformation of the populations into mode space.
+ * The matrix product with \ref d3q19_modebase is written as a sequence
+ * of scaled vector additions over the modes, which the compiler can
+ * vectorize.
+ *
+ * @param n    populations of the local lattice site (Input).
+ * @param mode modes of the local lattice site (Output).
+ */
+MDINLINE void lb_calc_modes(const double *n, double *mode) {
+  int i, k;
+
+  for (k=0;k<19;k++) mode[k] = 0.0;
+
+  for (i=0;i<19;i++) {
+    const double *e = d3q19_modebase[i];
+    const double n_i = n[i];
+    for (k=0;k<19;k++) mode[k] += e[k]*n_i;
+  }
+
+}
+
+/** Relaxation of the modes towards their equilibrium values.
+ * The equilibrium of the stress modes is given by the momentum
+ * density, the kinetic modes relax towards zero. Mass and momentum
+ * are conserved since their relaxation factors vanish.
+ *
+ * @param mode modes of the local lattice site (Input/Output).
+ */
+MDINLINE void lb_relax_modes(double *mode) {
+  int k;
+  double mode_eq[19];
+  const double avg_rho = lbpar.rho*(agrid*agrid*agrid);
+  const double rho_i = 1.0/(avg_rho + mode[0]);
+  const double *j = mode + 1;
+  const double j2[3] = { j[0]*j[0], j[1]*j[1], j[2]*j[2] };
+
+  for (k=0;k<4;k++) mode_eq[k] = mode[k];
+
+  /* bulk and shear modes */
+  mode_eq[4] = (j2[0] + j2[1] + j2[2])*rho_i;
+  mode_eq[5] = (j2[0] - j2[1])*rho_i;
+  mode_eq[6] = (j2[0] + j2[1] - 2.0*j2[2])*rho_i;
+  mode_eq[7] = j[0]*j[1]*rho_i;
+  mode_eq[8] = j[0]*j[2]*rho_i;
+  mode_eq[9] = j[1]*j[2]*rho_i;
+
+  /* kinetic modes */
+  for (k=10;k<19;k++) mode_eq[k] = 0.0;
+
+  for (k=0;k<19;k++) mode[k] = mode_eq[k] + lb_gamma[k]*(mode[k] - mode_eq[k]);
+
+}
+
+/** Thermalization of the non-conserved modes.
+ * See Eq. (59) in Duenweg, Schiller and Ladd, PRE 76, 036704 (2007).
+ *
+ * @param mode modes of the local lattice site (Input/Output).
+ */
+MDINLINE void lb_thermalize_modes(double *mode) {
+  int k;
+  const double avg_rho = lbpar.rho*(agrid*agrid*agrid);
+  const double sqrt_rho = sqrt(avg_rho + mode[0]);
+
+  for (k=4;k<19;k++) mode[k] += sqrt_rho*lb_phi[k]*(d_random()-0.5);
+
+#ifdef ADDITIONAL_CHECKS
+  rancounter += 15;
+#endif
+
+}
+
+/** Back transformation of the modes into populations.
+ * Like \ref lb_calc_modes, this is a sequence of scaled vector additions
+ * with the rows of \ref d3q19_modebase_inv.
+ *
+ * @param mode modes of the local lattice site (Input).
+ * @param n    populations of the local lattice site (Output).
+ */
+MDINLINE void lb_calc_n_from_modes(const double *mode, double *n) {
+  int i, k;
+
+  for (i=0;i<19;i++) n[i] = 0.0;
+
+  for (k=0;k<19;k++) {
+    const double *e = d3q19_modebase_inv[k];
+    const double m_k = mode[k];
+    for (i=0;i<19;i++) n[i] += e[i]*m_k;
+  }
+
+}
+
+/** Multiple relaxation time collision of a lattice site.
+ * The populations are transformed into mode space, where each mode is
+ * relaxed with its own rate and thermalized, and transformed back.
+ * With vanishing relaxation factors of the kinetic modes, this is the
+ * same update as the relaxation of the stress tensor.
+ *
+ * See Duenweg, Schiller and Ladd, PRE 76, 036704 (2007).
+ *
+ * @param local_node Pointer to the local lattice site.
+ */
+MDINLINE void lb_collide_modes(LB_FluidNode *local_node) {
+  double mode[19];
+
+  lb_calc_modes(local_node->n, mode);
+
+  /* density and momentum are not changed by the collision */
+  *(local_node->rho) = lbpar.rho*(agrid*agrid*agrid) + mode[0];
+  local_node->j[0] = mode[1];
+  local_node->j[1] = mode[2];
+  local_node->j[2] = mode[3];
+
+  lb_relax_modes(mode);
+
+  if (fluct) lb_thermalize_modes(mode);
+
+  lb_calc_n_from_modes(mode, local_node->n);
+
+}
+#endif
+
 /** The Lattice Boltzmann collision step.
  * Loop over all lattice sites and perform the collision update.
  * If fluctuations are present, the fluctuating part of the stress tensor
- * is added. The update is only accepted then, if no negative populations
+ * is added. With the MRT collision, all modes are relaxed and thermalized
+ * in mode space instead. The update is only accepted then, if no negative populations
  * occur.
+ *
+ * @param first index of the first site in \ref fluid_sites to update
+ * @param last  index after the last site in \ref fluid_sites to update
  */
-MDINLINE void lb_calc_collisions() {
+MDINLINE void lb_calc_collisions(int first, int last) {
 
-  int index, x, y, z;
+  int k;
   LB_FluidNode *local_node;
   
-  /* loop over all nodes (halo excluded) */
-  index = lblattice.halo_offset;
-  for (z=1;z<=lblattice.grid[2];z++) {
-    for (y=1;y<=lblattice.grid[1];y++) {
-      for (x=1;x<=lblattice.grid[0];x++) {
+  /* loop over the fluid nodes (halo and boundaries excluded) */
+  for (k=first;k<last;k++) {
 
-#ifdef CONSTRAINTS
-	if (lbfluid[index].boundary==0) 
-	{
-#endif
-	  local_node = &lbfluid[index];
-
-	  lb_calc_local_fields(local_node,1);
+    local_node = &lbfluid[fluid_sites[k]];
 
 #ifdef ADDITIONAL_CHECKS
-	  double old_rho = *(local_node->rho);
+    lb_calc_local_rho(local_node);
+    double old_rho = *(local_node->rho);
+#endif
+
+#ifdef D3Q19
+    if (lbpar.mrt) {
+      lb_collide_modes(local_node);
+    }
+    else
 #endif
+    {
+      lb_calc_local_fields(local_node,1);
 
-	  lb_update_local_pi(local_node);
+      lb_update_local_pi(local_node);
 	
-	  if (fluct) lb_add_fluct_pi(local_node);
+      if (fluct) lb_add_fluct_pi(local_node);
 	  
-	  lb_calc_local_n(local_node);
+      lb_calc_local_n(local_node);
+    }
 	  
 #ifdef ADDITIONAL_CHECKS
-	  lb_check_negative_n(local_node);
+    lb_check_negative_n(local_node);
 #endif
 
 #ifdef ADDITIONAL_CHECKS
-	  int j;
-	  double *local_n = local_node->n;
-	  for (j=0;j<n_veloc;j++) {
-	    if (lbmodel.coeff[j][0]*lbpar.rho+local_n[j] < 0.0) {
-	      char *errtxt;
-	      errtxt = runtime_error(128);
-	      ERROR_SPRINTF(errtxt,"{105 Unexpected negative population} ");
-	    }
-	  }
+    int j;
+    double *local_n = local_node->n;
+    for (j=0;j<n_veloc;j++) {
+      if (lbmodel.coeff[j][0]*lbpar.rho+local_n[j] < 0.0) {
+	char *errtxt;
+	errtxt = runtime_error(128);
+	ERROR_SPRINTF(errtxt,"{105 Unexpected negative population} ");
+      }
+    }
 #endif
 	    
 #ifdef ADDITIONAL_CHECKS
-	  double *local_rho = local_node->rho;
-	  lb_calc_local_rho(local_node);
-	  if (fabs(*local_rho-old_rho) > ROUND_ERROR_PREC) {
-	    char *errtxt = runtime_error(128 + TCL_DOUBLE_SPACE + 3*TCL_INTEGER_SPACE);
-	    ERROR_SPRINTF(errtxt,"{106 Mass loss/gain %le in lb_calc_collisions on site (%d,%d,%d)} ",*local_rho-old_rho,x,y,z);
-	  }
-#endif
-#ifdef CONSTRAINTS
-	}
-#endif
-	++index;
-      }
-      index += 2;
+    double *local_rho = local_node->rho;
+    lb_calc_local_rho(local_node);
+    if (fabs(*local_rho-old_rho) > ROUND_ERROR_PREC) {
+      char *errtxt = runtime_error(128 + TCL_DOUBLE_SPACE + TCL_INTEGER_SPACE);
+      ERROR_SPRINTF(errtxt,"{106 Mass loss/gain %le in lb_calc_collisions on site %d} ",*local_rho-old_rho,fluid_sites[k]);
     }
-    index += 2*lblattice.halo_grid[0];
+#endif
+
   }
 
 }
@@ -938,67 +1273,56 @@ MDINLINE void lb_propagate_n() {
  *
  * Eq. (28) Ladd and Verberg, J. Stat. Phys. 104(5/6):1191 (2001).
  * Note that the second moment of the force is neglected.
+ *
+ * @param first index of the first site in \ref fluid_sites to update
+ * @param last  index after the last site in \ref fluid_sites to update
  */
-MDINLINE void lb_external_forces() {
+MDINLINE void lb_external_forces(int first, int last) {
 
-  int x, y, z, index;
+  int k;
   double *local_n, *local_j, delta_j[3] = { 0.0, 0.0, 0.0 };
 
-  index = lblattice.halo_offset;
-  for (z=1; z<=lblattice.grid[2]; z++) {
-    for (y=1; y<=lblattice.grid[1]; y++) {
-      for (x=1; x<=lblattice.grid[0]; x++) {
+  /* calculate momentum due to ext_force in lattice units */
+  /* ext_force is the force per volume in LJ units */
+  delta_j[0] = lbpar.ext_force[0]*tau*tau*agrid*agrid;
+  delta_j[1] = lbpar.ext_force[1]*tau*tau*agrid*agrid;
+  delta_j[2] = lbpar.ext_force[2]*tau*tau*agrid*agrid;
 
-#ifdef CONSTRAINTS
-	if (lbfluid[index].boundary==0) 
-#endif
-	{
+  for (k=first; k<last; k++) {
 
-	  local_n   = lbfluid[index].n;
-	  local_j   = lbfluid[index].j;
+    local_n   = lbfluid[fluid_sites[k]].n;
+    local_j   = lbfluid[fluid_sites[k]].j;
 
-	  /* calculate momentum due to ext_force in lattice units */
-	  /* ext_force is the force per volume in LJ units */
-	  delta_j[0] = lbpar.ext_force[0]*tau*tau*agrid*agrid;
-	  delta_j[1] = lbpar.ext_force[1]*tau*tau*agrid*agrid;
-	  delta_j[2] = lbpar.ext_force[2]*tau*tau*agrid*agrid;
-	  
-	  local_j[0] += delta_j[0];
-	  local_j[1] += delta_j[1];
-	  local_j[2] += delta_j[2];
+    local_j[0] += delta_j[0];
+    local_j[1] += delta_j[1];
+    local_j[2] += delta_j[2];
 
 #ifdef D3Q19
-	  local_n[1]  +=   1./6. * delta_j[0];
-	  local_n[2]  += - 1./6. * delta_j[0];
-	  local_n[3]  +=   1./6. * delta_j[1];
-	  local_n[4]  += - 1./6. * delta_j[1];
-	  local_n[5]  +=   1./6. * delta_j[2];
-	  local_n[6]  += - 1./6. * delta_j[2];
-	  local_n[7]  +=   1./12. * (delta_j[0]+delta_j[1]);
-	  local_n[8]  += - 1./12. * (delta_j[0]+delta_j[1]);
-	  local_n[9]  +=   1./12. * (delta_j[0]-delta_j[1]);
-	  local_n[10] += - 1./12. * (delta_j[0]-delta_j[1]);
-	  local_n[11] +=   1./12. * (delta_j[0]+delta_j[2]);
-	  local_n[12] += - 1./12. * (delta_j[0]+delta_j[2]);
-	  local_n[13] +=   1./12. * (delta_j[0]-delta_j[1]);
-	  local_n[14] += - 1./12. * (delta_j[0]-delta_j[1]);
-	  local_n[15] +=   1./12. * (delta_j[1]+delta_j[2]);
-	  local_n[16] += - 1./12. * (delta_j[1]+delta_j[2]);
-	  local_n[17] +=   1./12. * (delta_j[1]-delta_j[2]);
-	  local_n[18] += - 1./12. * (delta_j[1]-delta_j[2]);
+    local_n[1]  +=   1./6. * delta_j[0];
+    local_n[2]  += - 1./6. * delta_j[0];
+    local_n[3]  +=   1./6. * delta_j[1];
+    local_n[4]  += - 1./6. * delta_j[1];
+    local_n[5]  +=   1./6. * delta_j[2];
+    local_n[6]  += - 1./6. * delta_j[2];
+    local_n[7]  +=   1./12. * (delta_j[0]+delta_j[1]);
+    local_n[8]  += - 1./12. * (delta_j[0]+delta_j[1]);
+    local_n[9]  +=   1./12. * (delta_j[0]-delta_j[1]);
+    local_n[10] += - 1./12. * (delta_j[0]-delta_j[1]);
+    local_n[11] +=   1./12. * (delta_j[0]+delta_j[2]);
+    local_n[12] += - 1./12. * (delta_j[0]+delta_j[2]);
+    local_n[13] +=   1./12. * (delta_j[0]-delta_j[2]);
+    local_n[14] += - 1./12. * (delta_j[0]-delta_j[2]);
+    local_n[15] +=   1./12. * (delta_j[1]+delta_j[2]);
+    local_n[16] += - 1./12. * (delta_j[1]+delta_j[2]);
+    local_n[17] +=   1./12. * (delta_j[1]-delta_j[2]);
+    local_n[18] += - 1./12. * (delta_j[1]-delta_j[2]);
 #else
-	  int i;
-	  for (i=0; i<n_veloc; i++) {
-	      local_n[i] += lbmodel.coeff[i][1]*scalar(delta_j,lbmodel.c[i]);
-	  }
+    int i;
+    for (i=0; i<n_veloc; i++) {
+      local_n[i] += lbmodel.coeff[i][1]*scalar(delta_j,lbmodel.c[i]);
+    }
 #endif
 
-	}
-	++index;
-      }
-      index += 2;
-    }
-    index += 2*lblattice.halo_grid[0];
   }
 
 }
@@ -1010,41 +1334,146 @@ MDINLINE void lb_external_forces() {
 /***********************************************************************/
 /*@{*/
 
-/** Propagate the Lattice Boltzmann dynamics.
- * This function is called from the integrator. Since the time step
- * for the lattice dynamics can be coarser than the MD time step,
- * we monitor the time since the last lattice update.
+/** Add the momentum transferred from the particles to the populations.
+ * The momentum is collected by \ref lb_transfer_momentum over all MD
+ * steps since the last fluid update and added before the collision.
+ *
+ * @param first index of the first site in \ref fluid_sites to update
+ * @param last  index after the last site in \ref fluid_sites to update
  */
-void lb_propagate() {
+MDINLINE void lb_apply_coupling(int first, int last) {
 
-  fluidstep+=time_step ;
+  int k;
+  double *local_n, *delta_j;
 
-  if (fluidstep>=tau) {
+  for (k=first; k<last; k++) {
 
-    fluidstep=0.0 ;
+    local_n = lbfluid[fluid_sites[k]].n;
+    delta_j = lbfluid[fluid_sites[k]].coupling_j;
 
-    /* collision step */
-    lb_calc_collisions();
-
-#ifdef EXTERNAL_FORCES
-    /* apply external forces */
-    lb_external_forces();
+#ifdef D3Q19
+    local_n[1]  +=   1./6. * delta_j[0];
+    local_n[2]  += - 1./6. * delta_j[0];
+    local_n[3]  +=   1./6. * delta_j[1];
+    local_n[4]  += - 1./6. * delta_j[1];
+    local_n[5]  +=   1./6. * delta_j[2];
+    local_n[6]  += - 1./6. * delta_j[2];
+    local_n[7]  +=   1./12. * (delta_j[0]+delta_j[1]);
+    local_n[8]  += - 1./12. * (delta_j[0]+delta_j[1]);
+    local_n[9]  +=   1./12. * (delta_j[0]-delta_j[1]);
+    local_n[10] += - 1./12. * (delta_j[0]-delta_j[1]);
+    local_n[11] +=   1./12. * (delta_j[0]+delta_j[2]);
+    local_n[12] += - 1./12. * (delta_j[0]+delta_j[2]);
+    local_n[13] +=   1./12. * (delta_j[0]-delta_j[2]);
+    local_n[14] += - 1./12. * (delta_j[0]-delta_j[2]);
+    local_n[15] +=   1./12. * (delta_j[1]+delta_j[2]);
+    local_n[16] += - 1./12. * (delta_j[1]+delta_j[2]);
+    local_n[17] +=   1./12. * (delta_j[1]-delta_j[2]);
+    local_n[18] += - 1./12. * (delta_j[1]-delta_j[2]);
+#else
+    int i;
+    for (i=0; i<n_veloc; i++) {
+      local_n[i] += lbmodel.coeff[i][1]*scalar(delta_j,lbmodel.c[i]);
+    }
 #endif
 
-    /* exchange halo regions */
-    halo_communication(&update_halo_comm);
+    delta_j[0] = delta_j[1] = delta_j[2] = 0.0;
+
 #ifdef ADDITIONAL_CHECKS
-    lb_check_halo_regions();
+    lb_check_negative_n(&lbfluid[fluid_sites[k]]);
 #endif
 
+  }
+
+}
+
+/** Collision step and external forces for a range of fluid sites.
+ * @param first index of the first site in \ref fluid_sites to update
+ * @param last  index after the last site in \ref fluid_sites to update
+ */
+MDINLINE void lb_collide_sites(int first, int last) {
+
+  if (coupling_pending) lb_apply_coupling(first, last);
+
+  lb_calc_collisions(first, last);
+
+#ifdef EXTERNAL_FORCES
+  /* apply external forces */
+  lb_external_forces(first, last);
+#endif
+
+}
+
+/** One update of the Lattice Boltzmann fluid.
+ *
+ * The sites on the border of the local domain are updated first. The
+ * halo exchange for the streaming step then runs in the background
+ * while the interior sites are updated, one third of the interior per
+ * space direction of the exchange.
+ */
+static void lb_lattice_step() {
+
+  int k, dir, first, chunk;
+
+  /* collision step on the border */
+  lb_collide_sites(0, n_border_sites);
+
+  /* collision step in the interior overlapping the halo exchange */
+  first = n_border_sites;
+  chunk = (n_fluid_sites - n_border_sites + 2)/3;
+  for (dir=0; dir<3; dir++) {
+    halo_communication_start(&stream_halo_comm, dir);
+    lb_collide_sites(first, imin(first+chunk, n_fluid_sites));
+    first = imin(first+chunk, n_fluid_sites);
+    halo_communication_finish(&stream_halo_comm, dir);
+  }
+
+  /* streaming step */
+  lb_propagate_n();
+
 #ifdef CONSTRAINTS
-    /* boundary conditions */
-    lb_boundary_conditions();
+  /* boundary conditions */
+  lb_boundary_conditions();
 #endif
 
-    /* streaming step */
-    lb_propagate_n();
+  /* momentum given to halo and boundary sites is discarded,
+   * the owners of the sites have taken it into account */
+  if (coupling_pending) {
+    for (k=0; k<lblattice.halo_grid_volume; k++) {
+      lbfluid[k].coupling_j[0] = 0.0;
+      lbfluid[k].coupling_j[1] = 0.0;
+      lbfluid[k].coupling_j[2] = 0.0;
+    }
+    coupling_pending = 0;
+  }
+
+  update_fluid_fields = 1;
+
+}
+
+/** Propagate the Lattice Boltzmann dynamics.
+ * This function is called from the integrator after each MD step.
+ * The scheduler determines how many fluid updates are due, which
+ * can be none, one or several, depending on the ratio of the time
+ * steps. The updates are distributed evenly over the MD steps.
+ */
+void lb_propagate() {
+
+  int lb_steps;
+
+  ++lb_sched_md_count;
+
+  /* number of fluid updates due at the end of this MD step */
+  lb_steps = lb_sched_md_count*lb_sched_lb_steps/lb_sched_md_steps - lb_sched_lb_count;
 
+  for (; lb_steps>0; lb_steps--) {
+    lb_lattice_step();
+    ++lb_sched_lb_count;
+  }
+
+  if (lb_sched_md_count == lb_sched_md_steps) {
+    lb_sched_md_count = 0;
+    lb_sched_lb_count = 0;
   }
 
 }
@@ -1058,83 +1487,41 @@ void lb_propagate() {
  * 
  * Eq. (14) Ahlrichs and Duenweg, JCP 111(17):8225 (1999).
  *
+ * The momentum is only collected on the lattice sites and added to the
+ * populations by \ref lb_apply_coupling at the next fluid update. Thus
+ * the coupling of all MD steps between two fluid updates is done in
+ * one sweep, and the fluid fields seen by the particles stay the same
+ * on all nodes.
+ *
  * @param momentum   Momentum to be transfered to the fluid (lattice
  *                   units) (Input).
  * @param node_index Indices of the sites of the elementary lattice
  *                   cell (Input).
  * @param delta      Weights for the assignment to the single lattice
  *                   sites (Input).
- * @param badrandoms Flag/Counter for the occurrence negative
- *                   populations (Output).
  */
 MDINLINE void lb_transfer_momentum(const double momentum[3], const int node_index[8], const double delta[6]) {
 
-  int x, y, z, index;
-  LB_FluidNode *local_node;
-  double *local_n, *n_tmp;
-  double *local_j, delta_j[3];
-
-  /* We don't need to save the local populations because 
-   * we use a trick for their restoration:
-   * We substract the old random force from the new one,
-   * hence the previous change in the local populations
-   * is automatically revoked during the recalculation.
-   * Note that this makes it necessary to actually apply 
-   * all changes and forbids to return immediately when negative
-   * populations occur.
-   */
+  int x, y, z;
+  double *coupling_j, weight;
 
   for (z=0;z<2;z++) {
     for (y=0;y<2;y++) {
       for (x=0;x<2;x++) {
 	
-	index = node_index[(z*2+y)*2+x];
-	local_node = &lbfluid[index];
-	local_n = n_tmp = local_node->n;
-	local_j = local_node->j;
+	coupling_j = lbfluid[node_index[(z*2+y)*2+x]].coupling_j;
+	weight = delta[3*x+0]*delta[3*y+1]*delta[3*z+2];
 
-	delta_j[0] = delta[3*x+0]*delta[3*y+1]*delta[3*z+2]*momentum[0];
-	delta_j[1] = delta[3*x+0]*delta[3*y+1]*delta[3*z+2]*momentum[1];
-	delta_j[2] = delta[3*x+0]*delta[3*y+1]*delta[3*z+2]*momentum[2];
-
-#ifdef D3Q19
-	local_n[1]  = n_tmp[1]  + 1./6.*delta_j[0];
-	local_n[2]  = n_tmp[2]  - 1./6.*delta_j[0];
-	local_n[3]  = n_tmp[3]  + 1./6.*delta_j[1];
-	local_n[4]  = n_tmp[4]  - 1./6.*delta_j[1];
-	local_n[5]  = n_tmp[5]  + 1./6.*delta_j[2];
-	local_n[6]  = n_tmp[6]  - 1./6.*delta_j[2];
-	local_n[7]  = n_tmp[7]  + 1./12.*(delta_j[0]+delta_j[1]);
-	local_n[8]  = n_tmp[8]  - 1./12.*(delta_j[0]+delta_j[1]);
-	local_n[9]  = n_tmp[9]  + 1./12.*(delta_j[0]-delta_j[1]);
-	local_n[10] = n_tmp[10] - 1./12.*(delta_j[0]-delta_j[1]);
-	local_n[11] = n_tmp[11] + 1./12.*(delta_j[0]+delta_j[2]);
-	local_n[12] = n_tmp[12] - 1./12.*(delta_j[0]+delta_j[2]);
-	local_n[13] = n_tmp[13] + 1./12.*(delta_j[0]-delta_j[2]);
-	local_n[14] = n_tmp[14] - 1./12.*(delta_j[0]-delta_j[2]);
-	local_n[15] = n_tmp[15] + 1./12.*(delta_j[1]+delta_j[2]);
-	local_n[16] = n_tmp[16] - 1./12.*(delta_j[1]+delta_j[2]);
-	local_n[17] = n_tmp[17] + 1./12.*(delta_j[1]-delta_j[2]);
-	local_n[18] = n_tmp[18] - 1./12.*(delta_j[1]-delta_j[2]);
-#else
-	int i;
-	double (*c)[3] = lbmodel.c;
-	double (*coeff)[4] = lbmodel.coeff;
-
-	for (i=0;i<n_veloc;i++) {
-	  local_n[i] = n_tmp[i] + coeff[i][1] * scalar(delta_j,c[i]);
-	}
-
-#endif
-
-#ifdef ADDITIONAL_CHECKS
-	lb_check_negative_n(local_node);
-#endif
+	coupling_j[0] += weight*momentum[0];
+	coupling_j[1] += weight*momentum[1];
+	coupling_j[2] += weight*momentum[2];
 
       }
     }
   }
 
+  coupling_pending = 1;
+
 }
 /** Setup of the LB populations on the boundary nodes to allow velocity interpolation close to boundary elements.
  *  Bounce back is the only b.c. implemented right now.
@@ -1322,21 +1709,28 @@ MDINLINE void lb_viscous_momentum_exchange(Particle *p, double force[3]) {
  */
 void calc_particle_lattice_ia() {
  
-  int i, k, c, np;
+  int i, j, k, c, np;
   Cell *cell ;
   Particle *p ;
-  double force[3];
+  double force[3], noise[4];
 
   if (transfer_momentum) {
 
-    /* exchange halo regions */
-    halo_communication(&update_halo_comm) ;
+    /* the fluid fields only change with the fluid updates */
+    if (update_fluid_fields) {
+
+      /* exchange halo regions */
+      halo_communication(&update_halo_comm) ;
 #ifdef ADDITIONAL_CHECKS
-    lb_check_halo_regions();
+      lb_check_halo_regions();
 #endif
     
-    for (k=0;k<lblattice.halo_grid_volume;k++) {
-      lb_calc_local_fields(&lbfluid[k],0);
+      for (k=0;k<lblattice.halo_grid_volume;k++) {
+	lb_calc_local_fields(&lbfluid[k],0);
+      }
+
+      update_fluid_fields = 0;
+
     }
 
     /* draw random numbers for local particles */
@@ -1345,9 +1739,16 @@ void calc_particle_lattice_ia() {
       p = cell->part ;
       np = cell->n ;
       for (i=0;i<np;i++) {
-	p[i].lc.f_random[0] = -lb_coupl_pref*(d_random()-0.5);
-	p[i].lc.f_random[1] = -lb_coupl_pref*(d_random()-0.5);
-	p[i].lc.f_random[2] = -lb_coupl_pref*(d_random()-0.5);
+	if (counter_rng_seed) {
+	  c_random4(p[i].p.identity, 0, COUNTER_RNG_LB_COUPLING, noise);
+	  for (j=0;j<3;j++)
+	    p[i].lc.f_random[j] = -lb_coupl_pref*(noise[j]-0.5);
+	}
+	else {
+	  p[i].lc.f_random[0] = -lb_coupl_pref*(d_random()-0.5);
+	  p[i].lc.f_random[1] = -lb_coupl_pref*(d_random()-0.5);
+	  p[i].lc.f_random[2] = -lb_coupl_pref*(d_random()-0.5);
+	}
 
 #ifdef ADDITIONAL_CHECKS
 	rancounter += 3;
@@ -1501,6 +1902,180 @@ void lb_set_local_fields(int index, const double rho, const double *v, const dou
 
 /*@}*/
 
+/***********************************************************************/
+/** \name Checkpointing */
+/***********************************************************************/
+/*@{*/
+
+/** Identification string at the beginning of a checkpoint file. */
+#define LB_CHECKPOINT_MAGIC "ESPLBCK"
+/** Version of the checkpoint file layout. */
+#define LB_CHECKPOINT_VERSION 2
+
+/** Header of a checkpoint file. It is followed by the populations of
+ *  all sites of the global lattice (halo excluded) with x running
+ *  fastest, so the layout does not depend on the domain decomposition.
+ */
+typedef struct {
+  char magic[8];
+  int version;
+  /** number of lattice sites of the global lattice in each direction */
+  int grid[3];
+  int n_veloc;
+  LB_Parameters par;
+} LB_CheckpointHeader;
+
+/** Determine the size of the global lattice and the position of the
+ *  first local site within it. */
+static void lb_global_lattice(int grid[3], int offset[3]) {
+  int dir;
+  for (dir=0;dir<3;dir++) {
+    grid[dir] = lblattice.grid[dir]*node_grid[dir];
+    offset[dir] = lblattice.grid[dir]*node_pos[dir];
+  }
+}
+
+/** Read or write the populations of the local lattice sites from/to
+ *  their place in a checkpoint file. Each row in x direction is
+ *  contiguous both in memory and in the file.
+ * @return 0 on success, 1 if an i/o error occured
+ */
+static int lb_checkpoint_rows(FILE *f, int grid[3], int offset[3], int load) {
+
+  int y, z, index;
+  long pos;
+  size_t row = lblattice.grid[0]*n_veloc;
+
+  for (z=1;z<=lblattice.grid[2];z++) {
+    for (y=1;y<=lblattice.grid[1];y++) {
+
+      index = get_linear_index(1,y,z,lblattice.halo_grid);
+      pos = ((long)(offset[2]+z-1)*grid[1] + offset[1]+y-1)*grid[0] + offset[0];
+      pos = sizeof(LB_CheckpointHeader) + pos*n_veloc*sizeof(double);
+
+      if (fseek(f, pos, SEEK_SET)) return 1;
+
+      if (load) {
+	if (fread(lbfluid[index].n, sizeof(double), row, f) != row) return 1;
+      } else {
+	if (fwrite(lbfluid[index].n, sizeof(double), row, f) != row) return 1;
+      }
+
+    }
+  }
+
+  return 0;
+
+}
+
+void lb_save_checkpoint(char *filename) {
+
+  LB_CheckpointHeader header;
+  int grid[3], offset[3], ok = 1;
+  FILE *f;
+
+  if (!lbfluid) {
+    if (this_node == 0) {
+      char *errtxt = runtime_error(128);
+      ERROR_SPRINTF(errtxt, "{111 LB fluid is not initialized} ");
+    }
+    return;
+  }
+
+  /* the momentum from the particles is added before the next
+   * collision anyway, so it can be written with the populations */
+  if (coupling_pending) lb_apply_coupling(0, n_fluid_sites);
+
+  lb_global_lattice(grid, offset);
+
+  /* the master creates the file and writes the header */
+  if (this_node == 0) {
+    memset(&header, 0, sizeof(LB_CheckpointHeader));
+    strcpy(header.magic, LB_CHECKPOINT_MAGIC);
+    header.version = LB_CHECKPOINT_VERSION;
+    memcpy(header.grid, grid, 3*sizeof(int));
+    header.n_veloc = n_veloc;
+    header.par = lbpar;
+
+    f = fopen(filename, "wb");
+    ok = (f && fwrite(&header, sizeof(LB_CheckpointHeader), 1, f) == 1);
+    if (f) fclose(f);
+  }
+
+  MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  /* then every node writes its part of the lattice */
+  if (ok) {
+    f = fopen(filename, "r+b");
+    ok = (f && !lb_checkpoint_rows(f, grid, offset, 0));
+    if (f && fclose(f)) ok = 0;
+  }
+
+  if (!ok) {
+    char *errtxt = runtime_error(128 + strlen(filename));
+    ERROR_SPRINTF(errtxt, "{112 could not write LB checkpoint \"%s\"} ", filename);
+  }
+
+  /* the file is complete only after all nodes are done */
+  MPI_Barrier(MPI_COMM_WORLD);
+
+}
+
+void lb_load_checkpoint(char *filename) {
+
+  LB_CheckpointHeader header;
+  int grid[3], offset[3], ok = 1;
+  FILE *f;
+
+  /* the master checks the header */
+  if (this_node == 0) {
+    f = fopen(filename, "rb");
+    ok = (f && fread(&header, sizeof(LB_CheckpointHeader), 1, f) == 1
+	  && strcmp(header.magic, LB_CHECKPOINT_MAGIC) == 0
+	  && header.version == LB_CHECKPOINT_VERSION
+	  && header.n_veloc == lbmodel.n_veloc);
+    if (f) fclose(f);
+  }
+
+  MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (!ok) {
+    if (this_node == 0) {
+      char *errtxt = runtime_error(128 + strlen(filename));
+      ERROR_SPRINTF(errtxt, "{113 \"%s\" is not a valid LB checkpoint} ", filename);
+    }
+    return;
+  }
+
+  MPI_Bcast(&header, sizeof(LB_CheckpointHeader), MPI_BYTE, 0, MPI_COMM_WORLD);
+
+  /* set up the lattice for the stored parameters */
+  lbpar = header.par;
+  lb_init();
+  if (check_runtime_errors()) return;
+
+  lb_global_lattice(grid, offset);
+  if (grid[0] != header.grid[0] || grid[1] != header.grid[1] || grid[2] != header.grid[2]) {
+    if (this_node == 0) {
+      char *errtxt = runtime_error(128 + 6*TCL_INTEGER_SPACE);
+      ERROR_SPRINTF(errtxt, "{114 LB checkpoint lattice %dx%dx%d does not match the box lattice %dx%dx%d} ",header.grid[0],header.grid[1],header.grid[2],grid[0],grid[1],grid[2]);
+    }
+    return;
+  }
+
+  /* every node picks its part of the lattice */
+  f = fopen(filename, "rb");
+  ok = (f && !lb_checkpoint_rows(f, grid, offset, 1));
+  if (f) fclose(f);
+
+  if (!ok) {
+    char *errtxt = runtime_error(128 + strlen(filename));
+    ERROR_SPRINTF(errtxt, "{115 could not read LB checkpoint \"%s\"} ", filename);
+  }
+
+}
+
+/*@}*/
+
 /***********************************************************************/
 /** \name TCL stuff */
 /***********************************************************************/
@@ -1638,10 +2213,6 @@ static int lbfluid_parse_tau(Tcl_Interp *interp, int argc, char *argv[], int *ch
 	Tcl_AppendResult(interp, "tau must be positive", (char *)NULL);
 	return TCL_ERROR;
     }
-    else if ((time_step >= 0.0) && (tau < time_step)) {
-      Tcl_AppendResult(interp, "tau must be larger than MD time_step", (char *)NULL);
-      return TCL_ERROR;
-    }
 
     *change = 1;
     lbpar.tau = tau;
@@ -1792,6 +2363,50 @@ static int lbfluid_parse_ext_force(Tcl_Interp *interp, int argc, char *argv[], i
  
     return TCL_OK;
 }
+
+static int lbfluid_parse_mrt(Tcl_Interp *interp, int argc, char *argv[], int *change) {
+    double gamma_odd, gamma_even;
+
+    if (argc >= 1 && ARG0_IS_S("off")) {
+	*change = 1;
+	lbpar.mrt = 0;
+	mpi_bcast_lb_params(LBPAR_MRT);
+	return TCL_OK;
+    }
+    if (argc < 2) {
+	Tcl_AppendResult(interp, "mrt requires 2 arguments or \"off\"", (char *)NULL);
+	return TCL_ERROR;
+    }
+    if (!ARG_IS_D(0, gamma_odd) || !ARG_IS_D(1, gamma_even)) {
+	Tcl_AppendResult(interp, "wrong argument for mrt", (char *)NULL);
+	return TCL_ERROR;
+    }
+    if (fabs(gamma_odd) > 1.0 || fabs(gamma_even) > 1.0) {
+	Tcl_AppendResult(interp, "mrt relaxation parameters must be between -1 and 1", (char *)NULL);
+	return TCL_ERROR;
+    }
+
+    *change = 2;
+    lbpar.mrt = 1;
+    lbpar.gamma_odd = gamma_odd;
+    lbpar.gamma_even = gamma_even;
+
+    mpi_bcast_lb_params(LBPAR_MRT);
+
+    return TCL_OK;
+}
+
+static int lbfluid_parse_checkpoint(Tcl_Interp *interp, int argc, char *argv[], int *change, int load) {
+    if (argc < 1) {
+	Tcl_AppendResult(interp, load ? "load_checkpoint" : "save_checkpoint", " requires a file name", (char *)NULL);
+	return TCL_ERROR;
+    }
+
+    *change = 1;
+    mpi_lb_checkpoint(argv[0], load);
+
+    return TCL_OK;
+}
 #endif /* LB */
 
 /** Parser for the \ref lbnode command. */
@@ -1862,6 +2477,12 @@ int lbfluid_cmd(ClientData data, Tcl_Interp *interp, int argc, char **argv) {
 	  err = lbfluid_parse_friction(interp, argc-1, argv+1, &change);
       else if (ARG0_IS_S("ext_force"))
 	  err = lbfluid_parse_ext_force(interp, argc-1, argv+1, &change);
+      else if (ARG0_IS_S("mrt"))
+	  err = lbfluid_parse_mrt(interp, argc-1, argv+1, &change);
+      else if (ARG0_IS_S("save_checkpoint"))
+	  err = lbfluid_parse_checkpoint(interp, argc-1, argv+1, &change, 0);
+      else if (ARG0_IS_S("load_checkpoint"))
+	  err = lbfluid_parse_checkpoint(interp, argc-1, argv+1, &change, 1);
       else {
 	  Tcl_AppendResult(interp, "unknown feature \"", argv[0],"\" of lbfluid", (char *)NULL);
 	  err = TCL_ERROR ;
@@ -47,6 +47,7 @@
 #define LBPAR_FRICTION  4 /**< friction coefficient for viscous coupling between particles and fluid */
 #define LBPAR_EXTFORCE  5 /**< external force acting on the fluid */
 #define LBPAR_BULKVISC  6 /**< fluid bulk viscosity */
+#define LBPAR_MRT       7 /**< multiple relaxation time collision */
 /*@}*/
 
 /** Description of the LB Model in terms of the unit vectors of the 
@@ -83,6 +84,10 @@ typedef struct {
   /** local stress tensor */
   double pi[6];
 
+  /** momentum transferred from the particles since the last fluid
+   *  update (lattice units) */
+  double coupling_j[3];
+
   /** local populations of the velocity directions */
   double *n;
 #ifndef D3Q19
@@ -116,7 +121,8 @@ typedef struct {
   double agrid;
 
   /** time step for fluid propagation (LJ units)
-   *  Note: Has to be larger than MD time step! */
+   *  Note: The fluid is updated according to the ratio of tau and the
+   *  MD time step, which may be above or below one. */
   double tau;
 
   /** friction coefficient for viscous coupling (LJ units)
@@ -126,6 +132,15 @@ typedef struct {
 
   /** external force applied to the fluid at each lattice site (LJ units) */
   double ext_force[3];
+
+  /** flag for the multiple relaxation time collision in mode space */
+  int mrt;
+
+  /** relaxation parameter of the odd kinetic (ghost) modes (MRT only) */
+  double gamma_odd;
+
+  /** relaxation parameter of the even kinetic (ghost) modes (MRT only) */
+  double gamma_even;
           
 } LB_Parameters;
 
@@ -144,6 +159,10 @@ extern LB_FluidNode *lbfluid;
 /** Switch indicating momentum exchange between particles and fluid */
 extern int transfer_momentum;
 
+/** Flag indicating that the fluid fields used for the particle coupling
+ *  have to be recalculated */
+extern int update_fluid_fields;
+
 /** Eigenvalue of collision operator corresponding to shear viscosity. */
 //extern double lblambda;
 
@@ -168,6 +187,10 @@ void lb_reinit_parameters();
 /** (Re-)initializes the fluid. */
 void lb_reinit_fluid();
 
+/** (Re-)builds the list of local sites which carry fluid.
+ *  Has to be called whenever the boundary flags change. */
+void lb_init_fluid_sites();
+
 /** Sets the density and momentum on a local lattice site.
  * @param index The index of the lattice site within the local domain (Input)
  * @param rho   Local density of the fluid (Input)
@@ -183,6 +206,22 @@ void lb_set_local_fields(int index, const double rho, const double *v, const dou
  */
 void lb_get_local_fields(int index, double *rho, double *j, double *pi);
 
+/** Writes the populations of the whole fluid and the parameters
+ *  \ref lbpar to a binary checkpoint file. Has to be called on all
+ *  nodes, every node writes its own part of the lattice.
+ * @param filename Name of the checkpoint file (Input)
+ */
+void lb_save_checkpoint(char *filename);
+
+/** Restores the fluid from a checkpoint written by \ref lb_save_checkpoint.
+ *  The fluid is set up for the stored parameters and every node reads
+ *  its own part of the lattice, so the number of nodes may differ
+ *  from the one the checkpoint was written with. The global lattice
+ *  has to match the stored one. Has to be called on all nodes.
+ * @param filename Name of the checkpoint file (Input)
+ */
+void lb_load_checkpoint(char *filename);
+
 /** Propagates the Lattice Boltzmann system for one time step.
  * This function performs the collision step and the streaming step.
  * If external forces are present, they are applied prior to the collisions.
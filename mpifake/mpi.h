@@ -81,6 +81,7 @@ extern struct mpifake_dtype mpifake_dtype_int;
 extern struct mpifake_dtype mpifake_dtype_double;
 extern struct mpifake_dtype mpifake_dtype_byte;
 extern struct mpifake_dtype mpifake_dtype_long;
+extern struct mpifake_dtype mpifake_dtype_float;
 extern struct mpifake_dtype mpifake_dtype_char;
 extern struct mpifake_dtype mpifake_dtype_ub;
 extern struct mpifake_dtype mpifake_dtype_lb;
@@ -89,6 +90,7 @@ extern struct mpifake_dtype mpifake_dtype_lb;
 #define MPI_DOUBLE (&mpifake_dtype_double)
 #define MPI_BYTE   (&mpifake_dtype_byte)
 #define MPI_LONG   (&mpifake_dtype_long)
+#define MPI_FLOAT  (&mpifake_dtype_float)
 #define MPI_CHAR   (&mpifake_dtype_char)
 #define MPI_LB     (&mpifake_dtype_lb)
 #define MPI_UB     (&mpifake_dtype_ub)
@@ -111,6 +113,7 @@ MDINLINE int MPI_Type_extent(MPI_Datatype dtype, MPI_Aint *pextent) { *pextent =
 MDINLINE int MPI_Barrier(MPI_Comm comm) { return MPI_SUCCESS; }
 MDINLINE int MPI_Waitall(int count, MPI_Request *reqs, MPI_Status *stats) { return MPI_SUCCESS; }
 MDINLINE int MPI_Wait(MPI_Request *reqs, MPI_Status *stats) { return MPI_SUCCESS; }
+MDINLINE int MPI_Testall(int count, MPI_Request *reqs, int *flag, MPI_Status *stats) { *flag = 1; return MPI_SUCCESS; }
 MDINLINE int MPI_Errhandler_create(MPI_Handler_function *errfunc, MPI_Errhandler *errhdl) { return MPI_SUCCESS; }
 MDINLINE int MPI_Errhandler_set(MPI_Comm comm, MPI_Errhandler errhdl) { return MPI_SUCCESS; }
 MDINLINE int MPI_Bcast(void *buff, int count, MPI_Datatype datatype, int root, MPI_Comm comm) { return MPI_SUCCESS; }
@@ -149,6 +152,10 @@ MDINLINE int MPI_Gather(void *sbuf, int scount, MPI_Datatype sdtype,
 			void *rbuf, int rcount, MPI_Datatype rdtype,
 			int root, MPI_Comm comm)
 { return mpifake_sendrecv(sbuf, scount, sdtype, rbuf, rcount, rdtype); }
+MDINLINE int MPI_Gatherv(void *sbuf, int scount, MPI_Datatype sdtype,
+			 void *rbuf, int *rcounts, int *displs, MPI_Datatype rdtype,
+			 int root, MPI_Comm comm)
+{ return mpifake_sendrecv(sbuf, scount, sdtype, (char *)rbuf + displs[0]*rdtype->size, rcounts[0], rdtype); }
 MDINLINE int MPI_Allgather(void *sbuf, int scount, MPI_Datatype sdtype,
 			   void *rbuf, int rcount, MPI_Datatype rdtype,
 			   MPI_Comm comm)
@@ -164,4 +171,33 @@ MDINLINE int MPI_Allreduce(void *sbuf, void *rbuf, int count, MPI_Datatype dtype
 { op(sbuf, rbuf, &count, &dtype); return MPI_SUCCESS; }
 MDINLINE int MPI_Error_string(int errcode, char *string, int *len) { *string = 0; *len = 0; return MPI_SUCCESS; }
 
+/* MPI-IO on a single node is plain stdio */
+typedef FILE *MPI_File;
+typedef long long MPI_Offset;
+typedef void *MPI_Info;
+
+#define MPI_INFO_NULL     NULL
+#define MPI_FILE_NULL     NULL
+#define MPI_STATUS_IGNORE NULL
+#define MPI_STATUSES_IGNORE NULL
+
+#define MPI_MODE_CREATE 1
+#define MPI_MODE_RDONLY 2
+#define MPI_MODE_WRONLY 4
+#define MPI_MODE_RDWR   8
+
+#define MPI_ERR_IO 2
+
+int MPI_File_open(MPI_Comm comm, char *filename, int amode, MPI_Info info, MPI_File *fh);
+int MPI_File_close(MPI_File *fh);
+int MPI_File_set_size(MPI_File fh, MPI_Offset size);
+int MPI_File_write_at(MPI_File fh, MPI_Offset offset, void *buf, int count,
+		      MPI_Datatype dtype, MPI_Status *status);
+MDINLINE int MPI_File_write_at_all(MPI_File fh, MPI_Offset offset, void *buf, int count,
+				   MPI_Datatype dtype, MPI_Status *status)
+{ return MPI_File_write_at(fh, offset, buf, count, dtype, status); }
+MDINLINE int MPI_File_iwrite_at(MPI_File fh, MPI_Offset offset, void *buf, int count,
+				MPI_Datatype dtype, MPI_Request *req)
+{ *req = NULL; return MPI_File_write_at(fh, offset, buf, count, dtype, NULL); }
+
 #endif
@@ -0,0 +1,669 @@
+// This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+// It is therefore subject to the ESPResSo license agreement which you accepted upon receiving the distribution
+// and by which you are legally bound while utilizing this file in any form or way.
+// There is NO WARRANTY, not even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// You should have received a copy of that license along with this program;
+// if not, refer to http://www.espresso.mpg.de/license.html where its current version can be found, or
+// write to Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148, 55021 Mainz, Germany.
+// Copyright (c) 2002-2009; all rights reserved unless otherwise stated.
+/** \file mpiio.c
+    Implementation of \ref mpiio.h "mpiio.h".
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include "utils.h"
+#include "mpiio.h"
+#include "global.h"
+#include "communication.h"
+#include "particle_data.h"
+#include "integrate.h"
+#include "parser.h"
+
+/** number of particles that mpiio read sends to the nodes at once */
+#define MPIIO_CHUNK 65536
+
+/************************************************
+ * variables
+ ************************************************/
+
+/** the open trajectory file */
+static MPI_File mpiio_file;
+/** the fields written to \ref mpiio_file, -1 if no file is open */
+static int mpiio_fields = -1;
+/** where the next frame goes */
+static MPI_Offset mpiio_offset;
+/** number of frames written so far */
+static int mpiio_n_frames;
+/** the offsets of the frames, only on the master node */
+static long long *mpiio_frame_offsets = NULL;
+
+/** maximal number of blocks per frame: frame header, identities and
+    the eight fields */
+#define MPIIO_MAX_BLOCKS 10
+
+/** A staging buffer for asynchronous writing. The data of a frame is
+    copied here and written with nonblocking writes, so that the buffer
+    must not be touched until these are completed. */
+typedef struct {
+  /** the copied data */
+  char *data;
+  /** allocated size of data */
+  int max;
+  /** bytes used by the current frame */
+  int used;
+  /** the pending writes */
+  MPI_Request req[MPIIO_MAX_BLOCKS];
+  /** number of pending writes */
+  int n_req;
+} MPIIOStage;
+
+/** the staging buffers, used alternately for subsequent frames */
+static MPIIOStage mpiio_stages[MPIIO_N_STAGES];
+/** the staging buffer of the current frame */
+static int mpiio_stage = 0;
+
+/************************************************
+ * writing
+ ************************************************/
+
+/** wait until all writes from a staging buffer are done. */
+static void mpiio_stage_wait(MPIIOStage *st)
+{
+  if (st->n_req > 0)
+    MPI_Waitall(st->n_req, st->req, MPI_STATUSES_IGNORE);
+  st->n_req = 0;
+}
+
+/** get a buffer for a block of size bytes. In asynchronous mode, this
+    is a part of the staging buffer of the frame. */
+static void *mpiio_block_buffer(int size)
+{
+  MPIIOStage *st = &mpiio_stages[mpiio_stage];
+  void *buf;
+
+  if (!(mpiio_fields & MPIIO_ASYNC))
+    return malloc(size);
+  buf = st->data + st->used;
+  st->used += size;
+  return buf;
+}
+
+/** write a block obtained from \ref mpiio_block_buffer. Only in
+    synchronous mode, the data has been written when this returns.
+    @param offset     file offset
+    @param buf        the data
+    @param count      number of elements in buf
+    @param type       their MPI data type
+    @param collective whether all nodes write, otherwise only this one
+*/
+static void mpiio_write_block(MPI_Offset offset, void *buf, int count,
+			      MPI_Datatype type, int collective)
+{
+  MPIIOStage *st = &mpiio_stages[mpiio_stage];
+
+  if (mpiio_fields & MPIIO_ASYNC)
+    MPI_File_iwrite_at(mpiio_file, offset, buf, count, type, &st->req[st->n_req++]);
+  else {
+    if (collective)
+      MPI_File_write_at_all(mpiio_file, offset, buf, count, type, MPI_STATUS_IGNORE);
+    else
+      MPI_File_write_at(mpiio_file, offset, buf, count, type, MPI_STATUS_IGNORE);
+    free(buf);
+  }
+}
+
+/** write the integer values of one field. All nodes write collectively.
+    @param base    file offset of the field block
+    @param data    the local values
+    @param start   index of the first local particle in the frame
+    @param n       number of local particles
+    @param n_total number of particles in the frame
+    @return the offset of the next field block
+*/
+static MPI_Offset mpiio_write_ints(MPI_Offset base, int *data, int start, int n, int n_total)
+{
+  int *buf = mpiio_block_buffer(n*sizeof(int));
+
+  memcpy(buf, data, n*sizeof(int));
+  mpiio_write_block(base + (MPI_Offset)start*sizeof(int), buf, n, MPI_INT, 1);
+  return base + (MPI_Offset)n_total*sizeof(int);
+}
+
+/** write the floating point values of one field, in single precision
+    if requested. Parameters as for \ref mpiio_write_ints, dim is the
+    number of values per particle. */
+static MPI_Offset mpiio_write_doubles(MPI_Offset base, double *data, int dim,
+				      int start, int n, int n_total)
+{
+  int i;
+  float *fbuf;
+  double *dbuf;
+
+  if (!(mpiio_fields & PCFG_FLOAT)) {
+    dbuf = mpiio_block_buffer(dim*n*sizeof(double));
+    memcpy(dbuf, data, dim*n*sizeof(double));
+    mpiio_write_block(base + (MPI_Offset)dim*start*sizeof(double), dbuf, dim*n, MPI_DOUBLE, 1);
+    return base + (MPI_Offset)dim*n_total*sizeof(double);
+  }
+
+  fbuf = mpiio_block_buffer(dim*n*sizeof(float));
+  for (i = 0; i < dim*n; i++)
+    fbuf[i] = data[i];
+  mpiio_write_block(base + (MPI_Offset)dim*start*sizeof(float), fbuf, dim*n, MPI_FLOAT, 1);
+  return base + (MPI_Offset)dim*n_total*sizeof(float);
+}
+
+/** number of bytes a field takes in a frame, per particle */
+static int mpiio_frame_bytes(int fields)
+{
+  int prec = (fields & PCFG_FLOAT) ? sizeof(float) : sizeof(double);
+  int size = sizeof(int);
+
+  if (fields & PCFG_POS)    size += 3*prec;
+  if (fields & PCFG_V)      size += 3*prec;
+  if (fields & PCFG_F)      size += 3*prec;
+  if (fields & PCFG_TYPE)   size += sizeof(int);
+  if (fields & PCFG_MOL_ID) size += sizeof(int);
+  if (fields & PCFG_Q)      size += prec;
+  if (fields & PCFG_MASS)   size += prec;
+  if (fields & PCFG_DIP)    size += 3*prec;
+  return size;
+}
+
+int mpiio_open(char *filename, int fields)
+{
+  MPIIOHeader header;
+  int i;
+
+  if (MPI_File_open(MPI_COMM_WORLD, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+		    MPI_INFO_NULL, &mpiio_file) != MPI_SUCCESS)
+    return 0;
+  MPI_File_set_size(mpiio_file, 0);
+
+  mpiio_fields   = fields;
+  mpiio_n_frames = 0;
+  mpiio_offset   = sizeof(MPIIOHeader);
+  mpiio_stage    = 0;
+  for (i = 0; i < MPIIO_N_STAGES; i++) {
+    mpiio_stages[i].used  = 0;
+    mpiio_stages[i].n_req = 0;
+  }
+
+  if (this_node == 0) {
+    memcpy(header.magic, MPIIO_MAGIC, 4*sizeof(char));
+    header.version   = MPIIO_VERSION;
+    header.fields    = fields & ~(PCFG_FLOAT | MPIIO_ASYNC);
+    header.precision = (fields & PCFG_FLOAT) ? sizeof(float) : sizeof(double);
+    MPI_File_write_at(mpiio_file, 0, &header, sizeof(MPIIOHeader), MPI_BYTE, MPI_STATUS_IGNORE);
+  }
+  return 1;
+}
+
+void mpiio_write_frame()
+{
+  PartCfgFields local;
+  MPIIOFrameHeader *frame;
+  MPIIOStage *st = &mpiio_stages[mpiio_stage];
+  MPI_Offset base;
+  int *counts, i, start, n_total, size;
+
+  local_get_particle_fields(mpiio_fields, &local);
+
+  /* where the particles of this node go */
+  counts = malloc(n_nodes*sizeof(int));
+  MPI_Allgather(&local.n, 1, MPI_INT, counts, 1, MPI_INT, MPI_COMM_WORLD);
+  start = n_total = 0;
+  for (i = 0; i < n_nodes; i++) {
+    if (i < this_node)
+      start += counts[i];
+    n_total += counts[i];
+  }
+  free(counts);
+
+  if (mpiio_fields & MPIIO_ASYNC) {
+    /* the buffer can only be reused if the frame before the last one
+       has been written completely */
+    mpiio_stage_wait(st);
+    size = local.n*mpiio_frame_bytes(mpiio_fields) + sizeof(MPIIOFrameHeader);
+    if (size > st->max) {
+      st->max  = size;
+      st->data = realloc(st->data, size);
+    }
+    st->used = 0;
+  }
+
+  if (this_node == 0) {
+    frame = mpiio_block_buffer(sizeof(MPIIOFrameHeader));
+    frame->n_part = n_total;
+    frame->pad    = 0;
+    frame->time   = sim_time;
+    mpiio_write_block(mpiio_offset, frame, sizeof(MPIIOFrameHeader), MPI_BYTE, 0);
+
+    mpiio_frame_offsets = realloc(mpiio_frame_offsets, (mpiio_n_frames + 1)*sizeof(long long));
+    mpiio_frame_offsets[mpiio_n_frames] = mpiio_offset;
+  }
+  mpiio_n_frames++;
+
+  base = mpiio_offset + sizeof(MPIIOFrameHeader);
+  base = mpiio_write_ints(base, local.identity, start, local.n, n_total);
+  if (mpiio_fields & PCFG_POS)
+    base = mpiio_write_doubles(base, local.pos, 3, start, local.n, n_total);
+  if (mpiio_fields & PCFG_V)
+    base = mpiio_write_doubles(base, local.v, 3, start, local.n, n_total);
+  if (mpiio_fields & PCFG_F)
+    base = mpiio_write_doubles(base, local.f, 3, start, local.n, n_total);
+  if (mpiio_fields & PCFG_TYPE)
+    base = mpiio_write_ints(base, local.type, start, local.n, n_total);
+  if (mpiio_fields & PCFG_MOL_ID)
+    base = mpiio_write_ints(base, local.mol_id, start, local.n, n_total);
+  if (mpiio_fields & PCFG_Q)
+    base = mpiio_write_doubles(base, local.q, 1, start, local.n, n_total);
+  if (mpiio_fields & PCFG_MASS)
+    base = mpiio_write_doubles(base, local.mass, 1, start, local.n, n_total);
+  if (mpiio_fields & PCFG_DIP)
+    base = mpiio_write_doubles(base, local.dip, 3, start, local.n, n_total);
+  mpiio_offset = base;
+  mpiio_stage  = (mpiio_stage + 1) % MPIIO_N_STAGES;
+
+  free_particle_fields(&local);
+}
+
+int mpiio_pending()
+{
+  int i, flag, pending = 0;
+
+  for (i = 0; i < MPIIO_N_STAGES; i++) {
+    if (mpiio_stages[i].n_req == 0)
+      continue;
+    MPI_Testall(mpiio_stages[i].n_req, mpiio_stages[i].req, &flag, MPI_STATUSES_IGNORE);
+    if (flag)
+      mpiio_stages[i].n_req = 0;
+    else
+      pending++;
+  }
+  return pending;
+}
+
+void mpiio_wait()
+{
+  int i;
+  for (i = 0; i < MPIIO_N_STAGES; i++)
+    mpiio_stage_wait(&mpiio_stages[i]);
+}
+
+void mpiio_close()
+{
+  MPIIOFooter footer;
+  int i;
+
+  mpiio_wait();
+  for (i = 0; i < MPIIO_N_STAGES; i++) {
+    free(mpiio_stages[i].data);
+    mpiio_stages[i].data = NULL;
+    mpiio_stages[i].max  = 0;
+  }
+
+  if (this_node == 0) {
+    MPI_File_write_at(mpiio_file, mpiio_offset, mpiio_frame_offsets,
+		      mpiio_n_frames*sizeof(long long), MPI_BYTE, MPI_STATUS_IGNORE);
+    footer.n_frames = mpiio_n_frames;
+    memcpy(footer.magic, MPIIO_INDEX_MAGIC, 4*sizeof(char));
+    footer.pad = 0;
+    MPI_File_write_at(mpiio_file, mpiio_offset + mpiio_n_frames*sizeof(long long),
+		      &footer, sizeof(MPIIOFooter), MPI_BYTE, MPI_STATUS_IGNORE);
+    free(mpiio_frame_offsets);
+    mpiio_frame_offsets = NULL;
+  }
+  MPI_File_close(&mpiio_file);
+  mpiio_fields = -1;
+}
+
+/************************************************
+ * reading
+ ************************************************/
+
+/** open a trajectory file for reading and check header and footer. */
+static FILE *mpiio_open_read(Tcl_Interp *interp, char *filename,
+			     MPIIOHeader *header, MPIIOFooter *footer)
+{
+  FILE *f;
+
+  if (!(f = fopen(filename, "rb"))) {
+    Tcl_AppendResult(interp, "could not open \"", filename, "\"", (char *) NULL);
+    return NULL;
+  }
+  if (fread(header, sizeof(MPIIOHeader), 1, f) != 1 ||
+      strncmp(header->magic, MPIIO_MAGIC, 4) || header->version != MPIIO_VERSION ||
+      fseek(f, -(long)sizeof(MPIIOFooter), SEEK_END) != 0 ||
+      fread(footer, sizeof(MPIIOFooter), 1, f) != 1 ||
+      strncmp(footer->magic, MPIIO_INDEX_MAGIC, 4) ||
+      (header->precision != sizeof(float) && header->precision != sizeof(double))) {
+    Tcl_AppendResult(interp, "\"", filename, "\" is not a complete trajectory file",
+		     (char *) NULL);
+    fclose(f);
+    return NULL;
+  }
+  return f;
+}
+
+/** read the integer values of the particles start...start+n-1 of a field block.
+    @return 0 if the file is too short. */
+static int mpiio_read_ints(FILE *f, long base, int start, int n, int *dst)
+{
+  if (fseek(f, base + (long)start*sizeof(int), SEEK_SET) != 0)
+    return 0;
+  return fread(dst, sizeof(int), n, f) == n;
+}
+
+/** read the floating point values of the particles start...start+n-1 of
+    a field block, converting them to double.
+    @return 0 if the file is too short. */
+static int mpiio_read_doubles(FILE *f, long base, int dim, int precision,
+			      int start, int n, double *dst)
+{
+  int i, ok;
+  float *buf;
+
+  if (fseek(f, base + (long)dim*start*precision, SEEK_SET) != 0)
+    return 0;
+  if (precision == sizeof(double))
+    return fread(dst, sizeof(double), dim*n, f) == dim*n;
+
+  buf = malloc(dim*n*sizeof(float));
+  ok = (fread(buf, sizeof(float), dim*n, f) == dim*n);
+  for (i = 0; ok && i < dim*n; i++)
+    dst[i] = buf[i];
+  free(buf);
+  return ok;
+}
+
+static int mpiio_parse_read(Tcl_Interp *interp, int argc, char **argv)
+{
+  /* 'mpiio read <file> [<frame>]' */
+  MPIIOHeader header;
+  MPIIOFooter footer;
+  MPIIOFrameHeader frame;
+  FILE *f;
+  Particle *chunk;
+  double *buf;
+  int *ibuf;
+  long long offset;
+  long base;
+  int i, j, n, start, frame_no = -1, fields = 0, prec, ok = 1;
+  char buffer[TCL_DOUBLE_SPACE];
+
+  if (argc < 1 || argc > 2) {
+    Tcl_AppendResult(interp, "usage: mpiio read <file> [<frame>]", (char *) NULL);
+    return TCL_ERROR;
+  }
+  if (argc == 2 && !ARG1_IS_I(frame_no))
+    return TCL_ERROR;
+
+  if (!(f = mpiio_open_read(interp, argv[0], &header, &footer)))
+    return TCL_ERROR;
+
+  /* negative frame numbers count from the end */
+  if (frame_no < 0)
+    frame_no += footer.n_frames;
+  if (frame_no < 0 || frame_no >= footer.n_frames) {
+    Tcl_AppendResult(interp, "frame does not exist", (char *) NULL);
+    fclose(f);
+    return TCL_ERROR;
+  }
+  if (fseek(f, -(long)(sizeof(MPIIOFooter) + (footer.n_frames - frame_no)*sizeof(long long)), SEEK_END) != 0 ||
+      fread(&offset, sizeof(long long), 1, f) != 1 ||
+      offset < (long long)sizeof(MPIIOHeader) ||
+      fseek(f, offset, SEEK_SET) != 0 ||
+      fread(&frame, sizeof(MPIIOFrameHeader), 1, f) != 1 ||
+      frame.n_part < 0) {
+    Tcl_AppendResult(interp, "\"", argv[0], "\" is corrupt, cannot read the frame header",
+		     (char *) NULL);
+    fclose(f);
+    return TCL_ERROR;
+  }
+
+  if (header.fields & PCFG_POS)    fields |= PART_BULK_POS;
+  if (header.fields & PCFG_V)      fields |= PART_BULK_V;
+  if (header.fields & PCFG_F)      fields |= PART_BULK_F;
+  if (header.fields & PCFG_TYPE)   fields |= PART_BULK_TYPE;
+  if (header.fields & PCFG_MOL_ID) fields |= PART_BULK_MOL_ID;
+#ifdef ELECTROSTATICS
+  if (header.fields & PCFG_Q)      fields |= PART_BULK_Q;
+#endif
+#ifdef MASS
+  if (header.fields & PCFG_MASS)   fields |= PART_BULK_MASS;
+#endif
+#ifdef DIPOLES
+  if (header.fields & PCFG_DIP)    fields |= PART_BULK_DIP;
+#endif
+  prec = header.precision;
+
+  /* the particles are sent to the nodes in chunks */
+  chunk = malloc(MPIIO_CHUNK*sizeof(Particle));
+  buf   = malloc(3*MPIIO_CHUNK*sizeof(double));
+  ibuf  = malloc(MPIIO_CHUNK*sizeof(int));
+  for (start = 0; start < frame.n_part; start += MPIIO_CHUNK) {
+    n = frame.n_part - start;
+    if (n > MPIIO_CHUNK)
+      n = MPIIO_CHUNK;
+    memset(chunk, 0, n*sizeof(Particle));
+
+    base = offset + sizeof(MPIIOFrameHeader);
+    ok = ok && mpiio_read_ints(f, base, start, n, ibuf);
+    for (i = 0; i < n; i++)
+      chunk[i].p.identity = ibuf[i];
+    base += (long)frame.n_part*sizeof(int);
+
+    if (header.fields & PCFG_POS) {
+      ok = ok && mpiio_read_doubles(f, base, 3, prec, start, n, buf);
+      for (i = 0; i < n; i++)
+	for (j = 0; j < 3; j++)
+	  chunk[i].r.p[j] = buf[3*i+j];
+      base += (long)3*frame.n_part*prec;
+    }
+    if (header.fields & PCFG_V) {
+      ok = ok && mpiio_read_doubles(f, base, 3, prec, start, n, buf);
+      for (i = 0; i < n; i++)
+	for (j = 0; j < 3; j++)
+	  chunk[i].m.v[j] = buf[3*i+j];
+      base += (long)3*frame.n_part*prec;
+    }
+    if (header.fields & PCFG_F) {
+      ok = ok && mpiio_read_doubles(f, base, 3, prec, start, n, buf);
+      for (i = 0; i < n; i++)
+	for (j = 0; j < 3; j++)
+	  chunk[i].f.f[j] = buf[3*i+j];
+      base += (long)3*frame.n_part*prec;
+    }
+    if (header.fields & PCFG_TYPE) {
+      ok = ok && mpiio_read_ints(f, base, start, n, ibuf);
+      for (i = 0; i < n; i++)
+	chunk[i].p.type = ibuf[i];
+      base += (long)frame.n_part*sizeof(int);
+    }
+    if (header.fields & PCFG_MOL_ID) {
+      ok = ok && mpiio_read_ints(f, base, start, n, ibuf);
+      for (i = 0; i < n; i++)
+	chunk[i].p.mol_id = ibuf[i];
+      base += (long)frame.n_part*sizeof(int);
+    }
+    if (header.fields & PCFG_Q) {
+#ifdef ELECTROSTATICS
+      ok = ok && mpiio_read_doubles(f, base, 1, prec, start, n, buf);
+      for (i = 0; i < n; i++)
+	chunk[i].p.q = buf[i];
+#endif
+      base += (long)frame.n_part*prec;
+    }
+    if (header.fields & PCFG_MASS) {
+#ifdef MASS
+      ok = ok && mpiio_read_doubles(f, base, 1, prec, start, n, buf);
+      for (i = 0; i < n; i++)
+	chunk[i].p.mass = buf[i];
+#endif
+      base += (long)frame.n_part*prec;
+    }
+    if (header.fields & PCFG_DIP) {
+#ifdef DIPOLES
+      ok = ok && mpiio_read_doubles(f, base, 3, prec, start, n, buf);
+      for (i = 0; i < n; i++)
+	for (j = 0; j < 3; j++)
+	  chunk[i].r.dip[j] = buf[3*i+j];
+#endif
+      base += (long)3*frame.n_part*prec;
+    }
+
+    if (!ok) {
+      Tcl_AppendResult(interp, "\"", argv[0], "\" is truncated, cannot read the particle data",
+		       (char *) NULL);
+      free(ibuf);
+      free(buf);
+      free(chunk);
+      fclose(f);
+      return TCL_ERROR;
+    }
+
+    if (place_particles(n, chunk, fields) == TCL_ERROR) {
+      Tcl_AppendResult(interp, "new particle without position data", (char *) NULL);
+      free(ibuf);
+      free(buf);
+      free(chunk);
+      fclose(f);
+      return TCL_ERROR;
+    }
+  }
+  free(ibuf);
+  free(buf);
+  free(chunk);
+  fclose(f);
+
+  Tcl_PrintDouble(interp, frame.time, buffer);
+  Tcl_AppendResult(interp, buffer, (char *) NULL);
+  return TCL_OK;
+}
+
+static int mpiio_parse_frames(Tcl_Interp *interp, int argc, char **argv)
+{
+  /* 'mpiio frames <file>' */
+  MPIIOHeader header;
+  MPIIOFooter footer;
+  FILE *f;
+  char buffer[TCL_INTEGER_SPACE];
+
+  if (argc != 1) {
+    Tcl_AppendResult(interp, "usage: mpiio frames <file>", (char *) NULL);
+    return TCL_ERROR;
+  }
+  if (!(f = mpiio_open_read(interp, argv[0], &header, &footer)))
+    return TCL_ERROR;
+  fclose(f);
+
+  sprintf(buffer, "%lld", footer.n_frames);
+  Tcl_AppendResult(interp, buffer, (char *) NULL);
+  return TCL_OK;
+}
+
+/************************************************
+ * Tcl interface
+ ************************************************/
+
+static int mpiio_parse_open(Tcl_Interp *interp, int argc, char **argv)
+{
+  /* 'mpiio open <file> [pos|v|f|type|molecule_id|q|mass|dip|float|async]*' */
+  int fields = 0;
+  char *filename;
+
+  if (argc < 1) {
+    Tcl_AppendResult(interp, "usage: mpiio open <file> [pos|v|f|type|molecule_id|q|mass|dip|float|async]*",
+		     (char *) NULL);
+    return TCL_ERROR;
+  }
+  if (mpiio_fields != -1) {
+    Tcl_AppendResult(interp, "a trajectory file is already open", (char *) NULL);
+    return TCL_ERROR;
+  }
+  filename = argv[0];
+  argc--; argv++;
+
+  while (argc > 0) {
+    if (ARG0_IS_S("pos"))
+      fields |= PCFG_POS;
+    else if (ARG0_IS_S("v"))
+      fields |= PCFG_V;
+    else if (ARG0_IS_S("f"))
+      fields |= PCFG_F;
+    else if (ARG0_IS_S("type"))
+      fields |= PCFG_TYPE;
+    else if (ARG0_IS_S("molecule_id"))
+      fields |= PCFG_MOL_ID;
+    else if (ARG0_IS_S("q"))
+      fields |= PCFG_Q;
+    else if (ARG0_IS_S("mass"))
+      fields |= PCFG_MASS;
+    else if (ARG0_IS_S("dip"))
+      fields |= PCFG_DIP;
+    else if (ARG0_IS_S("float"))
+      fields |= PCFG_FLOAT;
+    else if (ARG0_IS_S("async"))
+      fields |= MPIIO_ASYNC;
+    else {
+      Tcl_AppendResult(interp, "no particle data field \"", argv[0], "\"?", (char *) NULL);
+      return TCL_ERROR;
+    }
+    argc--; argv++;
+  }
+  /* positions if nothing else was given */
+  if ((fields & ~(PCFG_FLOAT | MPIIO_ASYNC)) == 0)
+    fields |= PCFG_POS;
+
+  if (!mpi_mpiio(MPIIO_OPEN, filename, fields)) {
+    Tcl_AppendResult(interp, "could not open \"", filename, "\"", (char *) NULL);
+    return TCL_ERROR;
+  }
+  return TCL_OK;
+}
+
+int mpiio(ClientData data, Tcl_Interp *interp,
+	  int argc, char **argv)
+{
+  char buffer[TCL_INTEGER_SPACE];
+
+  if (argc < 2) {
+    Tcl_AppendResult(interp, "usage: mpiio open|write|close|pending|wait|frames|read ...", (char *) NULL);
+    return TCL_ERROR;
+  }
+
+  if (ARG1_IS_S("open"))
+    return mpiio_parse_open(interp, argc - 2, argv + 2);
+  else if (ARG1_IS_S("frames"))
+    return mpiio_parse_frames(interp, argc - 2, argv + 2);
+  else if (ARG1_IS_S("read"))
+    return mpiio_parse_read(interp, argc - 2, argv + 2);
+  else if (ARG1_IS_S("write") || ARG1_IS_S("close") ||
+	   ARG1_IS_S("pending") || ARG1_IS_S("wait")) {
+    if (argc != 2) {
+      Tcl_AppendResult(interp, "usage: mpiio write|close|pending|wait", (char *) NULL);
+      return TCL_ERROR;
+    }
+    if (mpiio_fields == -1) {
+      Tcl_AppendResult(interp, "no trajectory file open", (char *) NULL);
+      return TCL_ERROR;
+    }
+    if (ARG1_IS_S("write"))
+      mpi_mpiio(MPIIO_WRITE, NULL, 0);
+    else if (ARG1_IS_S("close"))
+      mpi_mpiio(MPIIO_CLOSE, NULL, 0);
+    else if (ARG1_IS_S("wait"))
+      mpi_mpiio(MPIIO_WAIT, NULL, 0);
+    else {
+      sprintf(buffer, "%d", mpi_mpiio(MPIIO_PENDING, NULL, 0));
+      Tcl_AppendResult(interp, buffer, (char *) NULL);
+    }
+    return TCL_OK;
+  }
+
+  Tcl_AppendResult(interp, "unknown mpiio command \"", argv[1], "\"", (char *) NULL);
+  return TCL_ERROR;
+}
@@ -0,0 +1,134 @@
+// This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+// It is therefore subject to the ESPResSo license agreement which you accepted upon receiving the distribution
+// and by which you are legally bound while utilizing this file in any form or way.
+// There is NO WARRANTY, not even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// You should have received a copy of that license along with this program;
+// if not, refer to http://www.espresso.mpg.de/license.html where its current version can be found, or
+// write to Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148, 55021 Mainz, Germany.
+// Copyright (c) 2002-2009; all rights reserved unless otherwise stated.
+#ifndef MPIIO_H
+#define MPIIO_H
+/** \file mpiio.h
+    Parallel binary trajectory files. In contrast to \ref binary_file.h
+    "writemd", the particle data is not collected on the master node,
+    but every node writes its own particles directly into the shared
+    file using collective MPI-IO writes. THE FILE FORMAT IS HARDWARE
+    DEPENDENT, SINCE RAW DATA TYPES ARE WRITTEN!!!
+
+    <p>
+    The file format consists of the following:
+    <ol>
+    <li> \ref MPIIOHeader with \ref MPIIOHeader::magic set to \ref MPIIO_MAGIC
+    ("ESPT") without trailing 0. It gives the fields (or'ed \ref PCFG_POS etc.)
+    that each frame contains and the size of the floating point values.
+    <li> the frames. Each frame starts with a \ref MPIIOFrameHeader, followed by
+    \ref MPIIOFrameHeader::n_part integer particle identities. Then come
+    the blocks of the fields in the order of their flags, each with the
+    values for the particles in the same order as the identities. Vectors
+    are stored as consecutive triples, types and molecule ids are integers,
+    everything else has the precision given in the header.
+    <li> the frame index, that is the file offsets of all frames as long longs,
+    <li> the \ref MPIIOFooter with the number of frames and \ref
+    MPIIOFooter::magic set to \ref MPIIO_INDEX_MAGIC ("ESPI").
+    </ol>
+    Positions are unfolded. Velocities and forces are stored as they
+    are used internally, i.e. scaled by the time step as in \ref
+    binary_file.h "writemd".
+
+    <p>
+    If the file is opened with \ref MPIIO_ASYNC, the frames are copied
+    into one of \ref MPIIO_N_STAGES staging buffers and written with
+    nonblocking writes, so that the simulation can continue while the
+    data goes to disk. A staging buffer is reused only after the writes
+    from it have completed, i.e. writing a frame blocks only if the
+    frame written \ref MPIIO_N_STAGES frames before is still pending.
+*/
+#include <tcl.h>
+
+/** This string is to be put in the \ref MPIIOHeader::magic field. */
+#define MPIIO_MAGIC "ESPT"
+/** This string is to be put in the \ref MPIIOFooter::magic field. */
+#define MPIIO_INDEX_MAGIC "ESPI"
+/** version of the file format */
+#define MPIIO_VERSION 1
+
+/** open flag for asynchronous writing, or'ed to the fields. */
+#define MPIIO_ASYNC 4096
+/** number of frames that can be written in the background */
+#define MPIIO_N_STAGES 2
+
+/** \name Jobs for \ref mpi_mpiio */
+/*@{*/
+/** open a file for writing */
+#define MPIIO_OPEN  0
+/** append a frame */
+#define MPIIO_WRITE 1
+/** write the frame index and close the file */
+#define MPIIO_CLOSE 2
+/** query the number of frames still being written */
+#define MPIIO_PENDING 3
+/** wait until all frames are written */
+#define MPIIO_WAIT 4
+/*@}*/
+
+/** The header of the file. */
+typedef struct {
+  /** Magic Identifier. Must be \ref MPIIO_MAGIC without trailing 0. */
+  char magic[4];
+  /** \ref MPIIO_VERSION */
+  int version;
+  /** the fields contained in each frame, or'ed \ref PCFG_POS etc. */
+  int fields;
+  /** size of the floating point values, 4 or 8. */
+  int precision;
+} MPIIOHeader;
+
+/** The header of a frame. */
+typedef struct {
+  /** number of particles in the frame */
+  int n_part;
+  int pad;
+  /** simulation time of the frame */
+  double time;
+} MPIIOFrameHeader;
+
+/** The last bytes of the file. */
+typedef struct {
+  /** number of frames, the frame index is in front of the footer */
+  long long n_frames;
+  /** Magic Identifier. Must be \ref MPIIO_INDEX_MAGIC without trailing 0. */
+  char magic[4];
+  int pad;
+} MPIIOFooter;
+
+/** \name Exported Functions */
+/*@{*/
+/** Implements the mpiio Tcl command. */
+int mpiio(ClientData data, Tcl_Interp *interp,
+	  int argc, char **argv);
+
+/** Open a trajectory file on all nodes. Called by \ref mpi_mpiio.
+    @param filename the file to write to
+    @param fields   or'ed \ref PCFG_POS etc., \ref PCFG_FLOAT for single precision,
+                    \ref MPIIO_ASYNC for asynchronous writing
+    @return 1 on success, 0 if the file could not be opened
+*/
+int mpiio_open(char *filename, int fields);
+
+/** Write the current configuration as a new frame. Called by \ref mpi_mpiio. */
+void mpiio_write_frame();
+
+/** Test for completion of asynchronous writes. Called by \ref mpi_mpiio.
+    @return the number of frames on this node that are not yet written
+*/
+int mpiio_pending();
+
+/** Wait for all asynchronous writes to complete. Called by \ref mpi_mpiio. */
+void mpiio_wait();
+
+/** Wait for all writes, write the frame index and close the file.
+    Called by \ref mpi_mpiio. */
+void mpiio_close();
+/*@}*/
+
+#endif
@@ -221,7 +221,7 @@ void nsq_balance_particles()
   free(ppnode);
 }
 
-/** nonbonded and bonded force calculation using the verlet list */
+/** nonbonded force calculation (and constraints) using the verlet list */
 void nsq_calculate_ia()
 {
   Particle *partl, *partg;
@@ -232,10 +232,9 @@ void nsq_calculate_ia()
   npl   = local->n;
   partl = local->part;
 
-  /* calculate bonded interactions and non bonded node-node */
+  /* calculate constraints and non bonded node-node */
   for (p = 0; p < npl; p++) {
     pt1 = &partl[p];
-    add_bonded_force(pt1);
 #ifdef CONSTRAINTS
     add_constraints_forces(pt1);
 #endif
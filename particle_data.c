@@ -54,6 +54,7 @@ int max_local_particles = 0;
 Particle **local_particles = NULL;
 Particle *partCfg = NULL;
 int partCfgSorted = 0;
+PartCfgFields partCfgFields = { 0, -1, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
 
 /** bondlist for partCfg, if bonds are needed */
 IntList partCfg_bl = { NULL, 0, 0 };
@@ -103,6 +104,10 @@ void init_particle(Particle *part)
   part->p.q        = 0.0;
 #endif
 
+#ifdef EXTERNAL_FORCES
+  part->p.ext_flag = 0;
+#endif
+
   /* ParticlePosition */
   part->r.p[0]     = 0.0;
   part->r.p[1]     = 0.0;
@@ -161,7 +166,6 @@ void init_particle(Particle *part)
   part->l.i[2]       = 0;
 
 #ifdef EXTERNAL_FORCES
-  part->l.ext_flag   = 0;
   part->l.ext_force[0] = 0.0;
   part->l.ext_force[1] = 0.0;
   part->l.ext_force[2] = 0.0;
@@ -257,6 +261,123 @@ void freePartCfg()
   realloc_intlist(&partCfg_bl, 0);
 }
 
+void alloc_particle_fields(PartCfgFields *cfg, int fields, int n)
+{
+  cfg->fields   = fields;
+  cfg->n        = n;
+  cfg->identity = malloc(n*sizeof(int));
+  cfg->type     = (fields & PCFG_TYPE)   ? malloc(n*sizeof(int))      : NULL;
+  cfg->mol_id   = (fields & PCFG_MOL_ID) ? malloc(n*sizeof(int))      : NULL;
+  cfg->pos      = (fields & PCFG_POS)    ? malloc(3*n*sizeof(double)) : NULL;
+  cfg->v        = (fields & PCFG_V)      ? malloc(3*n*sizeof(double)) : NULL;
+  cfg->f        = (fields & PCFG_F)      ? malloc(3*n*sizeof(double)) : NULL;
+  cfg->q        = (fields & PCFG_Q)      ? malloc(n*sizeof(double))   : NULL;
+  cfg->mass     = (fields & PCFG_MASS)   ? malloc(n*sizeof(double))   : NULL;
+  cfg->dip      = (fields & PCFG_DIP)    ? malloc(3*n*sizeof(double)) : NULL;
+  cfg->isVirtual = (fields & PCFG_VIRTUAL) ? malloc(n*sizeof(int))    : NULL;
+}
+
+void free_particle_fields(PartCfgFields *cfg)
+{
+  free(cfg->identity); cfg->identity = NULL;
+  free(cfg->type);     cfg->type = NULL;
+  free(cfg->mol_id);   cfg->mol_id = NULL;
+  free(cfg->pos);      cfg->pos = NULL;
+  free(cfg->v);        cfg->v = NULL;
+  free(cfg->f);        cfg->f = NULL;
+  free(cfg->q);        cfg->q = NULL;
+  free(cfg->mass);     cfg->mass = NULL;
+  free(cfg->dip);      cfg->dip = NULL;
+  free(cfg->isVirtual); cfg->isVirtual = NULL;
+  cfg->fields = 0;
+  cfg->n = -1;
+}
+
+void local_get_particle_fields(int fields, PartCfgFields *local)
+{
+  int i, j, c, g;
+  Particle *part;
+
+  alloc_particle_fields(local, fields, cells_get_n_particles());
+  g = 0;
+  for (c = 0; c < local_cells.n; c++) {
+    part = local_cells.cell[c]->part;
+    for (i = 0; i < local_cells.cell[c]->n; i++, g++) {
+      Particle *p = &part[i];
+      local->identity[g] = p->p.identity;
+      if (fields & PCFG_TYPE)
+	local->type[g] = p->p.type;
+      if (fields & PCFG_MOL_ID)
+	local->mol_id[g] = p->p.mol_id;
+      if (fields & PCFG_POS) {
+	double ppos[3];
+	int img[3];
+	memcpy(ppos, p->r.p, 3*sizeof(double));
+	memcpy(img, p->l.i, 3*sizeof(int));
+	unfold_position(ppos, img);
+	for (j = 0; j < 3; j++)
+	  local->pos[3*g+j] = ppos[j];
+      }
+      for (j = 0; j < 3; j++) {
+	if (fields & PCFG_V)
+	  local->v[3*g+j] = p->m.v[j];
+	if (fields & PCFG_F)
+	  local->f[3*g+j] = p->f.f[j];
+	if (fields & PCFG_DIP) {
+#ifdef DIPOLES
+	  local->dip[3*g+j] = p->r.dip[j];
+#else
+	  local->dip[3*g+j] = 0;
+#endif
+	}
+      }
+      if (fields & PCFG_Q) {
+#ifdef ELECTROSTATICS
+	local->q[g] = p->p.q;
+#else
+	local->q[g] = 0;
+#endif
+      }
+      if (fields & PCFG_MASS)
+	local->mass[g] = PMASS(*p);
+      if (fields & PCFG_VIRTUAL) {
+#ifdef VIRTUAL_SITES
+	local->isVirtual[g] = p->p.isVirtual;
+#else
+	local->isVirtual[g] = 0;
+#endif
+      }
+    }
+  }
+}
+
+void updatePartCfgFields(int fields)
+{
+  int have = partCfgFields.fields;
+
+#ifdef VIRTUAL_SITES_COM
+  if (fields & PCFG_POS)
+    fields |= PCFG_MOL_ID | PCFG_MASS | PCFG_VIRTUAL;
+#endif
+
+  if (partCfgFields.n >= 0 &&
+      (have & fields & ~PCFG_FLOAT) == (fields & ~PCFG_FLOAT) &&
+      (!(have & PCFG_FLOAT) || (fields & PCFG_FLOAT)))
+    return;
+
+  freePartCfgFields();
+  mpi_get_particle_fields(fields, &partCfgFields);
+#ifdef VIRTUAL_SITES_COM
+  if (fields & PCFG_POS)
+    update_mol_pos_cfg_fields(&partCfgFields);
+#endif
+}
+
+void freePartCfgFields()
+{
+  free_particle_fields(&partCfgFields);
+}
+
 /** resize \ref local_particles.
     \param part the highest existing particle
 */
@@ -724,7 +845,7 @@ void part_print_fix(Particle *part, char *buffer, Tcl_Interp *interp)
 {
   int i;
   for (i = 0; i < 3; i++) {
-    if (part->l.ext_flag & COORD_FIXED(i))
+    if (part->p.ext_flag & COORD_FIXED(i))
       Tcl_AppendResult(interp, "1 ", (char *)NULL);
     else
 	    Tcl_AppendResult(interp, "0 ", (char *)NULL);
@@ -733,7 +854,7 @@ void part_print_fix(Particle *part, char *buffer, Tcl_Interp *interp)
 
 void part_print_ext_force(Particle *part, char *buffer, Tcl_Interp *interp)
 {
-  if(part->l.ext_flag & PARTICLE_EXT_FORCE) {
+  if(part->p.ext_flag & PARTICLE_EXT_FORCE) {
     Tcl_PrintDouble(interp, part->l.ext_force[0], buffer);
 	  Tcl_AppendResult(interp, buffer, " ", (char *)NULL);
 	  Tcl_PrintDouble(interp, part->l.ext_force[1], buffer);
@@ -827,13 +948,13 @@ int printParticleToResult(Tcl_Interp *interp, int part_num)
 
 #ifdef EXTERNAL_FORCES
   /* print external force information. */
-  if (part.l.ext_flag & PARTICLE_EXT_FORCE) {
+  if (part.p.ext_flag & PARTICLE_EXT_FORCE) {
     Tcl_AppendResult(interp, " ext_force ", (char *)NULL);
     part_print_ext_force(&part, buffer, interp);
   }
 
   /* print fix information. */
-  if (part.l.ext_flag & COORDS_FIX_MASK) {
+  if (part.p.ext_flag & COORDS_FIX_MASK) {
     Tcl_AppendResult(interp, " fix ", (char *)NULL);
     part_print_fix(&part, buffer, interp);
   }
@@ -1033,6 +1154,246 @@ int part_cmd_delete(Tcl_Interp *interp, int argc, char **argv,
   return TCL_OK;
 }
 
+/** parse the values of one property for part bulk, dim values per particle */
+static int part_bulk_parse_values(Tcl_Interp *interp, char *name, char *list,
+				  int n, int dim, DoubleList *dl)
+{
+  if (!parse_double_list(interp, list, dl))
+    return TCL_ERROR;
+  if (dl->n != n*dim) {
+    char buffer[32 + 2*TCL_INTEGER_SPACE];
+    sprintf(buffer, " requires %d values, got %d", n*dim, dl->n);
+    Tcl_AppendResult(interp, "part bulk: ", name, buffer, (char *) NULL);
+    return TCL_ERROR;
+  }
+  return TCL_OK;
+}
+
+/** parse the integer values of one property for part bulk, one per particle */
+static int part_bulk_parse_ints(Tcl_Interp *interp, char *name, char *list,
+				int n, IntList *il)
+{
+  if (!parse_int_list(interp, list, il))
+    return TCL_ERROR;
+  if (il->n != n) {
+    char buffer[32 + 2*TCL_INTEGER_SPACE];
+    sprintf(buffer, " requires %d values, got %d", n, il->n);
+    Tcl_AppendResult(interp, "part bulk: ", name, buffer, (char *) NULL);
+    return TCL_ERROR;
+  }
+  return TCL_OK;
+}
+
+/** parse the bonds of one particle for part bulk */
+static int part_bulk_parse_bonds(Tcl_Interp *interp, char *list, IntList *bl)
+{
+  int b, j, n_partners, tmp_argc, tmp2_argc, err = TCL_OK;
+  char **tmp_argv, **tmp2_argv;
+
+  if (Tcl_SplitList(interp, list, &tmp_argc, &tmp_argv) == TCL_ERROR)
+    return TCL_ERROR;
+
+  for (b = 0; b < tmp_argc && err == TCL_OK; b++) {
+    if (Tcl_SplitList(interp, tmp_argv[b], &tmp2_argc, &tmp2_argv) == TCL_ERROR) {
+      err = TCL_ERROR;
+      break;
+    }
+    if (tmp2_argc < 1 ||
+	Tcl_GetInt(interp, tmp2_argv[0], &j) == TCL_ERROR ||
+	j < 0 || j >= n_bonded_ia) {
+      Tcl_ResetResult(interp);
+      Tcl_AppendResult(interp, "part bulk: invalid bonded interaction type_num"
+		       " (set bonded interaction parameters first)", (char *) NULL);
+      err = TCL_ERROR;
+    }
+    else if (tmp2_argc != 1 + (n_partners = bonded_ia_params[j].num)) {
+      char buffer[256 + 2*TCL_INTEGER_SPACE];
+      sprintf(buffer, "part bulk: bond type %d requires %d arguments.",
+	      j, n_partners+1);
+      Tcl_AppendResult(interp, buffer, (char *) NULL);
+      err = TCL_ERROR;
+    }
+    else {
+      realloc_intlist(bl, bl->n + 1 + n_partners);
+      for (j = 0; j <= n_partners; j++)
+	if (Tcl_GetInt(interp, tmp2_argv[j], &bl->e[bl->n + j]) == TCL_ERROR ||
+	    bl->e[bl->n + j] < 0) {
+	  Tcl_ResetResult(interp);
+	  Tcl_AppendResult(interp, "part bulk: invalid bond partner ",
+			   tmp2_argv[j], (char *) NULL);
+	  err = TCL_ERROR;
+	  break;
+	}
+      bl->n += 1 + n_partners;
+    }
+    Tcl_Free((char *)tmp2_argv);
+  }
+
+  Tcl_Free((char *)tmp_argv);
+  return err;
+}
+
+int part_cmd_bulk(Tcl_Interp *interp, int argc, char **argv)
+{
+  int i, n, fields = 0, err = TCL_OK;
+  IntList ids, il;
+  DoubleList dl;
+  Particle *parts;
+
+  if (argc < 1 || argc % 2 != 1) {
+    Tcl_AppendResult(interp, "usage: part bulk <ids> "
+		     "[pos|v|f|type|molecule_id|q|mass|dip|virtual|bond <values>]*",
+		     (char *) NULL);
+    return TCL_ERROR;
+  }
+
+  init_intlist(&ids);
+  if (!ARG0_IS_INTLIST(ids)) {
+    realloc_intlist(&ids, 0);
+    return TCL_ERROR;
+  }
+  n = ids.n;
+
+  parts = malloc(n*sizeof(Particle));
+  for (i = 0; i < n; i++) {
+    init_particle(&parts[i]);
+    parts[i].p.identity = ids.e[i];
+  }
+  realloc_intlist(&ids, 0);
+  init_intlist(&il);
+  init_doublelist(&dl);
+
+  for (argc--, argv++; argc > 0 && err == TCL_OK; argc -= 2, argv += 2) {
+    if (ARG0_IS_S("pos")) {
+      if ((err = part_bulk_parse_values(interp, argv[0], argv[1], n, 3, &dl)) == TCL_OK) {
+	for (i = 0; i < n; i++)
+	  memcpy(parts[i].r.p, &dl.e[3*i], 3*sizeof(double));
+	fields |= PART_BULK_POS;
+      }
+    }
+    else if (ARG0_IS_S("v")) {
+      if ((err = part_bulk_parse_values(interp, argv[0], argv[1], n, 3, &dl)) == TCL_OK) {
+	/* scale velocity with time step */
+	for (i = 0; i < 3*n; i++)
+	  parts[i/3].m.v[i%3] = dl.e[i]*time_step;
+	fields |= PART_BULK_V;
+      }
+    }
+    else if (ARG0_IS_S("f")) {
+      if ((err = part_bulk_parse_values(interp, argv[0], argv[1], n, 3, &dl)) == TCL_OK) {
+	/* rescale forces */
+	for (i = 0; i < 3*n; i++)
+	  parts[i/3].f.f[i%3] = dl.e[i]*(0.5*time_step*time_step);
+	fields |= PART_BULK_F;
+      }
+    }
+    else if (ARG0_IS_S("type")) {
+      if ((err = part_bulk_parse_ints(interp, argv[0], argv[1], n, &il)) == TCL_OK) {
+	for (i = 0; i < n; i++) {
+	  parts[i].p.type = il.e[i];
+	  if (parts[i].p.type < 0) {
+	    Tcl_AppendResult(interp, "invalid particle type", (char *) NULL);
+	    err = TCL_ERROR;
+	    break;
+	  }
+	}
+	fields |= PART_BULK_TYPE;
+      }
+    }
+    else if (ARG0_IS_S("molecule_id")) {
+      if ((err = part_bulk_parse_ints(interp, argv[0], argv[1], n, &il)) == TCL_OK) {
+	for (i = 0; i < n; i++) {
+	  parts[i].p.mol_id = il.e[i];
+	  if (parts[i].p.mol_id < -1) {
+	    Tcl_AppendResult(interp, "invalid molecule id", (char *) NULL);
+	    err = TCL_ERROR;
+	    break;
+	  }
+	}
+	fields |= PART_BULK_MOL_ID;
+      }
+    }
+#ifdef ELECTROSTATICS
+    else if (ARG0_IS_S("q")) {
+      if ((err = part_bulk_parse_values(interp, argv[0], argv[1], n, 1, &dl)) == TCL_OK) {
+	for (i = 0; i < n; i++)
+	  parts[i].p.q = dl.e[i];
+	fields |= PART_BULK_Q;
+      }
+    }
+#endif
+#ifdef MASS
+    else if (ARG0_IS_S("mass")) {
+      if ((err = part_bulk_parse_values(interp, argv[0], argv[1], n, 1, &dl)) == TCL_OK) {
+	for (i = 0; i < n; i++)
+	  parts[i].p.mass = dl.e[i];
+	fields |= PART_BULK_MASS;
+      }
+    }
+#endif
+#ifdef DIPOLES
+    else if (ARG0_IS_S("dip")) {
+      if ((err = part_bulk_parse_values(interp, argv[0], argv[1], n, 3, &dl)) == TCL_OK) {
+	for (i = 0; i < n; i++) {
+	  memcpy(parts[i].r.dip, &dl.e[3*i], 3*sizeof(double));
+	  if (sqrlen(parts[i].r.dip) < ROUND_ERROR_PREC) {
+	    Tcl_AppendResult(interp, "cannot set dipole with zero length", (char *)NULL);
+	    err = TCL_ERROR;
+	    break;
+	  }
+	}
+	fields |= PART_BULK_DIP;
+      }
+    }
+#endif
+#ifdef VIRTUAL_SITES
+    else if (ARG0_IS_S("virtual")) {
+      if ((err = part_bulk_parse_ints(interp, argv[0], argv[1], n, &il)) == TCL_OK) {
+	for (i = 0; i < n; i++)
+	  parts[i].p.isVirtual = il.e[i];
+	fields |= PART_BULK_VIRTUAL;
+      }
+    }
+#endif
+    else if (ARG0_IS_S("bond")) {
+      int tmp_argc;
+      char **tmp_argv;
+      if ((err = Tcl_SplitList(interp, argv[1], &tmp_argc, &tmp_argv)) == TCL_OK) {
+	if (tmp_argc != n) {
+	  Tcl_AppendResult(interp, "part bulk: bond requires one bond list per particle",
+			   (char *) NULL);
+	  err = TCL_ERROR;
+	}
+	for (i = 0; i < n && err == TCL_OK; i++) {
+	  parts[i].bl.n = 0;
+	  err = part_bulk_parse_bonds(interp, tmp_argv[i], &parts[i].bl);
+	}
+	Tcl_Free((char *)tmp_argv);
+	fields |= PART_BULK_BONDS;
+      }
+    }
+    else {
+      Tcl_AppendResult(interp, "unknown particle parameter \"",
+		       argv[0],"\" for part bulk", (char *)NULL);
+      err = TCL_ERROR;
+    }
+  }
+
+  if (err == TCL_OK && place_particles(n, parts, fields) == TCL_ERROR) {
+    Tcl_AppendResult(interp, "particle identities must be positive, "
+		     "and new particles need a position", (char *)NULL);
+    err = TCL_ERROR;
+  }
+
+  for (i = 0; i < n; i++)
+    realloc_intlist(&parts[i].bl, 0);
+  free(parts);
+  realloc_intlist(&il, 0);
+  realloc_doublelist(&dl, 0);
+
+  return mpi_gather_runtime_errors(interp, err);
+}
+
 int part_parse_pos(Tcl_Interp *interp, int argc, char **argv,
 		   int part_num, int * change)
 {
@@ -1205,7 +1566,7 @@ int part_parse_isVirtual(Tcl_Interp *interp, int argc, char **argv,
 }
 #endif
 
-#ifdef VIRTUAL_SITES
+#ifdef VIRTUAL_SITES_RELATIVE
 int part_parse_vs_relative(Tcl_Interp *interp, int argc, char **argv,
 		 int part_num, int * change)
 {
@@ -1987,6 +2348,8 @@ int part(ClientData data, Tcl_Interp *interp,
     remove_all_particles();
     return TCL_OK;
   }
+  else if (ARG1_IS_S("bulk"))
+    return part_cmd_bulk(interp, argc-2, argv+2);
 #ifdef EXCLUSIONS
   else if (ARG1_IS_S("delete_exclusions")) {
     if (argc != 2) {
@@ -2085,6 +2448,64 @@ int place_particle(int part, double p[3])
   return retcode;
 }
 
+int place_particles(int n, Particle *parts, int fields)
+{
+  int i, j, part, pnode, max_part, max_type = -1;
+  int *pnodes;
+  IntList new_ids;
+
+  if (!particle_node)
+    build_particle_node();
+
+  /* check everything first, so that nothing is changed on error */
+  for (i = 0; i < n; i++) {
+    part = parts[i].p.identity;
+    if (part < 0)
+      return TCL_ERROR;
+    if (!(fields & PART_BULK_POS) &&
+	(part > max_seen_particle || particle_node[part] == -1))
+      return TCL_ERROR;
+    if ((fields & PART_BULK_TYPE) && parts[i].p.type > max_type)
+      max_type = parts[i].p.type;
+  }
+
+  /* as in set_particle_type, the interactions of new types have to exist */
+  if (max_type >= 0)
+    make_particle_type_exist(max_type);
+
+  pnodes = malloc(n*sizeof(int));
+  init_intlist(&new_ids);
+  max_part = max_seen_particle;
+  for (i = 0; i < n; i++) {
+    part = parts[i].p.identity;
+    pnode = (part <= max_part) ? particle_node[part] : -1;
+    if (pnode == -1) {
+      /* new particle, node by spatial position */
+      pnode = cell_structure.position_to_node(parts[i].r.p);
+
+      if (part > max_part) {
+	realloc_particle_node(part);
+	/* fill up possible gap */
+	for (j = max_part + 1; j < part; j++)
+	  particle_node[j] = -1;
+	max_part = part;
+      }
+      particle_node[part] = pnode;
+
+      realloc_intlist(&new_ids, new_ids.n + 1);
+      new_ids.e[new_ids.n++] = part;
+    }
+    pnodes[i] = pnode;
+  }
+
+  mpi_place_particles(n, parts, pnodes, new_ids.n, new_ids.e, fields);
+
+  realloc_intlist(&new_ids, 0);
+  free(pnodes);
+
+  return TCL_OK;
+}
+
 int set_particle_v(int part, double v[3])
 {
   int pnode;
@@ -2508,6 +2929,57 @@ void local_place_particle(int part, double p[3], int new)
 #endif
 }
 
+void local_place_particles(int n, Particle *parts, int *bonds, int fields)
+{
+  int i;
+  Particle *src, *pt;
+
+  for (i = 0; i < n; i++) {
+    src = &parts[i];
+    if (fields & PART_BULK_POS)
+      local_place_particle(src->p.identity, src->r.p,
+			   local_particles[src->p.identity] == NULL);
+    pt = local_particles[src->p.identity];
+
+    if (fields & PART_BULK_V)
+      memcpy(pt->m.v, src->m.v, 3*sizeof(double));
+    if (fields & PART_BULK_F)
+      memcpy(pt->f.f, src->f.f, 3*sizeof(double));
+    if (fields & PART_BULK_TYPE)
+      pt->p.type = src->p.type;
+    if (fields & PART_BULK_MOL_ID)
+      pt->p.mol_id = src->p.mol_id;
+#ifdef ELECTROSTATICS
+    if (fields & PART_BULK_Q)
+      pt->p.q = src->p.q;
+#endif
+#ifdef MASS
+    if (fields & PART_BULK_MASS)
+      pt->p.mass = src->p.mass;
+#endif
+#ifdef DIPOLES
+    if (fields & PART_BULK_DIP) {
+      memcpy(pt->r.dip, src->r.dip, 3*sizeof(double));
+#ifdef ROTATION
+      convert_dip_to_quat(pt->r.dip, pt->r.quat, &pt->p.dipm);
+      convert_quat_to_quatu(pt->r.quat, pt->r.quatu);
+#endif
+    }
+#endif
+#ifdef VIRTUAL_SITES
+    if (fields & PART_BULK_VIRTUAL)
+      pt->p.isVirtual = src->p.isVirtual;
+#endif
+    if (fields & PART_BULK_BONDS) {
+      realloc_intlist(&pt->bl, pt->bl.n = src->bl.n);
+      if (src->bl.n > 0) {
+	memcpy(pt->bl.e, bonds, src->bl.n*sizeof(int));
+	bonds += src->bl.n;
+      }
+    }
+  }
+}
+
 void local_remove_all_particles()
 {
   Cell *cell;
@@ -2692,13 +3164,18 @@ void local_change_exclusion(int part1, int part2, int delete)
 
 void try_add_exclusion(Particle *part, int part2)
 {
+  IntList *el = &part->el;
   int i;
-  for (i = 0; i < part->el.n; i++)
-    if (part->el.e[i] == part2)
-      return;
+
+  /* keep the list sorted, do_nonbonded bisects it */
+  for (i = 0; i < el->n && el->e[i] < part2; i++);
+  if (i < el->n && el->e[i] == part2)
+    return;
   
-  realloc_intlist(&part->el, part->el.n + 1);
-  part->el.e[part->el.n++] = part2;
+  realloc_intlist(el, el->n + 1);
+  memmove(el->e + i + 1, el->e + i, sizeof(int)*(el->n - i));
+  el->e[i] = part2;
+  el->n++;
 }
 
 void try_delete_exclusion(Particle *part, int part2)
@@ -2706,10 +3183,10 @@ void try_delete_exclusion(Particle *part, int part2)
   IntList *el = &part->el;
   int i;
 
-  for (i = 0; i < el->n;) {
+  for (i = 0; i < el->n; i++) {
     if (el->e[i] == part2) {
       el->n--;
-      memcpy(el->e + i, el->e + i + 1, sizeof(int)*(el->n - i));
+      memmove(el->e + i, el->e + i + 1, sizeof(int)*(el->n - i));
       realloc_intlist(el, el->n);
       break;
     }
@@ -2921,15 +3398,4 @@ void auto_exclusion(int distance)
   }
   free(partners);
 }
-
-int do_nonbonded(Particle *p1, Particle *p2)
-{
-  int i, i2;
-  /* check for particle 2 in particle 1's exclusion list. The exclusion list is
-     symmetric, so this is sufficient. */
-  i2  = p2->p.identity;
-  for (i = 0; i < p1->el.n; i++)
-    if (i2 == p1->el.e[i]) return 0;
-  return 1;
-}
 #endif
@@ -30,14 +30,62 @@
 
 
 #ifdef EXTERNAL_FORCES
-/** \ref ParticleLocal::ext_flag "ext_flag" value for particle subject to an external force. */
+/** \ref ParticleProperties::ext_flag "ext_flag" value for particle subject to an external force. */
 #define PARTICLE_EXT_FORCE 1
-/** \ref ParticleLocal::ext_flag "ext_flag" value for fixed coordinate coord. */
+/** \ref ParticleProperties::ext_flag "ext_flag" value for fixed coordinate coord. */
 #define COORD_FIXED(coord) (2L << coord)
-/** \ref ParticleLocal::ext_flag "ext_flag" mask to check wether any of the coordinates is fixed. */
+/** \ref ParticleProperties::ext_flag "ext_flag" mask to check wether any of the coordinates is fixed. */
 #define COORDS_FIX_MASK     (COORD_FIXED(0) | COORD_FIXED(1) | COORD_FIXED(2))
 #endif
 
+/** \name Field flags for \ref place_particles */
+/*@{*/
+/** set the position, creating the particle if necessary */
+#define PART_BULK_POS     1
+/** set the velocity */
+#define PART_BULK_V       2
+/** set the force */
+#define PART_BULK_F       4
+/** set the type */
+#define PART_BULK_TYPE    8
+/** set the molecule id */
+#define PART_BULK_MOL_ID  16
+/** set the charge (ELECTROSTATICS only) */
+#define PART_BULK_Q       32
+/** set the mass (MASS only) */
+#define PART_BULK_MASS    64
+/** set the dipole moment (DIPOLES only) */
+#define PART_BULK_DIP     128
+/** set the virtual flag (VIRTUAL_SITES only) */
+#define PART_BULK_VIRTUAL 256
+/** replace the bond list */
+#define PART_BULK_BONDS   512
+/*@}*/
+
+/** \name Field flags for \ref updatePartCfgFields */
+/*@{*/
+/** the unfolded position */
+#define PCFG_POS    1
+/** the velocity */
+#define PCFG_V      2
+/** the force */
+#define PCFG_F      4
+/** the type */
+#define PCFG_TYPE   8
+/** the molecule id */
+#define PCFG_MOL_ID 16
+/** the charge (0 without ELECTROSTATICS) */
+#define PCFG_Q      32
+/** the mass (1 without MASS) */
+#define PCFG_MASS   64
+/** the dipole moment (0 without DIPOLES) */
+#define PCFG_DIP    128
+/** whether the particle is virtual (0 without VIRTUAL_SITES) */
+#define PCFG_VIRTUAL 256
+/** transfer the floating point fields in single precision */
+#define PCFG_FLOAT  1024
+/*@}*/
+
 
 /************************************************
  * data types
@@ -98,6 +146,18 @@ typedef struct {
   /** particles adress weight */
   double adress_weight;
 #endif
+
+#ifdef EXTERNAL_FORCES
+  /** flag whether to fix a particle in space. Also needed for the
+      ghosts, since pair thermostats like DPD skip fixed particles.
+      Values:
+      <ul> <li> 0 no external influence
+           <li> 1 apply external force \ref ParticleLocal::ext_force
+           <li> 2,3,4 fix particle coordinate 0,1,2
+      </ul>
+  */
+  int ext_flag;
+#endif
 } ParticleProperties;
 
 /** Positional information on a particle. Information that is
@@ -160,15 +220,7 @@ typedef struct {
   int    i[3];
 
 #ifdef EXTERNAL_FORCES
-  /** flag whether to fix a particle in space.
-      Values:
-      <ul> <li> 0 no external influence
-           <li> 1 apply external force \ref ParticleLocal::ext_force
-           <li> 2,3,4 fix particle coordinate 0,1,2
-      </ul>
-  */
-  int ext_flag;
-  /** External force, apply if \ref ParticleLocal::ext_flag == 1. */
+  /** External force, apply if \ref ParticleProperties::ext_flag == 1. */
   double ext_force[3];
 #endif
 
@@ -208,7 +260,8 @@ typedef struct {
   IntList bl;
 
 #ifdef EXCLUSIONS
-  /** list of particles, with which this particle has no nonbonded interactions */
+  /** list of particles, with which this particle has no nonbonded interactions,
+      sorted by identity */
   IntList el;
 #endif
 } Particle;
@@ -226,6 +279,28 @@ typedef struct {
   int max;
 } ParticleList;
 
+/** Selected properties of all particles, stored as one compact array
+    per property. Only the arrays of the requested fields are allocated,
+    vectors are stored as consecutive triples. See \ref updatePartCfgFields.
+*/
+typedef struct {
+  /** the fields contained, or'ed \ref PCFG_POS etc. */
+  int fields;
+  /** number of particles, -1 if nothing was fetched */
+  int n;
+  /** the particle identities, always present */
+  int *identity;
+  int *type;
+  int *mol_id;
+  double *pos;
+  double *v;
+  double *f;
+  double *q;
+  double *mass;
+  double *dip;
+  int *isVirtual;
+} PartCfgFields;
+
 /************************************************
  * exported variables
  ************************************************/
@@ -257,6 +332,10 @@ extern Particle *partCfg;
     the particles are stored consecutively starting with 0. */
 extern int partCfgSorted;
 
+/** Selected properties of all particles in compact form. Before using
+    that call \ref updatePartCfgFields to fetch the fields you need. */
+extern PartCfgFields partCfgFields;
+
 /** Particles' current bond partners. \ref partBondPartners is
     sorted by particle order, and the particles are stored
     consecutively starting with 0. This array is global to all nodes*/
@@ -390,6 +469,24 @@ int get_particle_data(int part, Particle *data);
 */
 int place_particle(int part, double p[3]);
 
+/** Call only on the master node.
+    Create or modify many particles at once. This does the same as
+    \ref place_particle and the set_particle_* functions called for each
+    particle, but all particles are sent to their nodes in a single
+    communication step, and the particles are resorted only once.
+    Of the particle data, only the identity and the fields selected
+    by fields are used. Velocities and forces have to be scaled like
+    for \ref set_particle_v and \ref set_particle_f. The bond list
+    replaces the one of the particle, and its partners may be
+    created in the same call.
+    @param n      number of particles
+    @param parts  the particle data
+    @param fields or'ed \ref PART_BULK_POS etc.
+    @return TCL_OK, or TCL_ERROR if an identity is illegal or a new
+    particle has no position. In this case, nothing is changed.
+*/
+int place_particles(int n, Particle *parts, int fields);
+
 /** Call only on the master node: set particle velocity.
     @param part the particle.
     @param v its new velocity.
@@ -560,6 +657,40 @@ void updatePartCfg(int bonds_flag );
 */
 void freePartCfg();
 
+/** Get selected properties of all particles into \ref
+    partCfgFields. In contrast to \ref updatePartCfg, only the
+    requested fields are transferred, which is much cheaper if you
+    need e.g. only positions and types. The particles are in no
+    particular order. This function is lazy, the data is only fetched
+    again if \ref partCfgFields does not contain all requested fields
+    or only has them in single precision while full precision is
+    requested. With VIRTUAL_SITES_COM, the positions of the virtual
+    sites are recalculated from their molecules as in \ref
+    updatePartCfg, for which the molecule ids, masses and virtual
+    flags are fetched along with the positions.
+    @param fields or'ed \ref PCFG_POS etc.
+*/
+void updatePartCfgFields(int fields);
+
+/** release the \ref partCfgFields arrays. */
+void freePartCfgFields();
+
+/** allocate the arrays of a \ref PartCfgFields for n particles.
+    @param cfg    the structure to set up
+    @param fields or'ed \ref PCFG_POS etc.
+    @param n      number of particles
+*/
+void alloc_particle_fields(PartCfgFields *cfg, int fields, int n);
+
+/** free the arrays of a \ref PartCfgFields. */
+void free_particle_fields(PartCfgFields *cfg);
+
+/** collect the requested fields of the particles on this node.
+    @param fields or'ed \ref PCFG_POS etc.
+    @param local  where to store the data, allocated by this function
+*/
+void local_get_particle_fields(int fields, PartCfgFields *local);
+
 /** sorts the \ref partCfg array. This is indicated by setting
     \ref partCfgSorted to 1. Note that for this to work the particles
     have to be stored consecutively starting with 0.
@@ -579,6 +710,16 @@ int sortPartCfg();
 */
 void local_place_particle(int part, double p[3], int new);
 
+/** Used by \ref mpi_place_particles, should not be used elsewhere.
+    Create or modify particles that belong to this node. New particles
+    have to be announced by \ref added_particle before.
+    @param n      number of particles
+    @param parts  the particle data
+    @param bonds  the bond lists of all particles, concatenated
+    @param fields which fields to set, see \ref place_particles
+*/
+void local_place_particles(int n, Particle *parts, int *bonds, int fields);
+
 /** Used by \ref mpi_place_particle, should not be used elsewhere.
     Called if on a different node a new particle was added.
     @param part the identity of the particle added
@@ -631,8 +772,24 @@ void send_particles(ParticleList *particles, int node);
 void recv_particles(ParticleList *particles, int node);
 
 #ifdef EXCLUSIONS
-/** Determines if the non bonded interactions between p1 and p2 should be calculated */
-int do_nonbonded(Particle *p1, Particle *p2);
+/** Determines if the non bonded interactions between p1 and p2 should be calculated.
+    Since the exclusion lists are sorted, this is a bisection of the exclusion list of p1. */
+MDINLINE int do_nonbonded(Particle *p1, Particle *p2)
+{
+  int lo = 0, hi = p1->el.n - 1, mid, i2 = p2->p.identity;
+  /* check for particle 2 in particle 1's exclusion list. The exclusion list is
+     symmetric, so this is sufficient. */
+  while (lo <= hi) {
+    mid = (lo + hi) >> 1;
+    if (p1->el.e[mid] < i2)
+      lo = mid + 1;
+    else if (p1->el.e[mid] > i2)
+      hi = mid - 1;
+    else
+      return 0;
+  }
+  return 1;
+}
 #endif
 
 /** Complain about a missing bond partner. Just for convenience, replaces the old checked_particle_ptr.
@@ -85,15 +85,16 @@ void init_p_tensor(Observable_stat *stat);
 /** Initializes stat_nb to be used by \ref calc_p_tensor. */
 void init_p_tensor_non_bonded(Observable_stat_non_bonded *stat_nb);
 
+/** rescale the virials, add the long range virials and gather the
+    pressure of all nodes */
+static void finish_pressure(double *result, double *result_t, double *result_nb, double *result_t_nb);
+
 /*********************************/
 /* Scalar and Tensorial Pressure */
 /*********************************/
 
 void pressure_calc(double *result, double *result_t, double *result_nb, double *result_t_nb, int v_comp)
 {
-  int n, i;
-  double volume = box_l[0]*box_l[1]*box_l[2];
-
   if (!check_obs_calc_initialized())
     return;
 
@@ -118,6 +119,15 @@ void pressure_calc(double *result, double *result_t, double *result_nb, double *
   case CELL_STRUCTURE_NSQUARE:
     nsq_calculate_virials();
   }
+
+  finish_pressure(result, result_t, result_nb, result_t_nb);
+}
+
+static void finish_pressure(double *result, double *result_t, double *result_nb, double *result_t_nb)
+{
+  int n, i;
+  double volume = box_l[0]*box_l[1]*box_l[2];
+
   /* rescale kinetic energy (=ideal contribution) */
 #ifdef ROTATION
   virials.data.e[0] /= (6.0*volume*time_step*time_step);
@@ -157,6 +167,57 @@ void pressure_calc(double *result, double *result_t, double *result_nb, double *
 
 /************************************************************/
 
+void fused_pressure_init()
+{
+  init_virials(&virials);
+  init_p_tensor(&p_tensor);
+  init_virials_non_bonded(&virials_non_bonded);
+  init_p_tensor_non_bonded(&p_tensor_non_bonded);
+}
+
+void add_fused_pair_virials(Particle *p1, Particle *p2, double d[3], double dist, double dist2)
+{
+  add_non_bonded_pair_virials(p1, p2, d, dist, dist2);
+}
+
+void fused_pressure_finish()
+{
+  Cell *cell;
+  Particle *p;
+  int c, i, np;
+
+  /* the pair virials are known from the force calculation */
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for (i = 0; i < np; i++) {
+      add_kinetic_virials(&p[i], 0);
+      add_bonded_virials(&p[i]);
+#ifdef BOND_ANGLE
+      add_three_body_bonded_stress(&p[i]);
+#endif
+    }
+  }
+
+  if (this_node == 0) {
+    init_virials(&total_pressure);
+    init_p_tensor(&total_p_tensor);
+    init_virials_non_bonded(&total_pressure_non_bonded);
+    init_p_tensor_non_bonded(&total_p_tensor_non_bonded);
+  }
+  finish_pressure(total_pressure.data.e, total_p_tensor.data.e,
+		  total_pressure_non_bonded.data_nb.e, total_p_tensor_non_bonded.data_nb.e);
+  if (this_node == 0) {
+    total_pressure.init_status = 1;
+    total_p_tensor.init_status = 1;
+    total_pressure_non_bonded.init_status_nb = 1;
+    total_p_tensor_non_bonded.init_status_nb = 1;
+  }
+}
+
+/************************************************************/
+
 void calc_long_range_virials()
 {
 #ifdef ELECTROSTATICS
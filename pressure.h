@@ -28,7 +28,7 @@
 ///
 extern Observable_stat virials, total_pressure;
 ///
-extern Observable_stat p_tensor;
+extern Observable_stat p_tensor, total_p_tensor;
 ///
 extern Observable_stat_non_bonded virials_non_bonded, total_pressure_non_bonded;
 ///
@@ -58,6 +58,17 @@ int p_diff_callback(Tcl_Interp *interp, void *_data);
 */
 void pressure_calc(double *result, double *result_t, double *result_nb, double *result_t_nb, int v_comp);
 
+/** Prepare the pressure calculation along with the next force
+    calculation, see \ref fused_observables. */
+void fused_pressure_init();
+
+/** Complete the pressure calculation started by \ref
+    fused_pressure_init after the force calculation and the velocity
+    update. The result is stored in \ref total_pressure and the
+    corresponding tensors on the master node, as if calculated by
+    pressure_calc without velocity compensation. */
+void fused_pressure_finish();
+
 /** Calculate non bonded energies between a pair of particles.
     @param p1        pointer to particle 1.
     @param p2        pointer to particle 2.
@@ -30,6 +30,10 @@ int rand_w_array[MERS_BIT_RANDOM];
 int random_pointer_1 = -1;
 int random_pointer_2 = -1;
 
+/* Stuff for the counter based generator */
+int counter_rng_seed = 0;
+int counter_rng_step = 0;
+
 /*----------------------------------------------------------------------*/
 
 void init_random(void)
@@ -107,14 +111,82 @@ RandomStatus print_random_stat(void) {
 
 /*----------------------------------------------------------------------*/
 
+void c_random_uniform(double *r, int n, int a, int stream)
+{
+  unsigned int ctr[4];
+  int b, i, nb = n/4;
+
+  /* full blocks, which are independent of each other */
+  for (b = 0; b < nb; b++) {
+    ctr[0] = counter_rng_step; ctr[1] = a; ctr[2] = b; ctr[3] = stream;
+    philox4x32(ctr, counter_rng_seed, 0);
+    for (i = 0; i < 4; i++)
+      r[4*b + i] = (ctr[i] + 0.5)*(1.0/4294967296.0);
+  }
+  /* remainder */
+  if (4*nb < n) {
+    ctr[0] = counter_rng_step; ctr[1] = a; ctr[2] = nb; ctr[3] = stream;
+    philox4x32(ctr, counter_rng_seed, 0);
+    for (i = 0; 4*nb + i < n; i++)
+      r[4*nb + i] = (ctr[i] + 0.5)*(1.0/4294967296.0);
+  }
+}
+
+/*----------------------------------------------------------------------*/
+
+void c_random_gaussian(double *r, int n, int a, int stream)
+{
+  double *u, rad;
+  int i, n2 = (n + 1)/2*2;
+
+  u = malloc(n2*sizeof(double));
+  c_random_uniform(u, n2, a, stream);
+  for (i = 0; i < n2; i += 2) {
+    rad = sqrt(-2.0*log(u[i]));
+    r[i] = rad*cos(2.0*PI*u[i + 1]);
+    if (i + 1 < n)
+      r[i + 1] = rad*sin(2.0*PI*u[i + 1]);
+  }
+  free(u);
+}
+
+/*----------------------------------------------------------------------*/
+
+int counter_rng_seed_callback(Tcl_Interp *interp, void *_data)
+{
+  int data = *(int *)_data;
+  if (data < 0) {
+    Tcl_AppendResult(interp, "the seed of the counter based generator must not be negative", (char *) NULL);
+    return (TCL_ERROR);
+  }
+  counter_rng_seed = data;
+  counter_rng_step = 0;
+  mpi_bcast_parameter(FIELD_COUNTER_RNG_SEED);
+  mpi_bcast_parameter(FIELD_COUNTER_RNG_STEP);
+  return (TCL_OK);
+}
+
+/*----------------------------------------------------------------------*/
+
+int counter_rng_step_callback(Tcl_Interp *interp, void *_data)
+{
+  counter_rng_step = *(int *)_data;
+  mpi_bcast_parameter(FIELD_COUNTER_RNG_STEP);
+  return (TCL_OK);
+}
+
+/*----------------------------------------------------------------------*/
+
 /**  Implementation of the tcl-command
-     t_random [{ int <n> | seed [<seed(0)> ... <seed(n_nodes-1)>] | stat [status-list] }]
+     t_random [{ int <n> | seed [<seed(0)> ... <seed(n_nodes-1)>] | stat [status-list] | counter uniform|gaussian <n> <index> }]
      <ul>
      <li> Without further arguments, it returns a random double between 0 and 1.
      <li> If 'int \<n\>' is given, it returns a random integer between 0 and n-1.
      <li> If 'seed'/'stat' is given without further arguments, it returns a tcl-list with
           the current seeds/status of the n_nodes active nodes; otherwise it issues the 
 	  given parameters as the new seeds/status to the respective nodes.     
+     <li> If 'counter' is given, it returns n uniform or gaussian numbers of the counter based
+          generator for the given index and the current \ref counter_rng_step.
      </ul>
  */
 int t_random (ClientData data, Tcl_Interp *interp, int argc, char **argv) {
@@ -181,8 +253,30 @@ int t_random (ClientData data, Tcl_Interp *interp, int argc, char **argv) {
     free(stat); 
     return(TCL_OK);
   }
+  else if (!strncmp(argv[0], "counter", strlen(argv[0]))) { /* 't_random counter uniform|gaussian <n> <index>' */
+    double *r;
+    int gauss;
+    if (argc != 4 || (strcmp(argv[1], "uniform") && strcmp(argv[1], "gaussian")) ||
+	Tcl_GetInt(interp, argv[2], &cnt) == TCL_ERROR || Tcl_GetInt(interp, argv[3], &i) == TCL_ERROR || cnt < 0) {
+      Tcl_ResetResult(interp);
+      Tcl_AppendResult(interp, "Wrong # of args: Usage: 't_random counter uniform|gaussian <n> <index>'", (char *) NULL);
+      return (TCL_ERROR);
+    }
+    gauss = !strcmp(argv[1], "gaussian");
+    r = malloc((cnt + 1)*sizeof(double));
+    if (gauss)
+      c_random_gaussian(r, cnt, i, COUNTER_RNG_USER);
+    else
+      c_random_uniform(r, cnt, i, COUNTER_RNG_USER);
+    for (j = 0; j < cnt; j++) {
+      Tcl_PrintDouble(interp, r[j], buffer);
+      Tcl_AppendResult(interp, buffer, " ", (char *) NULL);
+    }
+    free(r);
+    return(TCL_OK);
+  }
   /* else */
-  sprintf(buffer, "Usage: 't_random [{ int <n> | seed [<seed(0)> ... <seed(%d)>] | stat [status-list] }]'",n_nodes-1);
+  sprintf(buffer, "Usage: 't_random [{ int <n> | seed [<seed(0)> ... <seed(%d)>] | stat [status-list] | counter uniform|gaussian <n> <index> }]'",n_nodes-1);
   Tcl_AppendResult(interp, "Unknown job '",argv[0],"' requested!\n",buffer, (char *)NULL);
   return (TCL_ERROR); 
 }
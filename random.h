@@ -104,6 +104,83 @@ MDINLINE double d_random(void)
 }
 
 
+/*----------------------------------------------------------*/
+
+/** \name Counter based generator.
+    Philox4x32-10 (Salmon et al., SC11). The random numbers are a
+    function of a counter and a key, not of a sequential state, so
+    that the noise of a particle depends only on the seed, the number
+    of the force calculation and the particle identity, but not on
+    the node the particle resides on or the order in which particles
+    are visited. Used by the thermostats if \ref counter_rng_seed is
+    not 0. */
+/*@{*/
+/** key of the counter based generator. 0 means that the thermostats
+    use \ref d_random. */
+extern int counter_rng_seed;
+/** number of force calculations since the seed was set, part of the counter. */
+extern int counter_rng_step;
+
+/** streams, i.e. the last word of the counter, to decorrelate the
+    different consumers of random numbers. */
+#define COUNTER_RNG_LANGEVIN     0
+#define COUNTER_RNG_ROTATION     1
+#define COUNTER_RNG_DPD          2
+#define COUNTER_RNG_TRANS_DPD    3
+#define COUNTER_RNG_LB_COUPLING  4
+#define COUNTER_RNG_USER         5
+
+/** Philox4x32-10 bijection of ctr, keyed by key. The result replaces ctr. */
+MDINLINE void philox4x32(unsigned int ctr[4], unsigned int key0, unsigned int key1)
+{
+  unsigned long long prod0, prod1;
+  int r;
+
+  for (r = 0; r < 10; r++) {
+    prod0 = (unsigned long long)0xD2511F53U*ctr[0];
+    prod1 = (unsigned long long)0xCD9E8D57U*ctr[2];
+    ctr[0] = (unsigned int)(prod1 >> 32) ^ ctr[1] ^ key0;
+    ctr[1] = (unsigned int)prod1;
+    ctr[2] = (unsigned int)(prod0 >> 32) ^ ctr[3] ^ key1;
+    ctr[3] = (unsigned int)prod0;
+    key0 += 0x9E3779B9U;
+    key1 += 0xBB67AE85U;
+  }
+}
+
+/** four uniform doubles in (0,1) for the counter (\ref counter_rng_step, a, b, stream).
+    @param a      first index, e.g. a particle identity
+    @param b      second index, e.g. the partner in a pair or 0
+    @param stream one of \ref COUNTER_RNG_LANGEVIN etc.
+    @param r      the random numbers
+*/
+MDINLINE void c_random4(int a, int b, int stream, double r[4])
+{
+  unsigned int ctr[4];
+  int i;
+
+  ctr[0] = counter_rng_step; ctr[1] = a; ctr[2] = b; ctr[3] = stream;
+  philox4x32(ctr, counter_rng_seed, 0);
+  for (i = 0; i < 4; i++)
+    r[i] = (ctr[i] + 0.5)*(1.0/4294967296.0);
+}
+
+/** fill r with n uniform doubles in (0,1) for index a. The values are
+    generated in independent blocks of four with the counters
+    (\ref counter_rng_step, a, block, stream).
+*/
+void c_random_uniform(double *r, int n, int a, int stream);
+
+/** fill r with n gaussian doubles of zero mean and unit variance for
+    index a, from \ref c_random_uniform by the Box-Muller method. */
+void c_random_gaussian(double *r, int n, int a, int stream);
+
+/** Callback for setmd counter_rng_seed. */
+int counter_rng_seed_callback(Tcl_Interp *interp, void *_data);
+/** Callback for setmd counter_rng_step. */
+int counter_rng_step_callback(Tcl_Interp *interp, void *_data);
+/*@}*/
+
 /**  Implementation of the tcl command \ref tcl_t_random. Access to the
      parallel random number generator.
 */
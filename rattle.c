@@ -19,6 +19,39 @@ int n_rigidbonds = 0;
 
 #ifdef BOND_CONSTRAINT
 
+/** \name Rigid clusters */
+/************************************************************/
+/*@{*/
+
+/** Maximal number of rigid bonds of a cluster that is solved
+    directly. Larger clusters are left to the iteration. */
+#define RIGID_CLUSTER_MAX_BONDS 32
+
+/** Maximal number of Newton iterations for the positions of a cluster. */
+#define RIGID_CLUSTER_MAX_ITERATIONS 20
+
+/** A rigid bond between two particles stored on this node. */
+typedef struct {
+  Particle *p1, *p2;
+  Bonded_ia_parameters *iaparams;
+  /** representative of the cluster the bond belongs to */
+  int cluster;
+} RigidBond;
+
+static RigidBond *rigid_bonds = NULL;
+static int n_rigid_bonds = 0, max_rigid_bonds = 0;
+
+/** index of the local particles by identity, -1 for all others */
+static int *rigid_part_index = NULL;
+static int max_rigid_part_index = 0;
+
+/** union-find forest of the local particles, and the flags for the
+    particles that have rigid bonds to ghosts */
+static int *rigid_parent = NULL, *rigid_boundary = NULL;
+static int max_rigid_parts = 0;
+
+/*@}*/
+
 /** \name Private functions */
 /************************************************************/
 /*@{*/
@@ -54,6 +87,19 @@ void revert_force();
 rigid_bonds*/
 void print_bond_len();
 
+/** Collects the rigid bonds between particles stored on this node and
+    groups them into clusters of connected bonds. Invoked from \ref
+    correct_pos_shake() and \ref correct_vel_shake() */
+static void build_rigid_clusters();
+
+/** Solves the position constraints of one cluster of rigid bonds
+    directly. Invoked from \ref correct_pos_shake() */
+static void solve_cluster_pos(RigidBond *b, int n);
+
+/** Solves the velocity constraints of one cluster of rigid bonds
+    directly. Invoked from \ref correct_vel_shake() */
+static void solve_cluster_vel(RigidBond *b, int n);
+
 /*@}*/
 
 /*Initialize old positions (particle positions at previous time step)
@@ -220,26 +266,251 @@ void check_rebuild_verletlist()
      announce_rebuild_vlist();
 }
 
+/************************************************************/
+
+static int rigid_find(int i)
+{
+  while (rigid_parent[i] != i)
+    i = rigid_parent[i] = rigid_parent[rigid_parent[i]];
+  return i;
+}
+
+static int compare_rigid_bonds(const void *a, const void *b)
+{
+  return ((RigidBond *)a)->cluster - ((RigidBond *)b)->cluster;
+}
+
+static void build_rigid_clusters()
+{
+  int c, i, k, np, n_parts = 0, i1, i2;
+  Cell *cell;
+  Particle *p, *p1, *p2;
+  Bonded_ia_parameters *ia_params;
+
+  if (max_rigid_part_index < max_seen_particle + 1) {
+    rigid_part_index = realloc(rigid_part_index, (max_seen_particle + 1)*sizeof(int));
+    for (i = max_rigid_part_index; i < max_seen_particle + 1; i++)
+      rigid_part_index[i] = -1;
+    max_rigid_part_index = max_seen_particle + 1;
+  }
+
+  /* number the local particles */
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for(i = 0; i < np; i++)
+      rigid_part_index[p[i].p.identity] = n_parts++;
+  }
+  if (max_rigid_parts < n_parts) {
+    max_rigid_parts = n_parts;
+    rigid_parent   = realloc(rigid_parent,   max_rigid_parts*sizeof(int));
+    rigid_boundary = realloc(rigid_boundary, max_rigid_parts*sizeof(int));
+  }
+  for (i = 0; i < n_parts; i++) {
+    rigid_parent[i]   = i;
+    rigid_boundary[i] = 0;
+  }
+
+  /* collect the bonds and join the particles they connect. Bonds to
+     ghosts or missing particles mark the cluster for the iteration */
+  n_rigid_bonds = 0;
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for(i = 0; i < np; i++) {
+      p1 = &p[i];
+      i1 = rigid_part_index[p1->p.identity];
+      k = 0;
+      while(k<p1->bl.n) {
+	ia_params = &bonded_ia_params[p1->bl.e[k++]];
+	if( ia_params->type == BONDED_IA_RIGID_BOND ) {
+	  p2 = local_particles[p1->bl.e[k++]];
+	  i2 = p2 ? rigid_part_index[p2->p.identity] : -1;
+	  if (i2 < 0) {
+	    rigid_boundary[i1] = 1;
+	    continue;
+	  }
+	  if (n_rigid_bonds >= max_rigid_bonds) {
+	    max_rigid_bonds = 2*max_rigid_bonds + 16;
+	    rigid_bonds = realloc(rigid_bonds, max_rigid_bonds*sizeof(RigidBond));
+	  }
+	  rigid_bonds[n_rigid_bonds].p1 = p1;
+	  rigid_bonds[n_rigid_bonds].p2 = p2;
+	  rigid_bonds[n_rigid_bonds].iaparams = ia_params;
+	  rigid_bonds[n_rigid_bonds].cluster = i1;
+	  n_rigid_bonds++;
+	  rigid_parent[rigid_find(i1)] = rigid_find(i2);
+	}
+	else
+	  k += ia_params->num;
+      }
+    }
+  }
+
+  for (i = 0; i < n_parts; i++)
+    if (rigid_boundary[i])
+      rigid_boundary[rigid_find(i)] = 1;
+
+  /* sort the bonds by cluster */
+  for (k = 0; k < n_rigid_bonds; k++)
+    rigid_bonds[k].cluster = rigid_find(rigid_bonds[k].cluster);
+  qsort(rigid_bonds, n_rigid_bonds, sizeof(RigidBond), compare_rigid_bonds);
+
+  /* reset the particle index for the next time */
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for(i = 0; i < np; i++)
+      rigid_part_index[p[i].p.identity] = -1;
+  }
+}
+
+/** Coupling of the rigid bonds b and d: the change of the separation
+    vector of b if the particles of d are moved apart along a vector,
+    weighted by their inverse masses. */
+static double rigid_bond_coupling(RigidBond *b, RigidBond *d)
+{
+  double w = 0;
+  if (b->p1 == d->p1) w += 1.0/PMASS(*b->p1);
+  if (b->p1 == d->p2) w -= 1.0/PMASS(*b->p1);
+  if (b->p2 == d->p1) w -= 1.0/PMASS(*b->p2);
+  if (b->p2 == d->p2) w += 1.0/PMASS(*b->p2);
+  return w;
+}
+
+/** Solves the position constraints of one cluster by Newton
+    iterations. As in the iteration, the corrections are along the
+    bond vectors before the time step, but all bonds are corrected
+    simultaneously. For a rigid triangle this gives the same result as
+    the analytic SETTLE algorithm. Clusters that do not converge are
+    left to the iteration. */
+static void solve_cluster_pos(RigidBond *b, int n)
+{
+  static double A_data[RIGID_CLUSTER_MAX_BONDS*RIGID_CLUSTER_MAX_BONDS];
+  static double *A[RIGID_CLUSTER_MAX_BONDS];
+  double r[RIGID_CLUSTER_MAX_BONDS][3], r_old[RIGID_CLUSTER_MAX_BONDS][3];
+  double g[RIGID_CLUSTER_MAX_BONDS], corr;
+  int perms[RIGID_CLUSTER_MAX_BONDS];
+  int i, j, k, it, converged;
+
+  for (i = 0; i < n; i++) {
+    A[i] = A_data + i*n;
+    get_mi_vector(r_old[i], b[i].p1->r.p_old, b[i].p2->r.p_old);
+  }
+
+  for (it = 0; it < RIGID_CLUSTER_MAX_ITERATIONS; it++) {
+    converged = 1;
+    for (i = 0; i < n; i++) {
+      get_mi_vector(r[i], b[i].p1->r.p, b[i].p2->r.p);
+      g[i] = b[i].iaparams->p.rigid_bond.d2 - sqrlen(r[i]);
+      if (fabs(g[i]/b[i].iaparams->p.rigid_bond.d2) > b[i].iaparams->p.rigid_bond.p_tol)
+	converged = 0;
+    }
+    if (converged)
+      return;
+
+    /* linearized constraints */
+    for (i = 0; i < n; i++)
+      for (j = 0; j < n; j++)
+	A[i][j] = 2*rigid_bond_coupling(&b[i], &b[j])*scalar(r[i], r_old[j]);
+    if (lu_decompose_matrix(A, n, perms) != 0)
+      return;
+    lu_solve_system(A, n, perms, g);
+
+    for (i = 0; i < n; i++)
+      for (k = 0; k < 3; k++) {
+	corr = g[i]*r_old[i][k];
+	b[i].p1->r.p[k] += corr/PMASS(*b[i].p1);
+	b[i].p1->m.v[k] += corr/PMASS(*b[i].p1);
+	b[i].p2->r.p[k] -= corr/PMASS(*b[i].p2);
+	b[i].p2->m.v[k] -= corr/PMASS(*b[i].p2);
+      }
+  }
+}
+
+/** Solves the velocity constraints of one cluster. These are linear in
+    the corrections, which are along the current bond vectors, so that
+    one solution of the linear system is exact. */
+static void solve_cluster_vel(RigidBond *b, int n)
+{
+  static double A_data[RIGID_CLUSTER_MAX_BONDS*RIGID_CLUSTER_MAX_BONDS];
+  static double *A[RIGID_CLUSTER_MAX_BONDS];
+  double r[RIGID_CLUSTER_MAX_BONDS][3], v_ij[3];
+  double h[RIGID_CLUSTER_MAX_BONDS], corr;
+  int perms[RIGID_CLUSTER_MAX_BONDS];
+  int i, j, k, converged = 1;
+
+  for (i = 0; i < n; i++) {
+    A[i] = A_data + i*n;
+    get_mi_vector(r[i], b[i].p1->r.p, b[i].p2->r.p);
+    vecsub(b[i].p1->m.v, b[i].p2->m.v, v_ij);
+    h[i] = -scalar(v_ij, r[i]);
+    if (fabs(h[i]) > b[i].iaparams->p.rigid_bond.v_tol)
+      converged = 0;
+  }
+  if (converged)
+    return;
+
+  for (i = 0; i < n; i++)
+    for (j = 0; j < n; j++)
+      A[i][j] = rigid_bond_coupling(&b[i], &b[j])*scalar(r[i], r[j]);
+  if (lu_decompose_matrix(A, n, perms) != 0)
+    return;
+  lu_solve_system(A, n, perms, h);
+
+  for (i = 0; i < n; i++)
+    for (k = 0; k < 3; k++) {
+      corr = h[i]*r[i][k];
+      b[i].p1->m.v[k] += corr/PMASS(*b[i].p1);
+      b[i].p2->m.v[k] -= corr/PMASS(*b[i].p2);
+    }
+}
+
+/** Calls solve for all clusters that are not too large. If
+    boundary_only is set, only for the clusters with bonds to ghosts,
+    since the corrections of these bonds do not touch the others. */
+static void solve_rigid_clusters(void (*solve)(RigidBond *b, int n), int boundary_only)
+{
+  int start, end;
+
+  for (start = 0; start < n_rigid_bonds; start = end) {
+    for (end = start + 1; end < n_rigid_bonds &&
+	   rigid_bonds[end].cluster == rigid_bonds[start].cluster; end++);
+    if ((boundary_only && !rigid_boundary[rigid_bonds[start].cluster]) ||
+	end - start > RIGID_CLUSTER_MAX_BONDS)
+      continue;
+    solve(rigid_bonds + start, end - start);
+  }
+}
 
 void correct_pos_shake()
 {
    int    repeat_,  cnt=0;
    int repeat=1;
 
-   while (repeat!=0 && cnt<SHAKE_MAX_ITERATIONS)
+   /* the bonds between particles on this node are solved without
+      communication, the iteration only has to deal with the bonds
+      across the node boundaries */
+   build_rigid_clusters();
+   solve_rigid_clusters(solve_cluster_pos, 0);
+   ghost_communicator(&cell_structure.update_ghost_pos_comm);
+
+   while (cnt<SHAKE_MAX_ITERATIONS)
    {
      init_correction_vector();
      repeat_ = 0;
      compute_pos_corr_vec(&repeat_);
+     MPI_Allreduce(&repeat_, &repeat, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+     if (repeat == 0)
+       break;
      ghost_communicator(&cell_structure.collect_ghost_force_comm);
      app_pos_correction();
+     solve_rigid_clusters(solve_cluster_pos, 1);
      /**Ghost Positions Update*/
      ghost_communicator(&cell_structure.update_ghost_pos_comm);
-     if(this_node==0)
-         MPI_Reduce(&repeat_, &repeat, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-     else
-         MPI_Reduce(&repeat_, NULL, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-     MPI_Bcast(&repeat, 1, MPI_INT, 0, MPI_COMM_WORLD);
 
        cnt++;
    }// while(repeat) loop
@@ -407,24 +678,28 @@ void revert_force()
 void correct_vel_shake()
 {
    int    repeat_, repeat=1, cnt=0;
+
+   /* the particles may have been resorted since the positions were corrected */
+   build_rigid_clusters();
+   solve_rigid_clusters(solve_cluster_vel, 0);
+   ghost_communicator(&cell_structure.update_ghost_pos_comm);
+
    /**transfer the current forces to r.p_old of the particle structure so that
    velocity corrections can be stored temporarily at the f.f[3] of the particle
    structure  */
    transfer_force_init_vel();
-   while (repeat!=0 && cnt<SHAKE_MAX_ITERATIONS)
+   while (cnt<SHAKE_MAX_ITERATIONS)
    {
      init_correction_vector();
      repeat_ = 0;
      compute_vel_corr_vec(&repeat_);
+     MPI_Allreduce(&repeat_, &repeat, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+     if (repeat == 0)
+       break;
      ghost_communicator(&cell_structure.collect_ghost_force_comm);
      apply_vel_corr();
+     solve_rigid_clusters(solve_cluster_vel, 1);
      ghost_communicator(&cell_structure.update_ghost_pos_comm);
-     if(this_node == 0)
-       MPI_Reduce(&repeat_, &repeat, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-     else
-       MPI_Reduce(&repeat_, NULL, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-
-     MPI_Bcast(&repeat, 1, MPI_INT, 0, MPI_COMM_WORLD);
      cnt++;
    }
 
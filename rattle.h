@@ -29,10 +29,15 @@ extern int n_rigidbonds;
     of the \ref Particle structure. Invoked from \ref correct_pos_shake() */
 void save_old_pos();
 
-/** Propagate velocity and position while using SHAKE algorithm for bond constraint.*/
+/** Propagate velocity and position while using SHAKE algorithm for bond constraint.
+    Clusters of rigid bonds between particles on the same node are solved
+    directly without communication, only the bonds to ghosts are iterated.
+    Updates the ghost positions, so that the caller does not have to. */
 void correct_pos_shake();
 
-/** Correction of current velocities using RATTLE algorithm*/
+/** Correction of current velocities using RATTLE algorithm. As for
+    \ref correct_pos_shake, clusters on one node are solved directly, and
+    the ghosts are updated. */
 void correct_vel_shake();
 
 /** set the parameter for a rigid, aka RATTLE bond */
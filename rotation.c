@@ -52,9 +52,6 @@ static double I[3] = { 1, 1, 1};
 /************************************************************/
 /*@{*/
 
-/** define rotation matrix A for a given particle */
-static void define_rotation_matrix(Particle *p, double A[9]);
-
 /** define first and second time derivatives of a quaternion, as well
     as the angular acceleration. */
 static void define_Qdd(Particle *p, double Qd[4], double Qdd[4], double S[3], double Wd[3]);
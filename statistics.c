@@ -19,6 +19,7 @@
 #include "statistics_molecule.h"
 #include "statistics_cluster.h"
 #include "statistics_fluid.h"
+#include "statistics_accumulate.h"
 #include "energy.h"
 #include "modes.h"
 #include "pressure.h"
@@ -103,32 +104,31 @@ static int get_reference_point(Tcl_Interp *interp, int *argc, char ***argv,
 
 double mindist(IntList *set1, IntList *set2)
 {
-  double mindist, pt[3];
-  int i, j, in_set;
+  double mindist, *pos;
+  int i, j, in_set, *type;
 
   mindist = SQR(box_l[0] + box_l[1] + box_l[2]);
 
-  updatePartCfg(WITHOUT_BONDS);
+  updatePartCfgFields(PCFG_POS | PCFG_TYPE);
+  pos  = partCfgFields.pos;
+  type = partCfgFields.type;
   for (j=0; j<n_total_particles-1; j++) {
-    pt[0] = partCfg[j].r.p[0];
-    pt[1] = partCfg[j].r.p[1];
-    pt[2] = partCfg[j].r.p[2];
     /* check which sets particle j belongs to
        bit 0: set1, bit1: set2
     */
     in_set = 0;
-    if (!set1 || intlist_contains(set1, partCfg[j].p.type))
+    if (!set1 || intlist_contains(set1, type[j]))
       in_set = 1;
-    if (!set2 || intlist_contains(set2, partCfg[j].p.type))
+    if (!set2 || intlist_contains(set2, type[j]))
       in_set |= 2;
     if (in_set == 0)
       continue;
 
     for (i=j+1; i<n_total_particles; i++)
       /* accept a pair if particle j is in set1 and particle i in set2 or vice versa. */
-      if (((in_set & 1) && (!set2 || intlist_contains(set2, partCfg[i].p.type))) ||
-	  ((in_set & 2) && (!set1 || intlist_contains(set1, partCfg[i].p.type))))
-	mindist = dmin(mindist, min_distance2(pt, partCfg[i].r.p));
+      if (((in_set & 1) && (!set2 || intlist_contains(set2, type[i]))) ||
+	  ((in_set & 2) && (!set1 || intlist_contains(set1, type[i]))))
+	mindist = dmin(mindist, min_distance2(&pos[3*j], &pos[3*i]));
   }
   mindist = sqrt(mindist);
   return mindist;
@@ -288,24 +288,115 @@ void momentum_calc(double *momentum)
 
 }
 
-void centermass(int type, double *com)
+/** number of wave vectors for \ref calc_structurefactor */
+static int structurefactor_n_q(int order)
 {
-  int i, j;
-  double M = 0.0;
-  com[0]=com[1]=com[2]=0.;
-   	
-  updatePartCfg(WITHOUT_BONDS);
-  for (j=0; j<n_total_particles; j++) {
-    if ((partCfg[j].p.type == type) || (type == -1)) {
-      for (i=0; i<3; i++) {
-      	com[i] += partCfg[j].r.p[i]*PMASS(partCfg[j]);
+  int i, j, k, n, n_q = 0;
+  for(i=0; i<=order; i++)
+    for(j=-order; j<=order; j++)
+      for(k=-order; k<=order; k++) {
+	n = i*i + j*j + k*k;
+	if ((n<=order*order) && (n>=1))
+	  n_q++;
+      }
+  return n_q;
+}
+
+void local_observable(int job, int *ipar, double *dpar, double *result)
+{
+  Cell *cell;
+  Particle *p;
+  int c, np, i, j, k, l, n, q, order, type;
+  double pos[3], tmp[3], massi, qr, twoPI_L;
+
+  switch (job) {
+  case OBS_CHAIN_COM:
+  case OBS_CHAIN_RG2:
+  case OBS_CHAIN_RE:
+    local_chain_observable(job, ipar, dpar, result);
+    return;
+  }
+
+  type = ipar[0];
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for (l = 0; l < np; l++) {
+      switch (job) {
+      case OBS_CENTERMASS:
+	if ((p[l].p.type == type) || (type == -1)) {
+	  local_unfolded_position(&p[l], pos);
+	  for (i=0; i<3; i++)
+	    result[i] += pos[i]*PMASS(p[l]);
+	  result[3] += PMASS(p[l]);
+	}
+	break;
+      case OBS_CENTERMASS_VEL:
+	if (p[l].p.type == type) {
+	  for (i=0; i<3; i++)
+	    result[i] += p[l].m.v[i];
+	  result[3]++;
+	}
+	break;
+      case OBS_ANGULARMOMENTUM:
+	if (p[l].p.type == type) {
+	  local_unfolded_position(&p[l], pos);
+	  vector_product(pos, p[l].m.v, tmp);
+	  for (i=0; i<3; i++)
+	    result[i] += tmp[i]*PMASS(p[l]);
+	}
+	break;
+      case OBS_MOMENTOFINERTIA:
+	if (p[l].p.type == type) {
+	  local_unfolded_position(&p[l], pos);
+	  for (i=0; i<3; i++)
+	    pos[i] -= dpar[i];
+	  massi = PMASS(p[l]);
+	  result[0] += massi * (pos[1] * pos[1] + pos[2] * pos[2]);
+	  result[4] += massi * (pos[0] * pos[0] + pos[2] * pos[2]);
+	  result[8] += massi * (pos[0] * pos[0] + pos[1] * pos[1]);
+	  result[1] -= massi * (pos[0] * pos[1]);
+	  result[2] -= massi * (pos[0] * pos[2]);
+	  result[5] -= massi * (pos[1] * pos[2]);
+	}
+	break;
+      case OBS_STRUCTUREFACTOR:
+	if (p[l].p.type == type) {
+	  local_unfolded_position(&p[l], pos);
+	  order = ipar[1];
+	  twoPI_L = 2*PI/box_l[0];
+	  q = 0;
+	  for(i=0; i<=order; i++)
+	    for(j=-order; j<=order; j++)
+	      for(k=-order; k<=order; k++) {
+		n = i*i + j*j + k*k;
+		if ((n<=order*order) && (n>=1)) {
+		  qr = twoPI_L * ( i*pos[0] + j*pos[1] + k*pos[2] );
+		  result[2*q]   += cos(qr);
+		  result[2*q+1] += sin(qr);
+		  q++;
+		}
+	      }
+	  result[2*q]++;
+	}
+	break;
+      default:
+	fprintf(stderr, "%d: INTERNAL ERROR: unknown observable %d\n", this_node, job);
+	errexit();
       }
-      M += PMASS(partCfg[j]);
     }
   }
-  
+}
+
+void centermass(int type, double *com)
+{
+  int i;
+  double sum[4];
+
+  mpi_gather_observable(OBS_CENTERMASS, 1, &type, 0, NULL, 4, sum);
   for (i=0; i<3; i++) {
-    com[i] /= M;
+    com[i] = sum[i]/sum[3];
   }
   return;
 }
@@ -313,72 +404,28 @@ void centermass(int type, double *com)
 void centermass_vel(int type, double *com)
 {
   /*center of mass velocity scaled with time_step*/
-  int i, j;
-  int count = 0;
-  com[0]=com[1]=com[2]=0.;
-
-  updatePartCfg(WITHOUT_BONDS);
-  for (j=0; j<n_total_particles; j++) {
-    if (type == partCfg[j].p.type) {
-      for (i=0; i<3; i++) {
-      	com[i] += partCfg[j].m.v[i];
-      }
-      count++;
-    }
-  }
+  int i;
+  double sum[4];
 
+  mpi_gather_observable(OBS_CENTERMASS_VEL, 1, &type, 0, NULL, 4, sum);
   for (i=0; i<3; i++) {
-    com[i] /= count;
+    com[i] = sum[i]/sum[3];
   }
   return;
 }
 
 void angularmomentum(int type, double *com)
 {
-  int i, j;
-  double tmp[3];
-  double pre_factor;
-  com[0]=com[1]=com[2]=0.;
-
-  updatePartCfg(WITHOUT_BONDS);
-  for (j=0; j<n_total_particles; j++) 
-  {
-    if (type == partCfg[j].p.type) 
-    {
-      vector_product(partCfg[j].r.p,partCfg[j].m.v,tmp);
-      pre_factor=PMASS(partCfg[j]);
-      for (i=0; i<3; i++) {
-        com[i] += tmp[i]*pre_factor;
-      }
-    }
-  }
+  mpi_gather_observable(OBS_ANGULARMOMENTUM, 1, &type, 0, NULL, 3, com);
   return;
 }
 
 void  momentofinertiamatrix(int type, double *MofImatrix)
 {
-  int i,j,count;
-  double p1[3],com[3],massi;
+  double com[3];
 
-  count=0;
-  updatePartCfg(WITHOUT_BONDS);
-  for(i=0;i<9;i++) MofImatrix[i]=0.;
   centermass(type, com);
-  for (j=0; j<n_total_particles; j++) {
-    if (type == partCfg[j].p.type) {
-      count ++;
-      for (i=0; i<3; i++) {
-      	p1[i] = partCfg[j].r.p[i] - com[i];
-      }
-      massi= PMASS(partCfg[j]);
-      MofImatrix[0] += massi * (p1[1] * p1[1] + p1[2] * p1[2]) ; 
-      MofImatrix[4] += massi * (p1[0] * p1[0] + p1[2] * p1[2]);
-      MofImatrix[8] += massi * (p1[0] * p1[0] + p1[1] * p1[1]);
-      MofImatrix[1] -= massi * (p1[0] * p1[1]);
-      MofImatrix[2] -= massi * (p1[0] * p1[2]); 
-      MofImatrix[5] -= massi * (p1[1] * p1[2]);
-    }
-  }
+  mpi_gather_observable(OBS_MOMENTOFINERTIA, 1, &type, 3, com, 9, MofImatrix);
   /* use symmetry */
   MofImatrix[3] = MofImatrix[1]; 
   MofImatrix[6] = MofImatrix[2]; 
@@ -603,6 +650,7 @@ void calc_vel_distr(Tcl_Interp *interp, int type,int bins,double given_max)
 
    centermass_vel(type,com);
 
+   updatePartCfg(WITHOUT_BONDS);
    for (i=0;i<n_total_particles;i++)
    {
       if (partCfg[i].p.type==type)
@@ -656,9 +704,9 @@ void calc_vel_distr(Tcl_Interp *interp, int type,int bins,double given_max)
 void calc_rdf(int *p1_types, int n_p1, int *p2_types, int n_p2, 
 	      double r_min, double r_max, int r_bins, double *rdf)
 {
-  int i,j,t1,t2,ind,cnt=0;
+  int i,j,t1,t2,ind,cnt=0,*type;
   int mixed_flag=0,start;
-  double inv_bin_width=0.0,bin_width=0.0, dist;
+  double inv_bin_width=0.0,bin_width=0.0, dist, *pos;
   double volume, bin_volume, r_in, r_out;
 
   if(n_p1 == n_p2) {
@@ -670,18 +718,21 @@ void calc_rdf(int *p1_types, int n_p1, int *p2_types, int n_p2,
   bin_width     = (r_max-r_min) / (double)r_bins;
   inv_bin_width = 1.0 / bin_width;
   for(i=0;i<r_bins;i++) rdf[i] = 0.0;
+  updatePartCfgFields(PCFG_POS | PCFG_TYPE);
+  pos  = partCfgFields.pos;
+  type = partCfgFields.type;
   /* particle loop: p1_types*/
   for(i=0; i<n_total_particles; i++) {
     for(t1=0; t1<n_p1; t1++) {
-      if(partCfg[i].p.type == p1_types[t1]) {
+      if(type[i] == p1_types[t1]) {
 	/* distinguish mixed and identical rdf's */
 	if(mixed_flag == 1) start = 0;
 	else                start = (i+1);
 	/* particle loop: p2_types*/
 	for(j=start; j<n_total_particles; j++) {
 	  for(t2=0; t2<n_p2; t2++) {
-	    if(partCfg[j].p.type == p2_types[t2]) {
-	      dist = min_distance(partCfg[i].r.p, partCfg[j].r.p);
+	    if(type[j] == p2_types[t2]) {
+	      dist = min_distance(&pos[3*i], &pos[3*j]);
 	      if(dist > r_min && dist < r_max) {
 		ind = (int) ( (dist - r_min)*inv_bin_width );
 		rdf[ind]++;
@@ -921,44 +972,42 @@ void calc_rdf_adress(int *p1_types, int n_p1, int *p2_types, int n_p2,
 /*Up to here*/
 
 void calc_structurefactor(int type, int order, double **_ff) {
-  int i, j, k, n, qi, p, order2;
-  double qr, twoPI_L, C_sum, S_sum, *ff=NULL;
+  int i, j, k, n, q, qi, order2, n_q, ipar[2];
+  double *ff=NULL, *sums;
   
   order2 = order*order;
   *_ff = ff = realloc(ff,2*order2*sizeof(double));
-  twoPI_L = 2*PI/box_l[0];
   
   if ((type < 0) || (type > n_particle_types)) { fprintf(stderr,"WARNING: Type %i does not exist!",type); fflush(NULL); errexit(); }
   else if (order < 1) { fprintf(stderr,"WARNING: parameter \"order\" has to be a whole positive number"); fflush(NULL); errexit(); }
   else {
+    /* the cosine and sine sums for each wave vector are collected from all nodes */
+    n_q = structurefactor_n_q(order);
+    sums = malloc((2*n_q+1)*sizeof(double));
+    ipar[0] = type;
+    ipar[1] = order;
+    mpi_gather_observable(OBS_STRUCTUREFACTOR, 2, ipar, 0, NULL, 2*n_q+1, sums);
+
     for(qi=0; qi<2*order2; qi++) {
       ff[qi] = 0.0;
     }
+    q = 0;
     for(i=0; i<=order; i++) {
       for(j=-order; j<=order; j++) {
         for(k=-order; k<=order; k++) {
 	  n = i*i + j*j + k*k;
 	  if ((n<=order2) && (n>=1)) {
-	    C_sum = S_sum = 0.0;
-	    for(p=0; p<n_total_particles; p++) {
-	      if (partCfg[p].p.type == type) {
-		qr = twoPI_L * ( i*partCfg[p].r.p[0] + j*partCfg[p].r.p[1] + k*partCfg[p].r.p[2] );
-		C_sum+= cos(qr);
-		S_sum+= sin(qr);
-	      }
-	    }
-	    ff[2*n-2]+= C_sum*C_sum + S_sum*S_sum;
+	    ff[2*n-2]+= SQR(sums[2*q]) + SQR(sums[2*q+1]);
 	    ff[2*n-1]++;
+	    q++;
 	  }
 	}
       }
     }
-    n = 0;
-    for(p=0; p<n_total_particles; p++) {
-      if (partCfg[p].p.type == type) n++;
-    }
+    n = (int)sums[2*n_q];
     for(qi=0; qi<order2; qi++) 
       if (ff[2*qi+1]!=0) ff[2*qi]/= n*ff[2*qi+1];
+    free(sums);
   }
 }
 
@@ -2767,7 +2816,7 @@ static int parse_rdf(Tcl_Interp *interp, int average, int argc, char **argv)
     Tcl_AppendResult(interp, " }", (char *)NULL);
   rdf = malloc(r_bins*sizeof(double));
 
-  if (!sortPartCfg()) { Tcl_AppendResult(interp, "for analyze, store particles consecutively starting with 0.",(char *) NULL); return (TCL_ERROR); }
+  if (average != 0 && !sortPartCfg()) { Tcl_AppendResult(interp, "for analyze, store particles consecutively starting with 0.",(char *) NULL); return (TCL_ERROR); }
 
   if(average==0)
     calc_rdf(p1.e, p1.max, p2.e, p2.max, r_min, r_max, r_bins, rdf);
@@ -2818,7 +2867,6 @@ int parse_structurefactor(Tcl_Interp *interp, int argc, char **argv)
       return (TCL_ERROR);
     argc-=2; argv+=2;
   }
-  updatePartCfg(WITHOUT_BONDS);
   calc_structurefactor(type, order, &sf); 
   
   qfak = 2.0*PI/box_l[0];
@@ -3654,6 +3702,7 @@ int analyze(ClientData data, Tcl_Interp *interp, int argc, char **argv)
   REGISTER_ANALYSIS_W_ARG("stress_tensor", parse_and_print_stress_tensor, 0);
   REGISTER_ANALYSIS("local_stress_tensor", parse_local_stress_tensor);
   REGISTER_ANALYSIS_W_ARG("p_inst", parse_and_print_pressure, 1);
+  REGISTER_ANALYSIS("accumulate", parse_accumulate);
   REGISTER_ANALYSIS("momentum", parse_and_print_momentum);
   REGISTER_ANALYSIS("bins", parse_bins);
   REGISTER_ANALYSIS("p_IK1", parse_and_print_p_IK1);
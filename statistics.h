@@ -17,6 +17,7 @@
 #include "interaction_data.h"
 #include "utils.h"
 #include "topology.h"
+#include "grid.h"
 
 /** \name Data Types */
 /************************************************************/
@@ -353,6 +354,49 @@ void calculate_verlet_neighbors();
  */
 void predict_momentum_particles(double *result);
 
+/** \name Distributed observables
+    Observables that are sums over the particles. Every node calculates the
+    contribution of its local particles, and \ref mpi_gather_observable sums
+    them up on the master node, so that no \ref partCfg is needed. */
+/*@{*/
+/** sum of m*r, and total mass, of the particles of type ipar[0] (-1 for all) */
+#define OBS_CENTERMASS      0
+/** sum of v, and number, of the particles of type ipar[0] */
+#define OBS_CENTERMASS_VEL  1
+/** sum of m*(r x v) of the particles of type ipar[0] */
+#define OBS_ANGULARMOMENTUM 2
+/** moment of inertia tensor of the particles of type ipar[0] around dpar */
+#define OBS_MOMENTOFINERTIA 3
+/** sums of cos(q*r) and sin(q*r) for the particles of type ipar[0] and
+    all wave vectors up to length ipar[1], then the number of particles */
+#define OBS_STRUCTUREFACTOR 4
+/** sum of m*r, and mass, for each of the ipar[1] chains of length ipar[2]
+    starting at particle ipar[0] */
+#define OBS_CHAIN_COM       5
+/** sum of (r - dpar)^2 for each chain, dpar being the centers of mass */
+#define OBS_CHAIN_RG2       6
+/** end to end vector for each chain */
+#define OBS_CHAIN_RE        7
+/*@}*/
+
+/** Add the contribution of the local particles to a distributed observable.
+    Used by \ref mpi_gather_observable, should not be used elsewhere.
+    \param job    the observable, see \ref OBS_CENTERMASS etc.
+    \param ipar   integer parameters
+    \param dpar   double parameters
+    \param result where to add the contribution
+*/
+void local_observable(int job, int *ipar, double *dpar, double *result);
+
+/** unfolded position of a local particle, as in \ref partCfg */
+MDINLINE void local_unfolded_position(Particle *p, double pos[3])
+{
+  int img[3];
+  memcpy(pos, p->r.p, 3*sizeof(double));
+  memcpy(img, p->l.i, 3*sizeof(int));
+  unfold_position(pos, img);
+}
+
 MDINLINE double *obsstat_bonded(Observable_stat *stat, int j)
 {
   return stat->bonded + stat->chunk_size*j;
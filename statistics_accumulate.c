@@ -0,0 +1,306 @@
+// This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+// It is therefore subject to the ESPResSo license agreement which you accepted upon receiving the distribution
+// and by which you are legally bound while utilizing this file in any form or way.
+// There is NO WARRANTY, not even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// You should have received a copy of that license along with this program;
+// if not, refer to http://www.espresso.mpg.de/license.html where its current version can be found, or
+// write to Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148, 55021 Mainz, Germany.
+// Copyright (c) 2002-2009; all rights reserved unless otherwise stated.
+/** \file statistics_accumulate.c
+    Implementation of \ref statistics_accumulate.h "statistics_accumulate.h".
+
+    The samples are shifted by the first one before they are summed
+    up, so that the fluctuations are not lost in the rounding errors of
+    a large mean value. The last samples are kept in a ring buffer to
+    accumulate the products of the samples with their predecessors for
+    the autocorrelation function. Together with the first samples, this
+    is enough to subtract the mean from the products afterwards.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "utils.h"
+#include "parser.h"
+#include "statistics.h"
+#include "energy.h"
+#include "pressure.h"
+#include "forces.h"
+#include "statistics_accumulate.h"
+
+/** Accumulator for one observable with one or more components. */
+typedef struct {
+  /** name used in 'analyze accumulate' */
+  char *name;
+  /** number of components */
+  int n_comp;
+  /** observable the integrator has to calculate */
+  int fused;
+  /** number of lags of the autocorrelation function, 0 if not active */
+  int n_lags;
+  /** number of samples */
+  int n_samples;
+  /** first sample of each component, subtracted from all samples */
+  double *shift;
+  /** sums of the shifted samples */
+  double *sum;
+  /** sums of the products of the shifted samples with their
+      predecessors, n_lags per component */
+  double *corr;
+  /** the first n_lags shifted samples, n_lags per component */
+  double *first;
+  /** the last n_lags shifted samples, n_lags per component */
+  double *history;
+} Accumulator;
+
+#define ACC_ENERGY        0
+#define ACC_PRESSURE      1
+#define ACC_STRESS_TENSOR 2
+#define N_ACCUMULATORS    3
+
+static Accumulator accumulators[N_ACCUMULATORS] = {
+  { "energy",        1, FUSED_OBS_ENERGY,   0, 0, NULL, NULL, NULL, NULL, NULL },
+  { "pressure",      1, FUSED_OBS_PRESSURE, 0, 0, NULL, NULL, NULL, NULL, NULL },
+  { "stress_tensor", 9, FUSED_OBS_PRESSURE, 0, 0, NULL, NULL, NULL, NULL, NULL }
+};
+
+/************************************************************/
+
+static void accumulator_start(Accumulator *acc, int n_lags)
+{
+  int n = acc->n_comp;
+
+  acc->n_lags    = n_lags;
+  acc->n_samples = 0;
+  acc->shift   = realloc(acc->shift,   n*sizeof(double));
+  acc->sum     = realloc(acc->sum,     n*sizeof(double));
+  acc->corr    = realloc(acc->corr,    n*n_lags*sizeof(double));
+  acc->first   = realloc(acc->first,   n*n_lags*sizeof(double));
+  acc->history = realloc(acc->history, n*n_lags*sizeof(double));
+  memset(acc->sum,  0, n*sizeof(double));
+  memset(acc->corr, 0, n*n_lags*sizeof(double));
+}
+
+static void accumulator_stop(Accumulator *acc)
+{
+  acc->n_lags    = 0;
+  acc->n_samples = 0;
+  free(acc->shift);   acc->shift   = NULL;
+  free(acc->sum);     acc->sum     = NULL;
+  free(acc->corr);    acc->corr    = NULL;
+  free(acc->first);   acc->first   = NULL;
+  free(acc->history); acc->history = NULL;
+}
+
+static void accumulator_add(Accumulator *acc, double *x)
+{
+  int c, k, t = acc->n_samples, l = acc->n_lags;
+  double y, *hist, *corr;
+
+  for (c = 0; c < acc->n_comp; c++) {
+    if (t == 0)
+      acc->shift[c] = x[c];
+    y    = x[c] - acc->shift[c];
+    hist = acc->history + c*l;
+    corr = acc->corr + c*l;
+
+    acc->sum[c] += y;
+    if (t < l)
+      acc->first[c*l + t] = y;
+    hist[t % l] = y;
+    for (k = 0; k < l && k <= t; k++)
+      corr[k] += y*hist[(t - k) % l];
+  }
+  acc->n_samples++;
+}
+
+/************************************************************/
+
+int accumulated_observables()
+{
+  int i, observables = 0;
+
+  for (i = 0; i < N_ACCUMULATORS; i++)
+    if (accumulators[i].n_lags > 0)
+      observables |= accumulators[i].fused;
+  return observables;
+}
+
+void accumulate_observables(int observables)
+{
+  Accumulator *acc;
+  double x[9];
+  int i, j;
+
+  acc = &accumulators[ACC_ENERGY];
+  if (acc->n_lags > 0 && (observables & FUSED_OBS_ENERGY)) {
+    x[0] = 0;
+    for (i = 0; i < total_energy.data.n; i++)
+      x[0] += total_energy.data.e[i];
+    accumulator_add(acc, x);
+  }
+
+  acc = &accumulators[ACC_PRESSURE];
+  if (acc->n_lags > 0 && (observables & FUSED_OBS_PRESSURE)) {
+    x[0] = 0;
+    for (i = 0; i < total_pressure.data.n; i++)
+      x[0] += total_pressure.data.e[i];
+    accumulator_add(acc, x);
+  }
+
+  acc = &accumulators[ACC_STRESS_TENSOR];
+  if (acc->n_lags > 0 && (observables & FUSED_OBS_PRESSURE)) {
+    for (j = 0; j < 9; j++) {
+      x[j] = 0;
+      for (i = 0; i < total_p_tensor.data.n/9; i++)
+	x[j] += total_p_tensor.data.e[9*i + j];
+    }
+    accumulator_add(acc, x);
+  }
+}
+
+/************************************************************/
+
+static void append_double(Tcl_Interp *interp, double value)
+{
+  char buffer[TCL_DOUBLE_SPACE];
+
+  Tcl_PrintDouble(interp, value, buffer);
+  Tcl_AppendResult(interp, " ", buffer, (char *)NULL);
+}
+
+/** Print the number of samples, the means, the variances, the errors
+    of the means, the integrated autocorrelation times and the
+    normalized autocorrelation functions of all components. */
+static void print_accumulator(Tcl_Interp *interp, Accumulator *acc)
+{
+  char buffer[TCL_INTEGER_SPACE];
+  int c, k, n = acc->n_samples, l = acc->n_lags;
+  int n_comp = acc->n_comp, n_acf = (n < l) ? n : l;
+  double *mean, *var, *tau, *acf, *first, *hist, *corr;
+  double ym, head, tail, ck, c0;
+
+  mean = malloc(n_comp*sizeof(double));
+  var  = malloc(n_comp*sizeof(double));
+  tau  = malloc(n_comp*sizeof(double));
+  acf  = malloc(n_comp*l*sizeof(double));
+
+  for (c = 0; c < n_comp; c++) {
+    first = acc->first + c*l;
+    hist  = acc->history + c*l;
+    corr  = acc->corr + c*l;
+    ym      = (n > 0) ? acc->sum[c]/n : 0;
+    mean[c] = (n > 0) ? acc->shift[c] + ym : 0;
+    var[c]  = (n > 1) ? (corr[0] - n*ym*ym)/(n - 1) : 0;
+
+    /* autocorrelation function normalized to its value at lag 0. For
+       lag k, the first factors of the products lack the first k
+       samples, and the second factors the last k samples. */
+    c0 = (n > 0) ? corr[0]/n - ym*ym : 0;
+    head = tail = 0;
+    for (k = 0; k < n_acf; k++) {
+      if (k > 0) {
+	head += first[k - 1];
+	tail += hist[(n - k) % l];
+      }
+      ck = (corr[k] - ym*(2*acc->sum[c] - head - tail))/(n - k) + ym*ym;
+      if (c0 > 0)
+	acf[c*l + k] = ck/c0;
+      else
+	acf[c*l + k] = (k == 0) ? 1 : 0;
+    }
+
+    /* integrated autocorrelation time, summed up to the first
+       negative value of the autocorrelation function */
+    tau[c] = 0.5;
+    for (k = 1; k < n_acf && acf[c*l + k] > 0; k++)
+      tau[c] += acf[c*l + k];
+  }
+
+  sprintf(buffer, "%d", n);
+  Tcl_AppendResult(interp, "{ samples ", buffer, " } { mean", (char *)NULL);
+  for (c = 0; c < n_comp; c++)
+    append_double(interp, mean[c]);
+  Tcl_AppendResult(interp, " } { variance", (char *)NULL);
+  for (c = 0; c < n_comp; c++)
+    append_double(interp, var[c]);
+  Tcl_AppendResult(interp, " } { error", (char *)NULL);
+  for (c = 0; c < n_comp; c++)
+    append_double(interp, (n > 0) ? sqrt(2*tau[c]*var[c]/n) : 0);
+  Tcl_AppendResult(interp, " } { tau", (char *)NULL);
+  for (c = 0; c < n_comp; c++)
+    append_double(interp, tau[c]);
+  Tcl_AppendResult(interp, " } { acf", (char *)NULL);
+  for (c = 0; c < n_comp; c++) {
+    if (n_comp > 1)
+      Tcl_AppendResult(interp, " {", (char *)NULL);
+    for (k = 0; k < n_acf; k++)
+      append_double(interp, acf[c*l + k]);
+    if (n_comp > 1)
+      Tcl_AppendResult(interp, " }", (char *)NULL);
+  }
+  Tcl_AppendResult(interp, " }", (char *)NULL);
+
+  free(mean);
+  free(var);
+  free(tau);
+  free(acf);
+}
+
+static int accumulate_usage(Tcl_Interp *interp)
+{
+  Tcl_AppendResult(interp, "usage: analyze accumulate [{ energy | pressure | stress_tensor } [start [<lags>] | stop]]", (char *)NULL);
+  return TCL_ERROR;
+}
+
+int parse_accumulate(Tcl_Interp *interp, int argc, char **argv)
+{
+  /* 'analyze accumulate [{ energy | pressure | stress_tensor } [start [<lags>] | stop]]' */
+  char buffer[2*TCL_INTEGER_SPACE];
+  Accumulator *acc = NULL;
+  int i, n_lags = 16;
+
+  if (argc == 0) {
+    /* list the active accumulators */
+    for (i = 0; i < N_ACCUMULATORS; i++) {
+      acc = &accumulators[i];
+      if (acc->n_lags > 0) {
+	sprintf(buffer, "%d samples %d", acc->n_lags, acc->n_samples);
+	Tcl_AppendResult(interp, "{ ", acc->name, " lags ", buffer, " } ", (char *)NULL);
+      }
+    }
+    return TCL_OK;
+  }
+
+  for (i = 0; i < N_ACCUMULATORS; i++)
+    if (ARG0_IS_S(accumulators[i].name))
+      acc = &accumulators[i];
+  if (!acc)
+    return accumulate_usage(interp);
+
+  if (argc == 1) {
+    if (acc->n_lags == 0) {
+      Tcl_AppendResult(interp, "the ", acc->name, " is not accumulated", (char *)NULL);
+      return TCL_ERROR;
+    }
+    print_accumulator(interp, acc);
+    return TCL_OK;
+  }
+
+  if (ARG1_IS_S("start")) {
+    if (argc > 3)
+      return accumulate_usage(interp);
+    if (argc == 3 && (!ARG_IS_I(2, n_lags) || n_lags < 1)) {
+      Tcl_ResetResult(interp);
+      Tcl_AppendResult(interp, "the number of lags must be a positive integer", (char *)NULL);
+      return TCL_ERROR;
+    }
+    accumulator_start(acc, n_lags);
+    return TCL_OK;
+  }
+  if (ARG1_IS_S("stop") && argc == 2) {
+    accumulator_stop(acc);
+    return TCL_OK;
+  }
+
+  return accumulate_usage(interp);
+}
@@ -0,0 +1,46 @@
+// This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+// It is therefore subject to the ESPResSo license agreement which you accepted upon receiving the distribution
+// and by which you are legally bound while utilizing this file in any form or way.
+// There is NO WARRANTY, not even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// You should have received a copy of that license along with this program;
+// if not, refer to http://www.espresso.mpg.de/license.html where its current version can be found, or
+// write to Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148, 55021 Mainz, Germany.
+// Copyright (c) 2002-2009; all rights reserved unless otherwise stated.
+#ifndef STATISTICS_ACCUMULATE_H
+#define STATISTICS_ACCUMULATE_H
+/** \file statistics_accumulate.h
+
+    Accumulators for the total energy, the total pressure and the
+    components of the total stress tensor. While an accumulator is
+    active, every integrate call calculates the observable along with
+    its last step (see \ref integrate_vv), and the result is added to
+    the running sums on the master node. Means, variances and
+    autocorrelation functions are only evaluated when requested via
+    'analyze accumulate'. One sample is taken per integrate call, so
+    this is also the unit of the lag times.
+
+    For more information see \ref statistics_accumulate.c "statistics_accumulate.c".
+*/
+#include <tcl.h>
+
+/** \name Exported Functions */
+/************************************************************/
+/*@{*/
+
+/** The observables that the integrator has to calculate for the
+    active accumulators, a combination of \ref FUSED_OBS_ENERGY and
+    \ref FUSED_OBS_PRESSURE. */
+int accumulated_observables();
+
+/** Add the current total energy, pressure and stress tensor to the
+    respective active accumulators. Called on the master node after
+    an integrate call has calculated the observables.
+    @param observables the observables that have been calculated. */
+void accumulate_observables(int observables);
+
+/** Implementation of 'analyze accumulate'. */
+int parse_accumulate(Tcl_Interp *interp, int argc, char **argv);
+
+/*@}*/
+
+#endif
@@ -15,6 +15,7 @@
 #include "topology.h"
 #include "communication.h"
 #include "cells.h"
+#include "grid.h"
 
 /** Particles' initial positions (needed for g1(t), g2(t), g3(t) in \ref #analyze) */
 /*@{*/
@@ -29,26 +30,76 @@ int chain_n_chains = 0;
 int chain_length = 0;
 /*@}*/
 
+void local_chain_observable(int job, int *ipar, double *dpar, double *result)
+{
+  Cell *cell;
+  Particle *p;
+  int c, np, l, i, id, chain, mon;
+  int start = ipar[0], n_chains = ipar[1], length = ipar[2];
+  double pos[3];
+
+  for (c = 0; c < local_cells.n; c++) {
+    cell = local_cells.cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for (l = 0; l < np; l++) {
+      id = p[l].p.identity - start;
+      if (id < 0 || id >= n_chains*length)
+	continue;
+      chain = id / length;
+      mon   = id % length;
+      local_unfolded_position(&p[l], pos);
+
+      switch (job) {
+      case OBS_CHAIN_COM:
+	for (i = 0; i < 3; i++)
+	  result[4*chain + i] += pos[i]*PMASS(p[l]);
+	result[4*chain + 3] += PMASS(p[l]);
+	break;
+      case OBS_CHAIN_RG2:
+	for (i = 0; i < 3; i++)
+	  result[chain] += SQR(pos[i] - dpar[3*chain + i]);
+	break;
+      case OBS_CHAIN_RE:
+	if (mon == 0)
+	  for (i = 0; i < 3; i++)
+	    result[3*chain + i] -= pos[i];
+	if (mon == length - 1)
+	  for (i = 0; i < 3; i++)
+	    result[3*chain + i] += pos[i];
+	break;
+      }
+    }
+  }
+}
+
+/** chain structure as parameters for \ref mpi_gather_observable */
+static void chain_observable_params(int ipar[3])
+{
+  ipar[0] = chain_start;
+  ipar[1] = chain_n_chains;
+  ipar[2] = chain_length;
+}
+
 void calc_re(double **_re)
 {
-  int i;
-  double dx,dy,dz;
+  int i, ipar[3];
   double dist=0.0,dist2=0.0,dist4=0.0;
-  double *re=NULL, tmp;
+  double *re=NULL, *ree, tmp;
   *_re = re = realloc(re,4*sizeof(double));
 
+  chain_observable_params(ipar);
+  ree = malloc(3*chain_n_chains*sizeof(double));
+  mpi_gather_observable(OBS_CHAIN_RE, 3, ipar, 0, NULL,
+			3*chain_n_chains, ree);
+
   for (i=0; i<chain_n_chains; i++) {
-    dx = partCfg[chain_start+i*chain_length + chain_length-1].r.p[0]
-      - partCfg[chain_start+i*chain_length].r.p[0];
-    dy = partCfg[chain_start+i*chain_length + chain_length-1].r.p[1]
-      - partCfg[chain_start+i*chain_length].r.p[1];
-    dz = partCfg[chain_start+i*chain_length + chain_length-1].r.p[2]
-      - partCfg[chain_start+i*chain_length].r.p[2];
-    tmp = (SQR(dx) + SQR(dy) + SQR(dz));
+    tmp = (SQR(ree[3*i]) + SQR(ree[3*i+1]) + SQR(ree[3*i+2]));
     dist  += sqrt(tmp);
     dist2 += tmp;
     dist4 += tmp*tmp;
   }
+  free(ree);
   tmp = (double)chain_n_chains;
   re[0] = dist/tmp;
   re[2] = dist2/tmp;
@@ -87,41 +138,34 @@ void calc_re_av(double **_re)
 
 void calc_rg(double **_rg)
 {
-  int i, j, p;
-  double dx,dy,dz, r_CM_x,r_CM_y,r_CM_z;
+  int i, j, ipar[3];
   double r_G=0.0,r_G2=0.0,r_G4=0.0;
   double *rg=NULL,IdoubMPC, tmp;
-  double M;
+  double *com, *rg2;
   *_rg = rg = realloc(rg,4*sizeof(double));
 
+  /* first the centers of mass, then the squared distances to them */
+  chain_observable_params(ipar);
+  com = malloc(4*chain_n_chains*sizeof(double));
+  mpi_gather_observable(OBS_CHAIN_COM, 3, ipar, 0, NULL,
+			4*chain_n_chains, com);
+  for (i=0; i<chain_n_chains; i++)
+    for (j=0; j<3; j++)
+      com[3*i+j] = com[4*i+j]/com[4*i+3];
 
+  rg2 = malloc(chain_n_chains*sizeof(double));
+  mpi_gather_observable(OBS_CHAIN_RG2, 3, ipar,
+			3*chain_n_chains, com, chain_n_chains, rg2);
+
+  IdoubMPC = 1./(double)chain_length;
   for (i=0; i<chain_n_chains; i++) {
-    M=0.0;
-    r_CM_x = r_CM_y = r_CM_z = 0.0;
-    IdoubMPC = 1./(double)chain_length;
-    for (j=0; j<chain_length; j++) {
-        p = chain_start+i*chain_length + j;
-      r_CM_x += partCfg[p].r.p[0]*PMASS(partCfg[p]);
-      r_CM_y += partCfg[p].r.p[1]*PMASS(partCfg[p]);
-      r_CM_z += partCfg[p].r.p[2]*PMASS(partCfg[p]);
-      M += PMASS(partCfg[p]);
-    }
-    r_CM_x /= M;
-    r_CM_y /= M;
-    r_CM_z /= M;
-    tmp = 0.0;
-    for (j=0; j<chain_length; ++j) {
-      p = chain_start+i*chain_length + j;
-      dx = partCfg[p].r.p[0] - r_CM_x;
-      dy = partCfg[p].r.p[1] - r_CM_y;
-      dz = partCfg[p].r.p[2] - r_CM_z;
-      tmp += (SQR(dx) + SQR(dy) + SQR(dz));
-    }
-    tmp *= IdoubMPC;
+    tmp = rg2[i]*IdoubMPC;
     r_G  += sqrt(tmp);
     r_G2 += tmp;
     r_G4 += tmp*tmp;
   }
+  free(rg2);
+  free(com);
   tmp = (double)chain_n_chains;
   rg[0] = r_G/tmp;
   rg[2] = r_G2/tmp;
@@ -798,6 +842,23 @@ void update_mol_ids_setchains() {
 }
 
 
+/** like \ref check_and_parse_chain_structure_info, but for the distributed
+    observables, which do not need \ref partCfg */
+static int check_and_parse_chain_structure_info_local(Tcl_Interp *interp, int argc, char **argv)
+{
+  if (argc > 0)
+    if (parse_chain_structure_info(interp, argc, argv) != TCL_OK)
+      return TCL_ERROR;
+
+  if (n_total_particles != max_seen_particle + 1) {
+    Tcl_AppendResult(interp, "for analyze, store particles consecutively starting with 0.",
+		     (char *) NULL);
+    return (TCL_ERROR);
+  }
+
+  return TCL_OK;
+}
+
 int check_and_parse_chain_structure_info(Tcl_Interp *interp, int argc, char **argv)
 {
   if (argc > 0)
@@ -819,7 +880,8 @@ int parse_re(Tcl_Interp *interp, int average, int argc, char **argv)
   char buffer[4*TCL_DOUBLE_SPACE+4];
   double *re;
 
-  if (check_and_parse_chain_structure_info(interp, argc, argv) == TCL_ERROR)
+  if ((average ? check_and_parse_chain_structure_info(interp, argc, argv) :
+       check_and_parse_chain_structure_info_local(interp, argc, argv)) == TCL_ERROR)
     return TCL_ERROR;
   if ((argc != 0) && (argc != 3)) {
     Tcl_AppendResult(interp, "only chain structure info required", (char *)NULL);
@@ -850,7 +912,8 @@ int parse_rg(Tcl_Interp *interp, int average, int argc, char **argv)
   /* 'analyze { rg | <rg> } [<chain_start> <n_chains> <chain_length>]' */
   char buffer[4*TCL_DOUBLE_SPACE+4];
   double *rg;
-  if (check_and_parse_chain_structure_info(interp, argc, argv) == TCL_ERROR)
+  if ((average ? check_and_parse_chain_structure_info(interp, argc, argv) :
+       check_and_parse_chain_structure_info_local(interp, argc, argv)) == TCL_ERROR)
     return TCL_ERROR;
   if ((argc != 0) && (argc != 3)) {
     Tcl_AppendResult(interp, "only chain structure info required", (char *)NULL);
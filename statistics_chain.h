@@ -18,6 +18,11 @@
 /************************************************************/
 /*@{*/
 
+/** Add the contribution of the local particles to the chain observables
+    \ref OBS_CHAIN_COM, \ref OBS_CHAIN_RG2 and \ref OBS_CHAIN_RE.
+    Used by \ref local_observable. */
+void local_chain_observable(int job, int *ipar, double *dpar, double *result);
+
 /** calculate the end-to-end-distance. chain information \ref chain_start etc. must be set!
     @return the end-to-end-distance */
 void calc_re(double **re);
@@ -43,6 +43,10 @@ void lb_calc_fluid_mass(double *result) {
     for (y=1; y<=lblattice.grid[1]; y++) {
       for (z=1; z<=lblattice.grid[2]; z++) {
 	index = get_linear_index(x,y,z,lblattice.halo_grid);
+#ifdef CONSTRAINTS
+	/* boundary sites do not carry fluid */
+	if (lbfluid[index].boundary) continue;
+#endif
 
 	lb_calc_local_rho(&lbfluid[index]);
 	mass += *lbfluid[index].rho;
@@ -66,11 +70,16 @@ void lb_calc_fluid_momentum(double *result) {
 	for (y=1; y<=lblattice.grid[1]; y++) {
 	    for (z=1; z<=lblattice.grid[2]; z++) {
 		index = get_linear_index(x,y,z,lblattice.halo_grid);
+#ifdef CONSTRAINTS
+		if (lbfluid[index].boundary) continue;
+#endif
 
+		/* include the momentum from the particles which is
+		 * not yet added to the populations */
 		lb_calc_local_j(&lbfluid[index]);
-		momentum[0] += lbfluid[index].j[0];
-		momentum[1] += lbfluid[index].j[1];
-		momentum[2] += lbfluid[index].j[2];
+		momentum[0] += lbfluid[index].j[0] + lbfluid[index].coupling_j[0];
+		momentum[1] += lbfluid[index].j[1] + lbfluid[index].coupling_j[1];
+		momentum[2] += lbfluid[index].j[2] + lbfluid[index].coupling_j[2];
 
 	    }
 	}
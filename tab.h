@@ -36,13 +36,18 @@ MDINLINE int tabforcecap_set_params(double tabforcecap)
     @param part_type_a particle type for which the interaction is defined
     @param part_type_b particle type for which the interaction is defined
     @param filename from which file to fetch the data
+    @param spline   if non-zero, interpolate by cubic splines
     @return <ul>
     <li> 0 on success
     <li> 1 on particle type mismatches
-    <li> 2 
+    <li> 2 if the filename is too long
+    <li> 3 if the file cannot be opened
+    <li> 4 if the start token is missing
+    <li> 5 if the number of points does not match the existing table
+    <li> 6 if spline interpolation is requested for less than two points
     </ul>
 */
-MDINLINE int tabulated_set_params(int part_type_a, int part_type_b, char* filename)
+MDINLINE int tabulated_set_params(int part_type_a, int part_type_b, char* filename, int spline)
 {
   IA_parameters *data, *data_sym;
   FILE* fp;
@@ -84,6 +89,12 @@ MDINLINE int tabulated_set_params(int part_type_a, int part_type_b, char* filena
   fscanf( fp, "%lf ", &minval);
   fscanf( fp, "%lf ", &maxval);
 
+  /* a spline needs at least one interval */
+  if ( spline && npoints < 2 ) {
+    fclose(fp);
+    return 6;
+  }
+
   // Set the newsize to the same as old size : only changed if a new force table is being added.
   newsize = tabulated_forces.max;
 
@@ -103,6 +114,7 @@ MDINLINE int tabulated_set_params(int part_type_a, int part_type_b, char* filena
   /* Update parameters symmetrically */
   data->TAB_maxval    = data_sym->TAB_maxval    = maxval;
   data->TAB_minval    = data_sym->TAB_minval    = minval;
+  data->TAB_spline    = data_sym->TAB_spline    = spline;
   strcpy(data->TAB_filename,filename);
   strcpy(data_sym->TAB_filename,filename);
 
@@ -314,6 +326,7 @@ MDINLINE int tab_parser(Tcl_Interp * interp,
 			int argc, char ** argv)
 {
   char *filename = NULL;
+  int spline = 0;
 
   /* tabulated interactions should supply a file name for a file containing
      both force and energy profiles as well as number of points, max
@@ -321,15 +334,17 @@ MDINLINE int tab_parser(Tcl_Interp * interp,
   */
   if (argc < 2) {
     Tcl_AppendResult(interp, "tabulated potentials require a filename: "
-		     "<filename>",
+		     "<filename> [spline]",
 		     (char *) NULL);
     return 0;
   }
 
   /* copy tabulated parameters */
   filename = argv[1];
+  if (argc > 2 && ARG_IS_S(2, "spline"))
+    spline = 1;
   
-  switch (tabulated_set_params(part_type_a, part_type_b, filename)) {
+  switch (tabulated_set_params(part_type_a, part_type_b, filename, spline)) {
   case 1:
     Tcl_AppendResult(interp, "particle types must be non-negative", (char *) NULL);
     return 0;
@@ -347,17 +362,22 @@ MDINLINE int tab_parser(Tcl_Interp * interp,
   case 5:
     Tcl_AppendResult(interp, "number of data points does not match the existing table", (char *)NULL);
     return 0;
+  case 6:
+    Tcl_AppendResult(interp, "spline interpolation requires at least 2 data points in \"",
+		     filename, "\"", (char *)NULL);
+    return 0;
     
   }
-  return 2;
+  return 2 + spline;
 }
 
-/** Add a non-bonded pair force by linear interpolation from a table.
+/** Add a non-bonded pair force by linear or cubic spline interpolation
+    from a table.
     Needs feature TABULATED compiled in (see \ref config.h). */
 MDINLINE void add_tabulated_pair_force(Particle *p1, Particle *p2, IA_parameters *ia_params,
 				       double d[3], double dist, double force[3])
 {
-  double phi, dindex, fac;
+  double phi, dindex, fac, *c;
   int tablepos, table_start,j;
   double rescaled_force_cap = tab_force_cap/dist;
   double maxval = ia_params->TAB_maxval;
@@ -373,7 +393,12 @@ MDINLINE void add_tabulated_pair_force(Particle *p1, Particle *p2, IA_parameters
 
       if ( dist > minval ) {
        phi = dindex - tablepos;	  
-       fac = tabulated_forces.e[table_start + tablepos]*(1-phi) + tabulated_forces.e[table_start + tablepos+1]*phi;
+       if (ia_params->TAB_spline) {
+	 c = &tabulated_splines.e[8*(table_start + tablepos)];
+	 fac = ((c[3]*phi + c[2])*phi + c[1])*phi + c[0];
+       }
+       else
+	 fac = tabulated_forces.e[table_start + tablepos]*(1-phi) + tabulated_forces.e[table_start + tablepos+1]*phi;
       }
       else {
 	/* Use an extrapolation beyond the table */
@@ -397,11 +422,12 @@ MDINLINE void add_tabulated_pair_force(Particle *p1, Particle *p2, IA_parameters
   }
 }
 
-/** Add a non-bonded pair energy by linear interpolation from a table.
+/** Add a non-bonded pair energy by linear or cubic spline interpolation
+    from a table.
     Needs feature TABULATED compiled in (see \ref config.h). */
 MDINLINE double tabulated_pair_energy(Particle *p1, Particle *p2, IA_parameters *ia_params,
 				      double d[3], double dist) {
-  double phi, dindex;
+  double phi, dindex, *c;
   int tablepos, table_start;
   double x0, b;
   
@@ -426,6 +452,11 @@ MDINLINE double tabulated_pair_energy(Particle *p1, Particle *p2, IA_parameters
     }
 
     phi = (dindex - tablepos);
+
+    if (ia_params->TAB_spline) {
+      c = &tabulated_splines.e[8*(table_start + tablepos) + 4];
+      return ((c[3]*phi + c[2])*phi + c[1])*phi + c[0];
+    }
  
     return  tabulated_energies.e[table_start + tablepos]*(1-phi) 
       + tabulated_energies.e[table_start + tablepos+1]*phi;
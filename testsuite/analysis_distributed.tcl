@@ -0,0 +1,177 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Distributed observables                                   #
+#                                                           #
+# The observables that are summed up over the nodes or that #
+# use the compact particle gather have to agree with the    #
+# same quantities calculated from the particle data in Tcl. #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+puts "----------------------------------------------"
+puts "- Testcase analysis_distributed.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------------"
+
+set prec 1e-4
+
+proc sqrlen {v} { return [vecdot_product $v $v] }
+
+proc check {what res ref} {
+    global prec
+    foreach a $res b $ref {
+	if { abs($a - $b) > $prec*(1 + abs($b)) } {
+	    error "analyze $what gives $res instead of $ref"
+	}
+    }
+}
+
+if { [ catch {
+
+setmd box_l 10 10 10
+setmd time_step 0.01
+setmd skin 0.3
+thermostat off
+
+# chains that are spread over the nodes and cross the box boundaries
+set n_chains 6
+set length 20
+set n_part [expr $n_chains*$length]
+set p 0
+for {set c 0} {$c < $n_chains} {incr c} {
+    set pos [list [expr 1.5*$c] 1.0 [expr 1.3*$c]]
+    for {set m 0} {$m < $length} {incr m} {
+	part $p pos [lindex $pos 0] [lindex $pos 1] [lindex $pos 2] type [expr $c % 2] \
+	    v [expr sin($p)] [expr cos($p)] [expr sin(2*$p)]
+	set pos [vecadd $pos [list [expr 0.3+0.1*sin($p)] [expr 0.8*cos(0.5*$p)] 0.4]]
+	incr p
+    }
+}
+integrate 0
+
+# reference values from the unfolded positions
+set com {0 0 0}
+set am {0 0 0}
+set n0 0
+for {set p 0} {$p < $n_part} {incr p} {
+    if { [part $p print type] == 0 } {
+	set r [part $p print pos]
+	set com [vecadd $com $r]
+	set am [vecadd $am [veccross_product3d $r [part $p print v]]]
+	incr n0
+    }
+}
+set com [vecscale [expr 1.0/$n0] $com]
+check "centermass" [analyze centermass 0] $com
+check "angularmomentum" [analyze angularmomentum 0] [vecscale [setmd time_step] $am]
+
+set re2 0
+set rg2 0
+for {set c 0} {$c < $n_chains} {incr c} {
+    set first [expr $c*$length]
+    set last [expr $first + $length - 1]
+    set re2 [expr $re2 + [sqrlen [vecsub [part $last print pos] [part $first print pos]]]/$n_chains]
+    set cm {0 0 0}
+    for {set p $first} {$p <= $last} {incr p} { set cm [vecadd $cm [part $p print pos]] }
+    set cm [vecscale [expr 1.0/$length] $cm]
+    for {set p $first} {$p <= $last} {incr p} {
+	set rg2 [expr $rg2 + [sqrlen [vecsub [part $p print pos] $cm]]/$length/$n_chains]
+    }
+}
+analyze set chains 0 $n_chains $length
+check "re" [lindex [analyze re] 2] $re2
+check "rg" [lindex [analyze rg] 2] $rg2
+
+# S(q) at the smallest wave vectors, q = 2pi/L (1 0 0) etc.
+set sq 0
+foreach q {{1 0 0} {0 1 0} {0 0 1} {0 -1 0} {0 0 -1}} {
+    set cs 0
+    set sn 0
+    for {set p 0} {$p < $n_part} {incr p} {
+	if { [part $p print type] == 0 } {
+	    set qr [expr 2*[PI]/[lindex [setmd box_l] 0]*[vecdot_product $q [part $p print pos]]]
+	    set cs [expr $cs + cos($qr)]
+	    set sn [expr $sn + sin($qr)]
+	}
+    }
+    set sq [expr $sq + ($cs*$cs + $sn*$sn)/$n0/5.0]
+}
+check "structurefactor" [lindex [lindex [analyze structurefactor 0 1] 0] 1] $sq
+
+# minimum image distances for mindist and rdf, which use the
+# compact position and type gather
+proc min_image_dist {a b} {
+    set d {}
+    foreach x [vecsub $a $b] l [setmd box_l] {
+	lappend d [expr $x - $l*round($x/$l)]
+    }
+    return [veclen $d]
+}
+
+set mind 1e10
+set r_bins 10
+set r_max 5.0
+for {set i 0} {$i < $r_bins} {incr i} { set hist($i) 0 }
+set cnt 0
+for {set i 0} {$i < $n_part} {incr i} {
+    set pi [part $i print pos]
+    set ti [part $i print type]
+    for {set j [expr $i+1]} {$j < $n_part} {incr j} {
+	set d [min_image_dist $pi [part $j print pos]]
+	if { $ti == 0 && [part $j print type] == 1 || $ti == 1 && [part $j print type] == 0 } {
+	    if { $d < $mind } { set mind $d }
+	}
+	if { $ti == 0 && [part $j print type] == 0 } {
+	    if { $d < $r_max } { incr hist([expr int($d*$r_bins/$r_max)]) }
+	    incr cnt
+	}
+    }
+}
+check "mindist" [analyze mindist 0 1] $mind
+
+set rdf {}
+set bw [expr $r_max/$r_bins]
+for {set i 0} {$i < $r_bins} {incr i} {
+    set vol [expr 4.0/3.0*[PI]*(pow(($i+1)*$bw,3) - pow($i*$bw,3))]
+    lappend rdf [expr $hist($i)*1000.0/($vol*$cnt)]
+}
+set res {}
+foreach b [lindex [analyze rdf 0 0 0 $r_max $r_bins] 1] { lappend res [lindex $b 1] }
+check "rdf" $res $rdf
+
+# the compact gather places center of mass virtual sites like partCfg,
+# even if they have not been updated by an integration
+if { [has_feature "VIRTUAL_SITES_COM"] } {
+    part deleteall
+    part 0 pos 1 1 1 type 0
+    part 1 pos 2 1 1 type 0
+    part 2 pos 5 5 5 type 2 virtual 1
+    part 3 pos 1.5 3 1 type 3
+    analyze set chains 0 1 3
+    analyze set topo_part_sync
+    check "mindist of a virtual site" [analyze mindist 2 3] 2.0
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
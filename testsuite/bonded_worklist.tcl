@@ -0,0 +1,123 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Bonded work list                                          #
+#                                                           #
+# The bonded forces of chains with pair, angle and dihedral #
+# bonds have to be the negative derivative of the bonded    #
+# energy for the different cell systems, also after the     #
+# bonds have been changed.                                  #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "BOND_ANGLE_COSINE"
+
+puts "----------------------------------------"
+puts "- Testcase bonded_worklist.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set epsilon 1e-4
+set h 1e-5
+
+# compare the forces of all particles to the numerical derivative of
+# the energy
+proc check_forces {what} {
+    global n_part epsilon h
+    integrate 0
+    for {set p 0} {$p < $n_part} {incr p} {
+	set f($p) [part $p print f]
+    }
+    for {set p 0} {$p < $n_part} {incr p} {
+	set pos [part $p print pos]
+	for {set d 0} {$d < 3} {incr d} {
+	    set x [lindex $pos $d]
+	    eval part $p pos [lreplace $pos $d $d [expr $x + $h]]
+	    set ep [analyze energy total]
+	    eval part $p pos [lreplace $pos $d $d [expr $x - $h]]
+	    set em [analyze energy total]
+	    part $p pos [lindex $pos 0] [lindex $pos 1] [lindex $pos 2]
+	    set fnum [expr -($ep - $em)/(2*$h)]
+	    set fcalc [lindex $f($p) $d]
+	    if { abs($fnum - $fcalc) > $epsilon*(1 + abs($fnum)) } {
+		error "$what: force of particle $p is $f($p), but the energy gives $fnum in direction $d"
+	    }
+	}
+    }
+}
+
+if { [ catch {
+
+setmd box_l 14 14 14
+setmd time_step 0.01
+setmd skin 0.3
+thermostat off
+
+inter 0 fene 7.0 1.5
+inter 1 harmonic 10.0 1.0
+inter 2 angle 1.5 [expr [PI]*2/3]
+inter 3 dihedral 2 1.0 0.5
+
+# chains crossing the periodic boundaries
+set n_chains 6
+set n_mono 10
+set n_part [expr $n_chains*$n_mono]
+for {set c 0} {$c < $n_chains} {incr c} {
+    for {set m 0} {$m < $n_mono} {incr m} {
+	set p [expr $c*$n_mono + $m]
+	part $p pos [expr 9.0 + 0.9*$m + 0.2*sin($p)] [expr 1.3*$c + 0.3*cos(2*$p)] [expr 0.5*$c + 0.4*sin(3*$p)] v 0 0 0
+    }
+}
+for {set c 0} {$c < $n_chains} {incr c} {
+    for {set m 0} {$m < $n_mono} {incr m} {
+	set p [expr $c*$n_mono + $m]
+	if { $m > 0 } {
+	    part $p bond [expr $m % 2] [expr $p - 1]
+	}
+	if { $m > 0 && $m < $n_mono - 1 } {
+	    part $p bond 2 [expr $p - 1] [expr $p + 1]
+	}
+	if { $m > 1 && $m < $n_mono - 1 } {
+	    part $p bond 3 [expr $p - 2] [expr $p - 1] [expr $p + 1]
+	}
+    }
+}
+
+foreach cs {"domain_decomposition" "domain_decomposition -no_verlet_list" "nsquare"} {
+    eval cellsystem $cs
+    check_forces $cs
+}
+
+# the work list has to follow changes of the bonds and their parameters
+cellsystem domain_decomposition
+check_forces "domain_decomposition"
+for {set c 0} {$c < $n_chains - 1} {incr c} {
+    part [expr $c*$n_mono] bond 1 [expr ($c + 1)*$n_mono]
+}
+part 5 bond delete
+check_forces "added bonds"
+inter 1 harmonic 20.0 0.8
+check_forces "changed bond parameters"
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
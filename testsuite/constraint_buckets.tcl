@@ -0,0 +1,163 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Constraint buckets                                        #
+#                                                           #
+# Particles in a porous matrix of many spheres and          #
+# cylinders above a wall. The forces have to agree with     #
+# the sum over all constraints calculated here, also after  #
+# constraints or the cutoff have been changed.              #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "CONSTRAINTS"
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase constraint_buckets.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set epsilon 1e-8
+
+# vector from the closest point of a constraint to the position
+proc constraint_vec {con x y z} {
+    foreach {type cx cy cz rad len} $con break
+    switch $type {
+	wall { return [list 0 0 [expr $z - $cz]] }
+	sphere {
+	    set r [expr sqrt(($x-$cx)*($x-$cx) + ($y-$cy)*($y-$cy) + ($z-$cz)*($z-$cz))]
+	    set fac [expr ($r - $rad)/$r]
+	    return [list [expr $fac*($x-$cx)] [expr $fac*($y-$cy)] [expr $fac*($z-$cz)]]
+	}
+	cylinder {
+	    # cylinders are along the z axis
+	    set rho [expr sqrt(($x-$cx)*($x-$cx) + ($y-$cy)*($y-$cy))]
+	    set fac [expr $rho > $rad ? ($rho - $rad)/$rho : 0]
+	    set dz [expr $z - $cz]
+	    if { abs($dz) > $len } {
+		set vz [expr $dz > 0 ? $dz - $len : $dz + $len]
+	    } else {
+		set vz 0
+	    }
+	    return [list [expr $fac*($x-$cx)] [expr $fac*($y-$cy)] $vz]
+	}
+    }
+}
+
+# Lennard-Jones force of all constraints on a particle
+proc reference_force {x y z} {
+    global constraints lj_cut
+    set f {0 0 0}
+    foreach con $constraints {
+	set v [constraint_vec $con $x $y $z]
+	set dist [expr sqrt([lindex $v 0]*[lindex $v 0] + [lindex $v 1]*[lindex $v 1] + [lindex $v 2]*[lindex $v 2])]
+	if { $dist < $lj_cut } {
+	    set frac6 [expr pow($dist, -6)]
+	    set fac [expr 48*$frac6*($frac6 - 0.5)/($dist*$dist)]
+	    set f [list [expr [lindex $f 0] + $fac*[lindex $v 0]] \
+		       [expr [lindex $f 1] + $fac*[lindex $v 1]] \
+		       [expr [lindex $f 2] + $fac*[lindex $v 2]]]
+	}
+    }
+    return $f
+}
+
+proc check_forces {what} {
+    global n_part epsilon
+    integrate 0
+    for {set p 0} {$p < $n_part} {incr p} {
+	set ref [eval reference_force [part $p print pos]]
+	set f [part $p print f]
+	foreach a $f b $ref {
+	    if { abs($a - $b) > $epsilon*(1 + abs($b)) } {
+		error "$what: force on particle $p is $f instead of $ref"
+	    }
+	}
+    }
+}
+
+if { [ catch {
+
+set box 12.0
+setmd box_l $box $box $box
+setmd time_step 0.01
+setmd skin 0.3
+thermostat off
+cellsystem nsquare
+
+set lj_cut 1.5
+inter 0 1 lennard-jones 1.0 1.0 $lj_cut 0 0
+
+# the matrix
+expr srand(4711)
+set constraints {}
+constraint wall normal 0 0 1 dist 0.5 type 1
+lappend constraints {wall 0 0 0.5 0 0}
+for {set i 0} {$i < 4} {incr i} {
+    for {set j 0} {$j < 4} {incr j} {
+	for {set k 0} {$k < 4} {incr k} {
+	    set cx [expr 3*$i + 1.5 + 0.5*(rand() - 0.5)]
+	    set cy [expr 3*$j + 1.5 + 0.5*(rand() - 0.5)]
+	    set cz [expr 3*$k + 1.5 + 0.5*(rand() - 0.5)]
+	    if { ($i + $j + $k) % 3 == 0 } {
+		constraint cylinder center $cx $cy $cz axis 0 0 1 radius 0.4 length 0.6 direction 1 type 1
+		lappend constraints [list cylinder $cx $cy $cz 0.4 0.6]
+	    } else {
+		constraint sphere center $cx $cy $cz radius 0.5 direction 1 type 1
+		lappend constraints [list sphere $cx $cy $cz 0.5 0]
+	    }
+	}
+    }
+}
+
+# particles in the pores, not too close to any constraint
+set n_part 0
+while { $n_part < 200 } {
+    set pos [list [expr $box*rand()] [expr $box*rand()] [expr 1.2 + ($box - 1.2)*rand()]]
+    set ok 1
+    foreach con $constraints {
+	set v [eval constraint_vec [list $con] $pos]
+	if { [lindex $con 0] != "wall" && [lindex $v 0]*[lindex $v 0] + [lindex $v 1]*[lindex $v 1] + [lindex $v 2]*[lindex $v 2] < 0.8*0.8 } {
+	    set ok 0
+	    break
+	}
+    }
+    if { $ok } {
+	eval part $n_part pos $pos type 0
+	incr n_part
+    }
+}
+
+check_forces "matrix"
+
+constraint delete [expr [llength $constraints] - 1]
+set constraints [lrange $constraints 0 end-1]
+check_forces "deleted constraint"
+
+set lj_cut 2.5
+inter 0 1 lennard-jones 1.0 1.0 $lj_cut 0 0
+check_forces "larger cutoff"
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,127 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Counter based random numbers for the thermostats          #
+#                                                           #
+# With counter_rng_seed set, a thermalized trajectory must  #
+# not depend on the cell system, i.e. on the distribution   #
+# of the particles over the nodes and cells.                #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+puts "----------------------------------------"
+puts "- Testcase counter_rng.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set prec 1e-8
+
+proc run_system {{fixed 0}} {
+    global n_part
+    part deleteall
+    for {set p 0} {$p < $n_part} {incr p} {
+	part $p pos [expr ($p%5)*1.5+0.3] [expr (($p/5)%5)*1.5+0.3] [expr ($p/25)*1.5+0.3] \
+	    v [expr sin($p)] [expr cos($p)] [expr sin(3*$p)]
+    }
+    # particle 0 sits in the corner of the box, so that its pairs
+    # also involve ghosts
+    if { $fixed } {
+	part 0 v 0 0 0 fix 1 1 1
+    }
+    setmd counter_rng_seed 4711
+    integrate 0
+    integrate 100
+    set res {}
+    for {set p 0} {$p < $n_part} {incr p} {
+	lappend res [part $p print pos v]
+    }
+    return $res
+}
+
+proc compare {what ref res} {
+    global n_part prec
+    for {set p 0} {$p < $n_part} {incr p} {
+	foreach a [lindex $res $p] b [lindex $ref $p] {
+	    if { abs($a - $b) > $prec } {
+		error "$what: particle $p is [lindex $res $p] instead of [lindex $ref $p]"
+	    }
+	}
+    }
+}
+
+if { [ catch {
+
+# the generator itself
+setmd counter_rng_seed 17
+set u1 [t_random counter uniform 7 3]
+set u2 [t_random counter uniform 7 3]
+if { $u1 != $u2 || [llength $u1] != 7 } {
+    error "counter generator is not reproducible: $u1 / $u2"
+}
+if { [t_random counter uniform 7 4] == $u1 } {
+    error "counter generator gives the same numbers for different indices"
+}
+set g [t_random counter gaussian 4000 0]
+set sum 0; set sum2 0
+foreach x $g { set sum [expr $sum + $x]; set sum2 [expr $sum2 + $x*$x] }
+set mean [expr $sum/4000.]
+set var [expr $sum2/4000. - $mean*$mean]
+if { abs($mean) > 0.1 || abs($var - 1) > 0.1 } {
+    error "gaussian numbers have mean $mean and variance $var"
+}
+
+# thermostats
+setmd box_l 7.5 7.5 7.5
+setmd time_step 0.01
+setmd skin 0.3
+inter 0 0 lennard-jones 1.0 1.0 1.12246 0.25 0
+set n_part 100
+
+thermostat langevin 1.0 1.0
+cellsystem domain_decomposition
+set ref [run_system]
+cellsystem nsquare
+compare "langevin" $ref [run_system]
+
+if { [regexp "DPD" [code_info]] } {
+    thermostat off
+    thermostat dpd 1.0 1.0 1.0
+    cellsystem domain_decomposition
+    set ref [run_system]
+    cellsystem nsquare
+    compare "dpd" $ref [run_system]
+
+    # the fixed particle is skipped by DPD also for ghost pairs
+    if { [regexp "EXTERNAL_FORCES" [code_info]] } {
+	cellsystem domain_decomposition
+	set ref [run_system 1]
+	if { [lindex $ref 0] != "0.3 0.3 0.3 0.0 0.0 0.0" } {
+	    error "fixed particle moved to [lindex $ref 0]"
+	}
+	cellsystem nsquare
+	compare "dpd with fixed particle" $ref [run_system 1]
+    }
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
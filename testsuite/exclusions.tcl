@@ -0,0 +1,122 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Exclusions                                                #
+#                                                           #
+# Exclusions are set, deleted and generated automatically   #
+# for bonded chains. The non-bonded forces have to be the   #
+# same with and without Verlet lists and for nsquare.       #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "EXCLUSIONS"
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase exclusions.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set epsilon 1e-8
+
+proc forces {} {
+    global n_part
+    integrate 0
+    set res {}
+    for {set p 0} {$p < $n_part} {incr p} {
+	lappend res [part $p print f]
+    }
+    return $res
+}
+
+if { [ catch {
+
+setmd box_l 10 10 10
+setmd time_step 0.01
+setmd skin 0.3
+thermostat off
+inter 0 0 lennard-jones 1.0 1.0 2.5 auto 0
+inter 0 harmonic 10.0 1.0
+
+# setting and deleting exclusions by hand
+part 0 pos 1 1 1
+part 1 pos 1.9 1 1
+for {set p 2} {$p < 8} {incr p} {
+    part $p pos [expr 5 + $p] 5 5
+}
+part 0 exclude 6 1 4 7 2
+if { [join [part 0 print exclusions]] != "1 2 4 6 7" } {
+    error "exclusions of particle 0 are [part 0 print exclusions] instead of 1 2 4 6 7"
+}
+if { [join [part 4 print exclusions]] != "0" } {
+    error "exclusions of particle 4 are [part 4 print exclusions] instead of 0"
+}
+part 0 exclude delete 4 7
+if { [join [part 0 print exclusions]] != "1 2 6" } {
+    error "exclusions of particle 0 are [part 0 print exclusions] instead of 1 2 6 after deleting"
+}
+
+# excluded pairs in range must not interact
+set n_part 8
+foreach f [lindex [forces] 0] {
+    if { $f != 0 } {
+	error "excluded particles 0 and 1 interact"
+    }
+}
+part 0 exclude delete 1
+if { [lindex [lindex [forces] 0] 0] == 0 } {
+    error "particles 0 and 1 do not interact after the exclusion was deleted"
+}
+part deleteall
+
+# chains with automatic exclusions
+set n_chains 20
+set n_mono 8
+set n_part [expr $n_chains*$n_mono]
+for {set c 0} {$c < $n_chains} {incr c} {
+    for {set m 0} {$m < $n_mono} {incr m} {
+	set p [expr $c*$n_mono + $m]
+	part $p pos [expr 1.0*$m + 0.1*sin($p)] [expr 1.1*($c%8) + 0.1*cos($p)] [expr 1.2*($c/8) + 0.1*sin(2*$p)]
+	if { $m > 0 } {
+	    part $p bond 0 [expr $p - 1]
+	}
+    }
+}
+part auto_exclusions 2
+
+cellsystem domain_decomposition
+set ref [forces]
+foreach cs {"domain_decomposition -no_verlet_list" "nsquare"} {
+    eval cellsystem $cs
+    set res [forces]
+    for {set p 0} {$p < $n_part} {incr p} {
+	foreach a [lindex $res $p] b [lindex $ref $p] {
+	    if { abs($a - $b) > $epsilon*(1 + abs($b)) } {
+		error "$cs: force of particle $p is [lindex $res $p] instead of [lindex $ref $p]"
+	    }
+	}
+    }
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,132 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Observables along with the forces                         #
+#                                                           #
+# The energy, pressure and stress tensor calculated during  #
+# the last integration step have to be the same as the      #
+# ones calculated separately afterwards.                    #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase fused_observables.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set epsilon 1e-9
+
+# all numbers of a nested list
+proc flat_numbers {l} {
+    set res {}
+    foreach e $l {
+	if { [llength $e] > 1 } {
+	    set res [concat $res [flat_numbers $e]]
+	} elseif { [string is double -strict $e] } {
+	    lappend res $e
+	}
+    }
+    return $res
+}
+
+proc observables {} {
+    return [list [analyze energy] [analyze pressure] [analyze stress_tensor]]
+}
+
+# force a separate calculation of the observables
+proc recalculated_observables {} {
+    eval part 0 pos [part 0 print pos]
+    return [observables]
+}
+
+proc compare {what res ref} {
+    global epsilon
+    set res [flat_numbers $res]
+    set ref [flat_numbers $ref]
+    if { [llength $res] != [llength $ref] } {
+	error "$what: got [llength $res] values instead of [llength $ref]"
+    }
+    foreach a $res b $ref {
+	if { abs($a - $b) > $epsilon*(1 + abs($b)) } {
+	    error "$what: $a instead of $b"
+	}
+    }
+}
+
+if { [ catch {
+
+setmd box_l 12 12 12
+setmd time_step 0.005
+setmd skin 0.4
+thermostat langevin 1.0 1.0
+
+inter 0 0 lennard-jones 1.0 1.0 1.12246 0.25 0
+inter 0 1 lennard-jones 1.0 1.0 2.5 auto 0
+inter 0 fene 7.0 2.5
+inter 1 harmonic 10.0 1.0
+
+# chains in a solvent
+expr srand(1234)
+set n_chains 10
+set n_mono 8
+set n_part 0
+for {set c 0} {$c < $n_chains} {incr c} {
+    for {set m 0} {$m < $n_mono} {incr m} {
+	part $n_part pos [expr 0.97*$m] [expr 1.15*$c] 0.5 type 0 mol $c
+	if { $m > 0 } {
+	    part $n_part bond [expr $m % 2] [expr $n_part - 1]
+	}
+	incr n_part
+    }
+}
+for {set i 0} {$i < 400} {incr i} {
+    part $n_part pos [expr 12*rand()] [expr 12*rand()] [expr 2 + 10*rand()] type 1 mol $n_chains
+    incr n_part
+}
+
+# warm up
+inter ljforcecap 20
+integrate 500
+inter ljforcecap 0
+integrate 100
+
+foreach cs {"domain_decomposition" "domain_decomposition -no_verlet_list" "nsquare"} {
+    eval cellsystem $cs
+    integrate 20 energy pressure
+    set res [observables]
+    compare "$cs" $res [recalculated_observables]
+
+    # only the energy requested
+    integrate 20 energy
+    set res [analyze energy]
+    compare "$cs, energy only" $res [lindex [recalculated_observables] 0]
+}
+
+# without any steps, nothing is calculated in advance
+integrate 0 energy pressure
+compare "no steps" [observables] [recalculated_observables]
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,79 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# BAOAB splitting of the Langevin thermostat                #
+#                                                           #
+# A Lennard-Jones fluid thermalized with                    #
+# thermostat langevin <temp> <gamma> baoab                  #
+# has to reach the thermostat temperature, also at a time   #
+# step larger than usual.                                   #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+puts "----------------------------------------"
+puts "- Testcase langevin_baoab.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set epsilon 3e-2
+
+if { [ catch {
+
+if { [regexp "ROTATION" [code_info]] } {
+    set deg_free 6
+} else {
+    set deg_free 3
+}
+
+setmd box_l 8 8 8
+setmd skin 0.3
+inter 0 0 lennard-jones 1.0 1.0 1.12246 0.25 0
+set n_part 256
+for {set p 0} {$p < $n_part} {incr p} {
+    part $p pos [expr ($p%8)*1.0+0.5] [expr (($p/8)%8)*1.0+0.5] [expr ($p/64)*2.0+0.5]
+}
+
+thermostat langevin 1.5 1.0 baoab
+if { [lindex [lindex [thermostat] 0] 3] != "baoab" } {
+    error "thermostat reports [thermostat] instead of langevin 1.5 1.0 baoab"
+}
+
+foreach dt {0.01 0.02} {
+    setmd time_step $dt
+    integrate 500
+
+    set temp 0
+    set n_samples 200
+    for {set i 0} {$i < $n_samples} {incr i} {
+	integrate 10
+	set temp [expr $temp + [analyze energy kin]/$n_part/($deg_free/2.)]
+    }
+    set temp [expr $temp/$n_samples]
+    puts "time step $dt: measured temperature $temp"
+    if { abs($temp - 1.5)/1.5 > $epsilon } {
+	error "time step $dt: temperature $temp instead of 1.5"
+    }
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
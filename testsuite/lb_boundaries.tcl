@@ -0,0 +1,130 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Lattice Boltzmann fluid in a cylindrical channel          #
+#                                                           #
+# 1) check conservation of fluid mass with boundaries       #
+# 2) check that the flow driven by an external force        #
+#    stays parallel to the channel axis                     #
+# 3) check that the walls slow down the flow                #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "LB"
+require_feature "CONSTRAINTS"
+require_feature "EXTERNAL_FORCES"
+
+puts "----------------------------------------"
+puts "- Testcase lb_boundaries.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+# Integration parameters
+#############################################################
+set int_steps     10
+set int_times     20
+
+set time_step     0.01
+set tau           0.01
+
+set agrid         1.0
+
+set box_l         12.0
+set radius        4.5
+
+set dens          1.0
+set viscosity     1.0
+set ext_force     0.001
+
+set skin          0.5
+
+set mom_prec      1.e-9
+set mass_prec     1.e-9
+
+if { [ catch {
+#############################################################
+# System Setup                                              #
+#############################################################
+
+setmd time_step $time_step
+setmd skin $skin
+
+setmd box_l $box_l $box_l $box_l
+setmd periodic 1 1 1
+cellsystem domain_decomposition -no_verlet_list
+
+# the channel has to exist before the fluid is set up
+set center [expr $box_l/2.0]
+constraint cylinder center $center $center $center axis 0 0 1 \
+    radius $radius length [expr 2*$box_l] direction -1 type 0
+
+lbfluid dens $dens visc $viscosity agrid $agrid tau $tau
+lbfluid ext_force 0.0 0.0 $ext_force
+
+thermostat lb 0.0
+
+set fluidmass [analyze fluid mass]
+
+#############################################################
+# Integration                                               #
+#############################################################
+set max_dmass 0.0
+
+for { set i 1 } { $i <= $int_times } { incr i } {
+
+    puts -nonewline "Loop $i of $int_times starting at time [format %f [setmd time]]\r"; flush stdout
+    integrate $int_steps
+
+    # check fluid mass conservation
+    set dmass [expr abs([analyze fluid mass]-$fluidmass)]
+    if { $dmass > $mass_prec } {
+	error "mass deviation too large $dmass"
+    }
+    if { $dmass > $max_dmass } { set max_dmass $dmass }
+
+    # the flow has to follow the channel
+    set mom [analyze fluid momentum]
+    if { abs([lindex $mom 0]) > $mom_prec || abs([lindex $mom 1]) > $mom_prec } {
+	error "flow perpendicular to the channel $mom"
+    }
+
+}
+
+#############################################################
+# Analysis and Verification                                 #
+#############################################################
+
+# without walls the momentum would grow linearly with the force
+set free_mom [expr $ext_force*$fluidmass*[setmd time]]
+set mom [lindex [analyze fluid momentum] 2]
+
+puts "\n"
+puts "Maximal mass deviation $max_dmass"
+puts "Momentum along the channel $mom (unbounded flow $free_mom)"
+
+if { $mom <= 0.0 || $mom >= $free_mom } {
+    error "walls do not act on the flow"
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
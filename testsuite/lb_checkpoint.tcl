@@ -0,0 +1,101 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Checkpointing of the Lattice Boltzmann fluid              #
+#                                                           #
+# 1) write a checkpoint of a fluctuating fluid              #
+# 2) change the fluid and its parameters                    #
+# 3) reload the checkpoint and compare the fluid state      #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "LB"
+
+puts "----------------------------------------"
+puts "- Testcase lb_checkpoint.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set time_step     0.01
+set tau           0.01
+set agrid         1.0
+set box_l         12.0
+set dens          0.85
+set viscosity     3.0
+set temp          1.0
+set skin          0.5
+
+set prec          1.e-12
+set chkfile       "lb_checkpoint.chk"
+
+proc fluid_state {} {
+    global box_l
+    set state [concat [analyze fluid mass] [analyze fluid momentum]]
+    for { set x 0 } { $x < $box_l } { incr x 3 } {
+	set state [concat $state [lbnode $x 1 [expr int($box_l)-1] print pi]]
+    }
+    return $state
+}
+
+if { [ catch {
+
+setmd time_step $time_step
+setmd skin $skin
+setmd box_l $box_l $box_l $box_l
+setmd periodic 1 1 1
+cellsystem domain_decomposition -no_verlet_list
+
+lbfluid dens $dens visc $viscosity agrid $agrid tau $tau
+thermostat lb $temp
+
+integrate 20
+
+lbfluid save_checkpoint $chkfile
+set saved [fluid_state]
+
+# change the fluid and its parameters
+integrate 20
+lbfluid visc [expr 2*$viscosity]
+integrate 5
+
+lbfluid load_checkpoint $chkfile
+set loaded [fluid_state]
+
+foreach s $saved l $loaded {
+    if { abs($s-$l) > $prec } {
+	error "fluid state differs after loading the checkpoint: $s != $l"
+    }
+}
+
+# a broken file must be rejected
+set f [open $chkfile "w"]
+puts $f "no checkpoint"
+close $f
+if { ![catch {lbfluid load_checkpoint $chkfile}] } {
+    error "loading an invalid checkpoint did not fail"
+}
+
+exec rm -f $chkfile
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
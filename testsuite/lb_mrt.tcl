@@ -0,0 +1,128 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Multiple relaxation time collision of the LB fluid        #
+#                                                           #
+# 1) without relaxation of the kinetic modes, the MRT       #
+#    collision agrees with the stress tensor update         #
+# 2) check conservation of mass and momentum of a           #
+#    fluctuating fluid with relaxed kinetic modes           #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "LB"
+
+puts "----------------------------------------"
+puts "- Testcase lb_mrt.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set int_steps     20
+set int_times     10
+
+set time_step     0.01
+set tau           0.01
+set agrid         1.0
+set box_l         12.0
+set dens          0.85
+set viscosity     3.0
+set temp          1.0
+set skin          0.5
+
+set prec          1.e-10
+set mom_prec      1.e-9
+set mass_prec     1.e-9
+set chkfile       "lb_mrt.chk"
+
+proc fluid_state {} {
+    global box_l
+    set state [concat [analyze fluid mass] [analyze fluid momentum]]
+    for { set x 0 } { $x < $box_l } { incr x 3 } {
+	set state [concat $state [lbnode $x 1 [expr int($box_l)-1] print pi]]
+    }
+    return $state
+}
+
+if { [ catch {
+
+setmd time_step $time_step
+setmd skin $skin
+setmd box_l $box_l $box_l $box_l
+setmd periodic 1 1 1
+cellsystem domain_decomposition -no_verlet_list
+
+lbfluid dens $dens visc $viscosity agrid $agrid tau $tau
+thermostat lb $temp
+
+# prepare a fluid with some flow on it
+integrate $int_steps
+thermostat lb 0.0
+lbfluid save_checkpoint $chkfile
+
+# stress tensor update
+integrate $int_steps
+set stress [fluid_state]
+
+# MRT collision with the kinetic modes set to equilibrium
+lbfluid load_checkpoint $chkfile
+lbfluid mrt 0.0 0.0
+integrate $int_steps
+set modes [fluid_state]
+
+foreach s $stress m $modes {
+    if { abs($s-$m) > $prec } {
+	error "MRT collision differs from the stress tensor update: $s != $m"
+    }
+}
+
+exec rm -f $chkfile
+
+# fluctuating fluid with relaxed kinetic modes
+lbfluid mrt 0.3 -0.2
+thermostat lb $temp
+
+set fluidmass [analyze fluid mass]
+set fluidmom [analyze fluid momentum]
+
+for { set i 1 } { $i <= $int_times } { incr i } {
+    integrate $int_steps
+
+    set dmass [expr abs([analyze fluid mass]-$fluidmass)]
+    if { $dmass > $mass_prec } {
+	error "mass deviation too large $dmass"
+    }
+    foreach m [analyze fluid momentum] m0 $fluidmom {
+	if { abs($m-$m0) > $mom_prec } {
+	    error "momentum deviation too large [expr $m-$m0]"
+	}
+    }
+}
+
+if { ![catch {lbfluid mrt 2.0 0.0}] } {
+    error "invalid relaxation parameter was accepted"
+}
+
+lbfluid mrt off
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,107 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Scheduling of the LB and MD time steps                    #
+#                                                           #
+# A constant force drives the fluid, so its momentum counts #
+# the fluid updates. Checked are time steps with ratios     #
+# 2/3 and 5/2 of the MD time step to tau, the latter also   #
+# with tau set before the MD time step.                     #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "LB"
+require_feature "EXTERNAL_FORCES"
+
+puts "----------------------------------------"
+puts "- Testcase lb_subcycle.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set time_step     0.01
+set agrid         1.0
+set box_l         6.0
+set dens          1.0
+set viscosity     1.0
+set ext_force     0.01
+set skin          0.5
+
+set mom_prec      1.e-9
+
+# check the number of fluid updates after integrating md_steps steps
+proc check_lb_steps { tau md_steps lb_steps } {
+    global ext_force box_l mom_prec
+
+    set mom [lindex [analyze fluid momentum] 2]
+    set expected [expr $ext_force*pow($box_l,3)*$tau*$lb_steps]
+    if { abs($mom-$expected) > $mom_prec } {
+	error "tau=$tau: fluid momentum $mom after $md_steps MD steps, expected $lb_steps fluid updates ($expected)"
+    }
+}
+
+if { [ catch {
+
+setmd time_step $time_step
+setmd skin $skin
+setmd box_l $box_l $box_l $box_l
+setmd periodic 1 1 1
+cellsystem domain_decomposition -no_verlet_list
+thermostat lb 0.0
+
+# tau larger than the MD time step: 2 fluid updates every 3 MD steps
+set tau 0.015
+lbfluid dens $dens visc $viscosity agrid $agrid tau $tau
+lbfluid ext_force 0.0 0.0 $ext_force
+
+set md_steps 0
+foreach { n lb_steps } { 1 0  1 1  1 2  27 20  1 20 } {
+    integrate $n
+    incr md_steps $n
+    check_lb_steps $tau $md_steps $lb_steps
+}
+
+# tau smaller than the MD time step: 5 fluid updates every 2 MD steps
+set tau 0.004
+lbfluid dens $dens visc $viscosity agrid $agrid tau $tau
+
+set md_steps 0
+foreach { n lb_steps } { 1 2  1 5  8 25 } {
+    integrate $n
+    incr md_steps $n
+    check_lb_steps $tau $md_steps $lb_steps
+}
+
+# the same ratio with tau set before the MD time step
+set tau 0.003
+lbfluid dens $dens visc $viscosity agrid $agrid tau $tau
+setmd time_step 0.0075
+
+set md_steps 0
+foreach { n lb_steps } { 1 2  1 5  8 25 } {
+    integrate $n
+    incr md_steps $n
+    check_lb_steps $tau $md_steps $lb_steps
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
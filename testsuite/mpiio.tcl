@@ -0,0 +1,140 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Parallel binary trajectories                              #
+#                                                           #
+# Frames written with mpiio have to give back the same      #
+# particles when read in again, in double and in single     #
+# precision, and when written asynchronously.               #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+puts "----------------------------------------"
+puts "- Testcase mpiio.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+proc dump {} {
+    global n_part
+    set res {}
+    for {set p 0} {$p < $n_part} {incr p} {
+	lappend res [concat [part $p print pos v type molecule_id]]
+    }
+    return $res
+}
+
+proc compare {what ref res prec} {
+    global n_part
+    for {set p 0} {$p < $n_part} {incr p} {
+	foreach a [lindex $res $p] b [lindex $ref $p] {
+	    if { abs($a - $b) > $prec*(1 + abs($b)) } {
+		error "$what: particle $p is [lindex $res $p] instead of [lindex $ref $p]"
+	    }
+	}
+    }
+}
+
+if { [ catch {
+
+setmd box_l 10 10 10
+setmd time_step 0.01
+setmd skin 0.3
+thermostat off
+inter 0 0 lennard-jones 1.0 1.0 1.12246 0.25 0
+
+set n_part 200
+for {set p 0} {$p < $n_part} {incr p} {
+    part $p pos [expr ($p%6)*1.6] [expr (($p/6)%6)*1.6] [expr ($p/36)*1.6] \
+	v [expr sin($p)] [expr cos($p)] [expr sin(3*$p)] type [expr $p%3] molecule_id [expr $p/10]
+}
+
+foreach mode {double float async} prec {1e-12 1e-6 1e-12} {
+    switch $mode {
+	float { mpiio open mpiio.traj pos v type molecule_id float }
+	async { mpiio open mpiio.traj pos v type molecule_id async }
+	default { mpiio open mpiio.traj pos v type molecule_id }
+    }
+    set ref {}
+    set times {}
+    for {set frame 0} {$frame < 3} {incr frame} {
+	integrate 20
+	mpiio write
+	lappend ref [dump]
+	lappend times [setmd time]
+    }
+    if { [mpiio pending] > 2 } {
+	error "$mode: [mpiio pending] frames pending, but only 2 can be"
+    }
+    mpiio wait
+    if { [mpiio pending] != 0 } {
+	error "$mode: still [mpiio pending] frames pending after wait"
+    }
+    mpiio close
+
+    if { [mpiio frames mpiio.traj] != 3 } {
+	error "$mode: [mpiio frames mpiio.traj] frames instead of 3"
+    }
+    foreach frame {1 0 -1} {
+	part deleteall
+	set t [mpiio read mpiio.traj $frame]
+	set i [expr ($frame + 3) % 3]
+	if { abs($t - [lindex $times $i]) > 1e-12 } {
+	    error "$mode: frame $frame has time $t instead of [lindex $times $i]"
+	}
+	compare "$mode frame $frame" [lindex $ref $i] [dump] $prec
+    }
+    exec rm -f mpiio.traj
+}
+
+# truncated and foreign files must be rejected. The truncated file
+# keeps the file header, the beginning of the first frame and the
+# frame index with the 16 byte footer.
+mpiio open mpiio.traj pos v
+for {set frame 0} {$frame < 3} {incr frame} {
+    integrate 1
+    mpiio write
+}
+mpiio close
+set f [open mpiio.traj r]
+fconfigure $f -translation binary
+set data [read $f]
+close $f
+set f [open mpiio_cut.traj w]
+fconfigure $f -translation binary
+puts -nonewline $f "[string range $data 0 99][string range $data end-39 end]"
+close $f
+foreach frame {0 2} {
+    if { ![catch {mpiio read mpiio_cut.traj $frame} msg] } {
+	error "frame $frame of a truncated file was read"
+    }
+}
+set f [open mpiio_cut.traj w]
+puts $f "no trajectory"
+close $f
+if { ![catch {mpiio read mpiio_cut.traj} msg] } {
+    error "a foreign file was read"
+}
+exec rm -f mpiio.traj mpiio_cut.traj
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,168 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Observable accumulators                                   #
+#                                                           #
+# The means, variances and autocorrelation functions of the #
+# energy, pressure and stress tensor accumulated during the #
+# integration have to agree with the ones calculated here   #
+# from the values after each integrate call.                #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase observable_accumulators.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set epsilon 1e-7
+set n_lags 5
+
+# mean, variance, error, tau and autocorrelation function of a series
+proc statistics {x} {
+    global n_lags
+    set n [llength $x]
+    set mean 0
+    foreach v $x { set mean [expr $mean + $v] }
+    set mean [expr $mean/$n]
+    set acf {}
+    for {set k 0} {$k < $n_lags && $k < $n} {incr k} {
+	set c 0
+	for {set t $k} {$t < $n} {incr t} {
+	    set c [expr $c + ([lindex $x $t] - $mean)*([lindex $x [expr $t - $k]] - $mean)]
+	}
+	lappend acf [expr $c/($n - $k)]
+    }
+    set var [expr [lindex $acf 0]*$n/($n - 1)]
+    set c0 [lindex $acf 0]
+    for {set k 0} {$k < [llength $acf]} {incr k} {
+	lset acf $k [expr [lindex $acf $k]/$c0]
+    }
+    # summed up to the first negative value
+    set tau 0.5
+    foreach a [lrange $acf 1 end] {
+	if { $a <= 0 } { break }
+	set tau [expr $tau + $a]
+    }
+    return [list $mean $var [expr sqrt(2*$tau*$var/$n)] $tau $acf]
+}
+
+proc compare_values {what a b scale} {
+    global epsilon
+    if { abs($a - $b) > $epsilon*$scale } {
+	error "$what is $a instead of $b"
+    }
+}
+
+# compare the accumulated statistics of one component
+proc check_component {what res c series} {
+    set n [lindex $res 0 1]
+    if { $n != [llength $series] } {
+	error "$what: $n samples instead of [llength $series]"
+    }
+    foreach {mean var err tau acf} [statistics $series] break
+    compare_values "$what: mean" [lindex $res 1 [expr $c + 1]] $mean [expr abs($mean) + sqrt($var)]
+    compare_values "$what: variance" [lindex $res 2 [expr $c + 1]] $var $var
+    compare_values "$what: error" [lindex $res 3 [expr $c + 1]] $err $err
+    compare_values "$what: tau" [lindex $res 4 [expr $c + 1]] $tau 1
+    set res_acf [lrange [lindex $res 5] 1 end]
+    # one list per component for tensors
+    if { [llength [lindex $res 1]] > 2 } {
+	set res_acf [lindex $res_acf $c]
+    }
+    foreach a $res_acf b $acf {
+	compare_values "$what: acf" $a $b 1
+    }
+    if { [llength $res_acf] != [llength $acf] } {
+	error "$what: [llength $res_acf] lags instead of [llength $acf]"
+    }
+}
+
+if { [ catch {
+
+setmd box_l 9 9 9
+setmd time_step 0.01
+setmd skin 0.4
+thermostat langevin 1.0 1.0
+
+inter 0 0 lennard-jones 1.0 1.0 2.5 auto 0
+
+expr srand(42)
+for {set i 0} {$i < 300} {incr i} {
+    part $i pos [expr 9*rand()] [expr 9*rand()] [expr 9*rand()]
+}
+
+foreach cap {10 20 50 100} {
+    inter ljforcecap $cap
+    integrate 200
+}
+inter ljforcecap 0
+integrate 100
+
+analyze accumulate energy start $n_lags
+analyze accumulate pressure start $n_lags
+analyze accumulate stress_tensor start $n_lags
+if { [llength [analyze accumulate]] != 3 } {
+    error "wrong list of accumulators: [analyze accumulate]"
+}
+
+set energies {}
+set pressures {}
+for {set j 0} {$j < 9} {incr j} { set tensor($j) {} }
+
+for {set i 0} {$i < 40} {incr i} {
+    integrate 10
+    lappend energies [analyze energy total]
+    lappend pressures [analyze pressure total]
+    set p [lrange [lindex [analyze stress_tensor] 0] 1 end]
+    for {set j 0} {$j < 9} {incr j} { lappend tensor($j) [lindex $p $j] }
+    # no sample without integration
+    integrate 0
+}
+
+check_component "energy" [analyze accumulate energy] 0 $energies
+check_component "pressure" [analyze accumulate pressure] 0 $pressures
+set res [analyze accumulate stress_tensor]
+for {set j 0} {$j < 9} {incr j} {
+    check_component "stress tensor $j" $res $j $tensor($j)
+}
+
+# stopped accumulators do not take samples
+analyze accumulate energy stop
+if { ![catch {analyze accumulate energy}] } {
+    error "stopped accumulator still accessible"
+}
+integrate 10
+lappend pressures [analyze pressure total]
+check_component "pressure after stop" [analyze accumulate pressure] 0 $pressures
+
+# restarting discards the samples
+analyze accumulate pressure start 3
+if { [lindex [analyze accumulate pressure] 0 1] != 0 } {
+    error "restarted accumulator has samples"
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
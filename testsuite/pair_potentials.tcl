@@ -0,0 +1,103 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Pair potentials                                           #
+#                                                           #
+# Only the pair potentials switched on for a pair of types  #
+# are calculated. The forces and energies have to follow    #
+# when potentials are switched on and off, and when new     #
+# particle types are added.                                 #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "LENNARD_JONES"
+require_feature "LJCOS"
+
+puts "----------------------------------------"
+puts "- Testcase pair_potentials.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set epsilon 1e-8
+
+proc lj_force {eps r} {
+    set frac6 [expr pow($r, -6)]
+    return [expr 48*$eps*$frac6*($frac6 - 0.5)/$r]
+}
+
+proc lj_energy {eps r} {
+    set frac6 [expr pow($r, -6)]
+    return [expr 4*$eps*$frac6*($frac6 - 1)]
+}
+
+# check the force on particle 1 along x and the total energy
+proc check {what f_ref e_ref} {
+    global epsilon
+    integrate 0
+    set f [lindex [part 1 print f] 0]
+    set e [analyze energy total]
+    if { abs($f - $f_ref) > $epsilon*(1 + abs($f_ref)) } {
+	error "$what: force is $f instead of $f_ref"
+    }
+    if { abs($e - $e_ref) > $epsilon*(1 + abs($e_ref)) } {
+	error "$what: energy is $e instead of $e_ref"
+    }
+}
+
+if { [ catch {
+
+setmd box_l 10 10 10
+setmd time_step 0.01
+setmd skin 0.3
+thermostat off
+
+set r 1.1
+part 0 pos 5 5 5 type 0
+part 1 pos [expr 5 + $r] 5 5 type 1
+
+check "no potential" 0 0
+
+inter 0 1 lennard-jones 1.0 1.0 2.5 0 0
+check "lennard-jones" [lj_force 1.0 $r] [lj_energy 1.0 $r]
+
+# a second potential for the same pair, with a cutoff below the distance
+inter 0 1 lj-cos 1.0 1.0 1.0 0
+check "lennard-jones and lj-cos" [lj_force 1.0 $r] [lj_energy 1.0 $r]
+
+inter 0 1 lennard-jones 0 0 0 0 0
+check "lennard-jones switched off" 0 0
+
+inter 0 1 lennard-jones 2.0 1.0 2.5 0 0
+check "lennard-jones switched on again" [lj_force 2.0 $r] [lj_energy 2.0 $r]
+
+# new types must not change the existing pairs
+part 2 pos 1 1 1 type 3
+check "new particle type" [lj_force 2.0 $r] [lj_energy 2.0 $r]
+
+inter 1 3 lennard-jones 1.0 1.0 2.5 0 0
+part 2 pos [expr 5 + 2*$r] 5 5
+check "potential for the new type" [expr [lj_force 2.0 $r] - [lj_force 1.0 $r]] \
+    [expr [lj_energy 2.0 $r] + [lj_energy 1.0 $r]]
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,127 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Setting up particles in bulk                              #
+#                                                           #
+# 1) part bulk has to give the same particles as part       #
+# 2) so has writemd followed by readmd                      #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+puts "----------------------------------------"
+puts "- Testcase part_bulk.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+proc dump {} {
+    global n_part
+    set res {}
+    for {set p 0} {$p < $n_part} {incr p} {
+	lappend res [part $p print id pos v f type molecule_id bonds]
+    }
+    return $res
+}
+
+proc compare {what ref res} {
+    global n_part
+    for {set p 0} {$p < $n_part} {incr p} {
+	if { [lindex $res $p] != [lindex $ref $p] } {
+	    error "$what: particle [lindex $res $p] should be [lindex $ref $p]"
+	}
+    }
+}
+
+if { [ catch {
+
+setmd box_l 10 10 10
+setmd time_step 0.01
+inter 0 harmonic 10.0 1.0
+
+# chains of 10, with the bonds pointing backwards
+set n_part 300
+set ids {}; set pos {}; set v {}; set f {}; set types {}; set mols {}; set bonds {}
+for {set p 0} {$p < $n_part} {incr p} {
+    lappend ids $p
+    lappend pos [expr 10*rand()] [expr 10*rand()] [expr 10*rand()]
+    lappend v [expr rand()-0.5] [expr rand()-0.5] [expr rand()-0.5]
+    lappend f [expr rand()-0.5] [expr rand()-0.5] [expr rand()-0.5]
+    lappend types [expr $p % 3]
+    lappend mols [expr $p / 10]
+    if { $p % 10 } { lappend bonds [list [list 0 [expr $p-1]]] } { lappend bonds {} }
+}
+
+for {set p 0} {$p < $n_part} {incr p} {
+    eval part $p pos [lrange $pos [expr 3*$p] [expr 3*$p+2]] \
+	v [lrange $v [expr 3*$p] [expr 3*$p+2]] \
+	f [lrange $f [expr 3*$p] [expr 3*$p+2]] \
+	type [lindex $types $p] molecule_id [lindex $mols $p]
+}
+for {set p 0} {$p < $n_part} {incr p} {
+    if { $p % 10 } { part $p bond 0 [expr $p-1] }
+}
+set ref [dump]
+
+# the partners are created after the bonded particles
+part deleteall
+set rpos {}; set rv {}; set rtypes {}
+for {set p [expr $n_part-1]} {$p >= 0} {incr p -1} {
+    eval lappend rpos [lrange $pos [expr 3*$p] [expr 3*$p+2]]
+    eval lappend rv [lrange $v [expr 3*$p] [expr 3*$p+2]]
+    lappend rtypes 5
+}
+part bulk [lsort -integer -decreasing $ids] pos $rpos v $rv type $rtypes
+
+# the new type has to be registered for the interactions
+if { [setmd n_part_types] != 6 } {
+    error "part bulk registered [setmd n_part_types] particle types instead of 6"
+}
+if { [has_feature "LENNARD_JONES"] } {
+    inter 5 5 lennard-jones 1.0 0.5 1.0 0.25 0
+    analyze energy
+}
+
+part bulk $ids f $f type $types molecule_id $mols bond $bonds
+compare "part bulk" $ref [dump]
+
+if { ![catch {part bulk [list $n_part] v {0 0 0}}] } {
+    error "part bulk created a particle without position"
+}
+if { [setmd n_part] != $n_part } {
+    error "part bulk created [expr [setmd n_part] - $n_part] particles without position"
+}
+
+# readmd does not know about forces, molecules and bonds
+set fd [open "part_bulk.md" w]
+writemd $fd posx posy posz vx vy vz fx fy fz type
+close $fd
+set ref [dump]
+part deleteall
+set fd [open "part_bulk.md" r]
+readmd $fd
+close $fd
+part bulk $ids molecule_id $mols bond $bonds
+compare "readmd" $ref [dump]
+exec rm -f part_bulk.md
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,114 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Rigid bonds                                               #
+#                                                           #
+# Rigid triangles and chains in a thermalized system. The   #
+# bond lengths and the relative velocities along the bonds  #
+# have to stay within the tolerances, also for molecules    #
+# across the box boundary or split between the nodes.       #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "BOND_CONSTRAINT"
+require_feature "LENNARD_JONES"
+
+puts "----------------------------------------"
+puts "- Testcase rigid_bonds.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set p_tol 1e-6
+set v_tol 1e-6
+
+# check all rigid bonds
+proc check_bonds {what} {
+    global bonds p_tol v_tol
+    foreach bond $bonds {
+	foreach {p1 p2 d} $bond break
+	set r [bond_vec_min $p1 $p2]
+	set v [vecsub [part $p1 print v] [part $p2 print v]]
+	set len [veclen $r]
+	if { abs($len - $d) > 2*$p_tol*$d } {
+	    error "$what: bond $p1-$p2 has length $len instead of $d"
+	}
+	if { abs([vecdot_product $v $r]) > 2*$v_tol } {
+	    error "$what: relative velocity [vecdot_product $v $r] along bond $p1-$p2"
+	}
+    }
+}
+
+if { [ catch {
+
+set box 12.0
+setmd box_l $box $box $box
+setmd time_step 0.005
+setmd skin 0.4
+thermostat langevin 1.0 1.0
+
+inter 0 rigid_bond 1.0 $p_tol $v_tol
+inter 0 0 lennard-jones 1.0 0.8 0.898 0.25 0
+
+# rigid chains of 5 beads and rigid triangles with a heavy corner,
+# half of the chains across the box boundary
+set bonds {}
+set n 0
+for {set k 0} {$k < 16} {incr k} {
+    set y [expr 3*($k % 4) + 0.5]
+    set z [expr 3*($k / 4) + 0.5]
+    set x0 [expr ($k % 2) ? 10.5 : 0.0]
+    for {set i 0} {$i < 5} {incr i} {
+	part $n pos [expr $x0 + $i] $y $z type 0
+	if { $i > 0 } {
+	    part $n bond 0 [expr $n - 1]
+	    lappend bonds [list $n [expr $n - 1] 1.0]
+	}
+	incr n
+    }
+    foreach dx {5.5 8.5} {
+	set x [expr $x0 + $dx]
+	part $n pos $x $y $z type 0
+	part [expr $n + 1] pos [expr $x + 1] $y $z type 0
+	part [expr $n + 2] pos [expr $x + 0.5] [expr $y + sqrt(0.75)] $z type 0
+	if { [has_feature "MASS"] } {
+	    part $n mass 4.0
+	}
+	part $n bond 0 [expr $n + 1]
+	part $n bond 0 [expr $n + 2]
+	part [expr $n + 1] bond 0 [expr $n + 2]
+	lappend bonds [list $n [expr $n + 1] 1.0] [list $n [expr $n + 2] 1.0] \
+	    [list [expr $n + 1] [expr $n + 2] 1.0]
+	incr n 3
+    }
+}
+
+foreach cs {"domain_decomposition" "nsquare"} {
+    eval cellsystem $cs
+    for {set i 0} {$i < 5} {incr i} {
+	integrate 40
+	check_bonds "$cs after [expr 40*($i + 1)] steps"
+    }
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
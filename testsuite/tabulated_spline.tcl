@@ -0,0 +1,123 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Tabulated spline interpolation                            #
+#                                                           #
+# A coarse table of the Lennard-Jones potential is          #
+# interpolated linearly and by splines. The splines have to #
+# reproduce the analytic forces and energies much better.   #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "TABULATED"
+
+puts "----------------------------------------"
+puts "- Testcase tabulated_spline.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set tabfile "tabulated_spline.tab"
+set n_points 50
+set r_min 0.9
+set r_max 2.5
+
+proc lj_force_factor {r} {
+    set frac6 [expr pow($r, -6)]
+    return [expr 48*$frac6*($frac6 - 0.5)/($r*$r)]
+}
+
+proc lj_energy {r} {
+    set frac6 [expr pow($r, -6)]
+    return [expr 4*$frac6*($frac6 - 1)]
+}
+
+# maximal deviation of force and energy from the analytic values
+# between the table points
+proc max_errors {} {
+    global r_min r_max
+    set ferr 0
+    set eerr 0
+    for {set i 0} {$i < 200} {incr i} {
+	set r [expr $r_min + ($r_max - $r_min)*($i + 0.37)/200]
+	part 1 pos [expr 5 + $r] 5 5
+	integrate 0
+	set f [lindex [part 1 print f] 0]
+	set e [analyze energy total]
+	set ferr [expr max($ferr, abs($f - $r*[lj_force_factor $r]))]
+	set eerr [expr max($eerr, abs($e - [lj_energy $r]))]
+    }
+    return [list $ferr $eerr]
+}
+
+if { [ catch {
+
+set f [open $tabfile "w"]
+puts $f "# $n_points $r_min $r_max"
+for {set i 0} {$i < $n_points} {incr i} {
+    set r [expr $r_min + ($r_max - $r_min)*$i/($n_points - 1)]
+    puts $f "$r [lj_force_factor $r] [lj_energy $r]"
+}
+close $f
+
+setmd box_l 10 10 10
+setmd time_step 0.01
+setmd skin 0.3
+thermostat off
+part 0 pos 5 5 5 type 0
+part 1 pos 6 5 5 type 0
+
+inter 0 0 tabulated $tabfile
+set linear [max_errors]
+inter 0 0 tabulated $tabfile spline
+if { [string first "spline" [inter 0 0]] == -1 } {
+    error "spline interpolation not set: [inter 0 0]"
+}
+set spline [max_errors]
+puts "maximal force and energy errors: linear $linear, spline $spline"
+
+foreach what {force energy} l $linear s $spline {
+    if { $s > 0.1*$l } {
+	error "spline interpolation of the $what is not better than linear: $s vs. $l"
+    }
+}
+
+# switching back to linear interpolation
+inter 0 0 tabulated $tabfile
+if { [max_errors] != $linear } {
+    error "linear interpolation changed after using splines"
+}
+
+# a single point has no interval to interpolate
+set f [open $tabfile w]
+puts $f "# 1 $r_min $r_min"
+puts $f "$r_min [lj_force_factor $r_min] [lj_energy $r_min]"
+close $f
+if { ![catch {inter 1 1 tabulated $tabfile spline} msg] } {
+    error "spline interpolation of a single point was accepted"
+}
+
+exec rm -f $tabfile
+
+} res ] } {
+    catch { exec rm -f $tabfile }
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,103 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Center of mass virtual sites with molecule migration      #
+#                                                           #
+# Dimers with a center of mass site move across the node    #
+# boundaries. The trajectory with                           #
+# cellsystem domain_decomposition -migrate_molecules        #
+# has to be the same as with the default cell system.       #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "VIRTUAL_SITES_COM"
+
+puts "----------------------------------------"
+puts "- Testcase virtual_sites_com.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set prec 1e-8
+
+proc setup_dimers {} {
+    global n_part
+    set id 0
+    for {set m 0} {$m < 18} {incr m} {
+	set x [expr ($m%6)*4.0+0.5]
+	set y [expr (($m/6)%3)*2.6+0.4+0.1*$m]
+	set z [expr ($m/3)*1.3+0.7]
+	part $id pos $x $y $z type 0 v [expr 2*sin($m)] [expr cos($m)] 0.3
+	incr id
+	part $id pos [expr $x+0.8] $y $z type 0 v 0.1 0 [expr -sin($m)] bond 0 [expr $id-1]
+	incr id
+	part $id pos [expr $x+0.4] $y $z type 1 virtual 1
+	incr id
+    }
+    set n_part $id
+    analyze set chains 0 18 3
+    analyze set topo_part_sync
+}
+
+proc run_dimers {} {
+    global n_part
+    integrate 0
+    for {set i 0} {$i < 4} {incr i} {
+	integrate 50
+    }
+    set res {}
+    for {set p 0} {$p < $n_part} {incr p} {
+	lappend res [part $p print pos]
+    }
+    return $res
+}
+
+if { [ catch {
+
+setmd box_l 24 8 8
+setmd node_grid [setmd n_nodes] 1 1
+setmd max_num_cells 27
+setmd time_step 0.005
+setmd skin 0.3
+thermostat off
+
+inter 0 harmonic 50.0 0.8
+inter 0 0 lennard-jones 1.0 0.8 0.898 0.25 0
+inter 1 1 lennard-jones 0.2 1.0 1.5 auto 0
+
+setup_dimers
+set ref [run_dimers]
+
+part deleteall
+cellsystem domain_decomposition -migrate_molecules
+setup_dimers
+set res [run_dimers]
+
+for {set p 0} {$p < $n_part} {incr p} {
+    set d [veclen [vecsub [lindex $res $p] [lindex $ref $p]]]
+    if { $d > $prec } {
+	error "particle $p deviates by $d with -migrate_molecules"
+    }
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
@@ -0,0 +1,121 @@
+# This file is part of the ESPResSo distribution (http://www.espresso.mpg.de).
+# It is therefore subject to the ESPResSo license agreement which you
+# accepted upon receiving the distribution and by which you are
+# legally bound while utilizing this file in any form or way.
+# There is NO WARRANTY, not even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# You should have received a copy of that license along with this
+# program; if not, refer to http://www.espresso.mpg.de/license.html
+# where its current version can be found, or write to
+# Max-Planck-Institute for Polymer Research, Theory Group, PO Box 3148,
+# 55021 Mainz, Germany.
+# Copyright (c) 2002-2006; all rights reserved unless otherwise stated.
+#
+#############################################################
+#                                                           #
+# Rigid bodies from relative virtual sites                  #
+#                                                           #
+# Two spinning bodies of six surface sites each collide.    #
+# 1) the bodies have to stay rigid                          #
+# 2) the total momentum has to be conserved                 #
+#                                                           #
+#############################################################
+
+set errf [lindex $argv 1]
+
+source "tests_common.tcl"
+
+require_feature "VIRTUAL_SITES_RELATIVE"
+require_feature "ROTATION"
+
+puts "----------------------------------------"
+puts "- Testcase virtual_sites_relative.tcl running on [format %02d [setmd n_nodes]] nodes  -"
+puts "----------------------------------------"
+
+set prec 1e-8
+
+proc momentum {} {
+    global bodies
+    set mom {0 0 0}
+    foreach b $bodies {
+	set v [part $b print v]
+	for {set i 0} {$i < 3} {incr i} {
+	    lset mom $i [expr [lindex $mom $i] + [lindex $v $i]]
+	}
+    }
+    return $mom
+}
+
+if { [ catch {
+
+setmd box_l 12 12 12
+setmd time_step 0.005
+setmd skin 0.4
+thermostat off
+
+inter 1 1 lennard-jones 1.0 1.0 1.12246 0.25 0
+
+set bodies {}
+set sites {}
+set id 0
+foreach {x vx ox} {3.5 0.5 1.0   7.0 -0.3 -2.0} {
+    part $id pos $x 6.0 6.0 type 0 v $vx 0.1 0 omega $ox 0.5 0.2
+    lappend bodies $id
+    set body $id
+    incr id
+    foreach d {{1 0 0} {-1 0 0} {0 1 0} {0 -1 0} {0 0 1} {0 0 -1}} {
+	part $id pos [expr $x+[lindex $d 0]] [expr 6.0+[lindex $d 1]] [expr 6.0+[lindex $d 2]] \
+	    type 1 virtual 1
+	part $id vs_relate_to $body
+	lappend sites $id
+	incr id
+    }
+}
+
+integrate 0
+set mom0 [momentum]
+set dist0 {}
+foreach b $bodies {
+    foreach s $sites {
+	if { [lindex [part $s print vs_relative] 0] == $b } {
+	    lappend dist0 [veclen [vecsub [part $s print pos] [part $b print pos]]]
+	}
+    }
+}
+
+for {set i 0} {$i < 20} {incr i} {
+    integrate 50
+
+    set k 0
+    foreach b $bodies {
+	foreach s $sites {
+	    if { [lindex [part $s print vs_relative] 0] == $b } {
+		set d [veclen [vecsub [part $s print pos] [part $b print pos]]]
+		if { abs($d - [lindex $dist0 $k]) > $prec } {
+		    error "site $s moved relative to body $b: $d instead of [lindex $dist0 $k]"
+		}
+		incr k
+	    }
+	}
+    }
+
+    set mom [momentum]
+    for {set j 0} {$j < 3} {incr j} {
+	if { abs([lindex $mom $j] - [lindex $mom0 $j]) > $prec } {
+	    error "momentum not conserved: $mom instead of $mom0"
+	}
+    }
+}
+
+# the bodies have to have collided
+if { [lindex [part 0 print v] 0] > 0.45 } {
+    error "bodies did not interact"
+}
+
+} res ] } {
+    error_exit $res
+}
+
+exec rm -f $errf
+
+exit 0
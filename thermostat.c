@@ -32,6 +32,7 @@ double nptiso_gamma0 = 0.0;
 double nptiso_gammav = 0.0;
 
 double langevin_pref1, langevin_pref2, langevin_pref2_rotation;
+double langevin_baoab_c1, langevin_baoab_pref;
 /** buffers for the work around for the correlated random values which cool the system,
     and require a magical heat up whenever reentering the integrator. */
 static double langevin_pref2_buffer, langevin_pref2_rotation_buffer;
@@ -82,10 +83,12 @@ int thermo_parse_langevin(Tcl_Interp *interp, int argc, char **argv)
 {
   double temp, gamma;
 
+  int baoab = 0;
+
   /* check number of arguments */
-  if (argc < 4) {
+  if (argc < 4 || argc > 5) {
     Tcl_AppendResult(interp, "wrong # args:  should be \n\"",
-		     argv[0]," ",argv[1]," <temp> <gamma>\"", (char *)NULL);
+		     argv[0]," ",argv[1]," <temp> <gamma> [baoab]\"", (char *)NULL);
     return (TCL_ERROR);
   }
 
@@ -100,10 +103,22 @@ int thermo_parse_langevin(Tcl_Interp *interp, int argc, char **argv)
     return (TCL_ERROR);
   }
 
+  if (argc == 5) {
+    if (!ARG_IS_S(4, "baoab")) {
+      Tcl_AppendResult(interp, "unknown option \"", argv[4], "\", expected baoab", (char *)NULL);
+      return (TCL_ERROR);
+    }
+    baoab = 1;
+  }
+
   /* broadcast parameters */
   temperature = temp;
   langevin_gamma = gamma;
   thermo_switch = ( thermo_switch | THERMO_LANGEVIN );
+  if (baoab)
+    thermo_switch |= THERMO_BAOAB;
+  else
+    thermo_switch &= ~THERMO_BAOAB;
   mpi_bcast_parameter(FIELD_THERMO_SWITCH);
   mpi_bcast_parameter(FIELD_TEMPERATURE);
   mpi_bcast_parameter(FIELD_LANGEVIN_GAMMA);
@@ -159,7 +174,10 @@ int thermo_print(Tcl_Interp *interp)
     Tcl_PrintDouble(interp, temperature, buffer);
     Tcl_AppendResult(interp,"{ langevin ",buffer, (char *)NULL);
     Tcl_PrintDouble(interp, langevin_gamma, buffer);
-    Tcl_AppendResult(interp," ",buffer," } ", (char *)NULL);
+    Tcl_AppendResult(interp," ",buffer, (char *)NULL);
+    if (thermo_switch & THERMO_BAOAB)
+      Tcl_AppendResult(interp," baoab", (char *)NULL);
+    Tcl_AppendResult(interp," } ", (char *)NULL);
   }
     
 #ifdef DPD
@@ -202,7 +220,7 @@ int thermo_usage(Tcl_Interp *interp, int argc, char **argv)
   Tcl_AppendResult(interp, "Usage of tcl-command thermostat:\n", (char *)NULL);
   Tcl_AppendResult(interp, "'", argv[0], "' for status return or \n ", (char *)NULL);
   Tcl_AppendResult(interp, "'", argv[0], " set off' to deactivate it (=> NVE-ensemble) \n ", (char *)NULL);
-  Tcl_AppendResult(interp, "'", argv[0], " set langevin <temp> <gamma>' or \n ", (char *)NULL);
+  Tcl_AppendResult(interp, "'", argv[0], " set langevin <temp> <gamma> [baoab]' or \n ", (char *)NULL);
 #ifdef DPD
   dpd_usage(interp,argc,argv);
 #endif
@@ -266,6 +284,11 @@ void thermo_init_langevin()
   langevin_pref1 = -langevin_gamma/time_step;
   langevin_pref2 = sqrt(24.0*temperature*langevin_gamma/time_step);
 
+  /* exact Ornstein-Uhlenbeck step over a full time step; the velocities
+     are scaled by the time step, the uniform noise has variance 1/12 */
+  langevin_baoab_c1   = exp(-langevin_gamma*time_step);
+  langevin_baoab_pref = sqrt(12.0*temperature*(1 - SQR(langevin_baoab_c1)))*time_step;
+
 #ifdef ROTATION 
   langevin_gamma_rotation = langevin_gamma/3;
   langevin_pref2_rotation = sqrt(24.0*temperature*langevin_gamma_rotation/time_step);
@@ -36,6 +36,9 @@
 #define THERMO_NPT_ISO    4
 #define THERMO_LB         8
 #define THERMO_INTER_DPD  16
+/** flag to \ref THERMO_LANGEVIN: the friction and noise are applied to the
+    velocities in the propagation (BAOAB splitting) instead of as forces. */
+#define THERMO_BAOAB      32
 
 /*@}*/
 
@@ -45,7 +48,7 @@
 
 /** Switch determining which thermostat to use. This is a or'd value
     of the different possible thermostats (defines: \ref THERMO_OFF,
-    \ref THERMO_LANGEVIN, \ref THERMO_DPD \ref THERMO_NPT_ISO). If it
+    \ref THERMO_LANGEVIN, \ref THERMO_DPD \ref THERMO_NPT_ISO, \ref THERMO_BAOAB). If it
     is zero all thermostats are switched off and the temperature is
     set to zero.  */
 extern int thermo_switch;
@@ -56,6 +59,12 @@ extern double temperature;
 /** Langevin friction coefficient gamma. */
 extern double langevin_gamma;
 
+/** BAOAB splitting: velocity damping factor \f$\exp(-\gamma\Delta t)\f$ of the O-step. */
+extern double langevin_baoab_c1;
+/** BAOAB splitting: prefactor of the (uniform) noise of the O-step, in
+    the scaled velocity units, to be divided by \f$\sqrt{m}\f$. */
+extern double langevin_baoab_pref;
+
 /** Friction coefficient for nptiso-thermostat's inline-function friction_therm0_nptiso */
 extern double nptiso_gamma0;
 /** Friction coefficient for nptiso-thermostat's inline-function friction_thermV_nptiso */
@@ -117,6 +126,7 @@ MDINLINE void friction_thermo_langevin(Particle *p)
   extern double langevin_pref1, langevin_pref2;
 
   int j;
+  double noise[4];
 #ifdef MASS
   double massf = sqrt(PMASS(*p));
 #else
@@ -144,13 +154,16 @@ MDINLINE void friction_thermo_langevin(Particle *p)
  #endif
 #endif	  
 
+  if (counter_rng_seed)
+    c_random4(p->p.identity, 0, COUNTER_RNG_LANGEVIN, noise);
   for ( j = 0 ; j < 3 ; j++) {
 #ifdef EXTERNAL_FORCES
-//    if (!(p->l.ext_flag & COORD_FIXED(j)))
+//    if (!(p->p.ext_flag & COORD_FIXED(j)))
     if (1==1)
 #endif
       {
-      p->f.f[j] = langevin_pref1*p->m.v[j]*PMASS(*p) + langevin_pref2*(d_random()-0.5)*massf;
+      p->f.f[j] = langevin_pref1*p->m.v[j]*PMASS(*p) +
+	langevin_pref2*((counter_rng_seed ? noise[j] : d_random())-0.5)*massf;
     }
 #ifdef EXTERNAL_FORCES
     else p->f.f[j] = 0;
@@ -172,6 +185,7 @@ MDINLINE void friction_thermo_langevin_rotation(Particle *p)
   extern double langevin_pref2;
 
   int j;
+  double noise[4];
 #ifdef VIRTUAL_SITES
  #ifndef VIRTUAL_SITES_THERMOSTAT
     if (ifParticleIsVirtual(p))
@@ -191,9 +205,12 @@ MDINLINE void friction_thermo_langevin_rotation(Particle *p)
    }
  #endif
 #endif	  
+      if (counter_rng_seed)
+	c_random4(p->p.identity, 0, COUNTER_RNG_ROTATION, noise);
       for ( j = 0 ; j < 3 ; j++) 
       {
-	p->f.torque[j] = -langevin_gamma*p->m.omega[j] + langevin_pref2*(d_random()-0.5);
+	p->f.torque[j] = -langevin_gamma*p->m.omega[j] +
+	  langevin_pref2*((counter_rng_seed ? noise[j] : d_random())-0.5);
       }
       ONEPART_TRACE(if(p->p.identity==check_id) fprintf(stderr,"%d: OPT: LANG f = (%.3e,%.3e,%.3e)\n",this_node,p->f.f[0],p->f.f[1],p->f.f[2]));
       THERMO_TRACE(fprintf(stderr,"%d: Thermo: P %d: force=(%.3e,%.3e,%.3e)\n",this_node,p->p.identity,p->f.f[0],p->f.f[1],p->f.f[2]));
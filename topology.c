@@ -22,6 +22,7 @@
 #include "cells.h"
 #include "communication.h"
 #include "molforces.h"
+#include "virtual_sites.h"
 
 int     n_molecules = -1;
 Molecule *topology = NULL;
@@ -116,6 +117,11 @@ void sync_topo_part_info() {
 
   topo_part_info_synced = 1;
 
+#ifdef VIRTUAL_SITES
+  /* virtual sites may depend on the molecule structure */
+  rebuild_vs_list = 1;
+#endif
+
 }
 
 int parse_sync_topo_part_info(Tcl_Interp *interp) {
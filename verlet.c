@@ -126,13 +126,13 @@ void build_verlet_lists()
 	}
 	/* Loop neighbor cell particles */
 	for(j = j_start; j < np2; j++) {
+	  dist2 = distance2(p1[i].r.p, p2[j].r.p);
+	  /* exclusions are only checked for pairs in range */
+	  if(dist2 <= max_range_non_bonded2
 #ifdef EXCLUSIONS
-          if(do_nonbonded(&p1[i], &p2[j]))
+	     && do_nonbonded(&p1[i], &p2[j])
 #endif
-	  {
-	    dist2 = distance2(p1[i].r.p, p2[j].r.p);
-	    if(dist2 <= max_range_non_bonded2) add_pair(pl, &p1[i], &p2[j]);
-	  }
+	     ) add_pair(pl, &p1[i], &p2[j]);
 	}
       }
       resize_verlet_list(pl);
@@ -158,13 +158,11 @@ void calculate_verlet_ia()
     cell = local_cells.cell[c];
     p1   = cell->part;
     np  = cell->n;
-    /* calculate bonded interactions (loop local particles) */
-    for(i = 0; i < np; i++)  {
-      add_bonded_force(&p1[i]);
 #ifdef CONSTRAINTS
+    /* calculate constraint interactions (loop local particles) */
+    for(i = 0; i < np; i++)
       add_constraints_forces(&p1[i]);
 #endif
-    }
 
     /* Loop cell neighbors */
     for (n = 0; n < dd.cell_inter[c].n_neighbors; n++) {
@@ -219,9 +217,8 @@ void build_verlet_lists_and_calc_verlet_ia()
       /* Loop cell particles */
       for(i=0; i < np1; i++) {
 	j_start = 0;
-	/* Tasks within cell: bonded forces, store old position, avoid double counting */
+	/* Tasks within cell: constraints, store old position, avoid double counting */
 	if(n == 0) {
-	  add_bonded_force(&p1[i]);
 #ifdef CONSTRAINTS
 	  add_constraints_forces(&p1[i]);
 #endif
@@ -230,14 +227,15 @@ void build_verlet_lists_and_calc_verlet_ia()
 	}
 	/* Loop neighbor cell particles */
 	for(j = j_start; j < np2; j++) {
-#ifdef EXCLUSIONS
-          if(do_nonbonded(&p1[i], &p2[j]))
-#endif
-	  {
 	  dist2 = distance2vec(p1[i].r.p, p2[j].r.p, vec21);
 
 	  VERLET_TRACE(fprintf(stderr,"%d: pair %d %d has distance %f\n",this_node,p1[i].p.identity,p2[j].p.identity,sqrt(dist2)));
-	  if(dist2 <= max_range_non_bonded2) {
+	  /* exclusions are only checked for pairs in range */
+	  if(dist2 <= max_range_non_bonded2
+#ifdef EXCLUSIONS
+	     && do_nonbonded(&p1[i], &p2[j])
+#endif
+	     ) {
 	    ONEPART_TRACE(if(p1[i].p.identity==check_id) fprintf(stderr,"%d: OPT: Verlet Pair %d %d (Cells %d,%d %d,%d dist %f)\n",this_node,p1[i].p.identity,p2[j].p.identity,c,i,n,j,sqrt(dist2)));
 	    ONEPART_TRACE(if(p2[j].p.identity==check_id) fprintf(stderr,"%d: OPT: Verlet Pair %d %d (Cells %d %d dist %f)\n",this_node,p1[i].p.identity,p2[j].p.identity,c,n,sqrt(dist2)));
 
@@ -245,7 +243,6 @@ void build_verlet_lists_and_calc_verlet_ia()
 	    /* calc non bonded interactions */
 	    add_non_bonded_pair_force(&(p1[i]), &(p2[j]), vec21, sqrt(dist2), dist2);
 	  }
-	 }
 	}
       }
       resize_verlet_list(pl);
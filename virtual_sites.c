@@ -13,6 +13,74 @@
 
 #ifdef VIRTUAL_SITES
 
+int rebuild_vs_list = 1;
+int vs_ghosts_local = 0;
+
+// Growth step for the list of virtual sites
+#define VS_LIST_INCREMENT 32
+
+// Pointers to the virtual sites among the local particles, followed by
+// those among the ghosts. Since the pointers go into the cells, the list
+// is only valid until the next resort.
+static Particle **vs_list = NULL;
+static int n_vs_list = 0;
+static int max_vs_list = 0;
+// Number of entries of vs_list which are updated, i.e. either only the
+// local virtual sites or, if vs_ghosts_local is set, all of them.
+static int n_vs_update = 0;
+
+static void append_vs_list(CellPList *cl)
+{
+  Particle *p;
+  int i, np, c;
+  Cell *cell;
+
+  for (c = 0; c < cl->n; c++) {
+    cell = cl->cell[c];
+    p  = cell->part;
+    np = cell->n;
+    for(i = 0; i < np; i++) {
+      if (ifParticleIsVirtual(&p[i])) {
+        if (n_vs_list >= max_vs_list) {
+          max_vs_list += VS_LIST_INCREMENT;
+          vs_list = (Particle **)realloc(vs_list, max_vs_list*sizeof(Particle *));
+        }
+        vs_list[n_vs_list++] = &p[i];
+      }
+    }
+  }
+}
+
+// Collect the virtual sites of the local and ghost cells into vs_list
+// and decide, whether the ghosts can be updated locally. This has to be
+// called on all nodes at the same time.
+static void update_vs_list()
+{
+  int i, n_local, missing = 0, sum;
+
+  n_vs_list = 0;
+  append_vs_list(&local_cells);
+  n_local = n_vs_list;
+  append_vs_list(&ghost_cells);
+
+  for(i = n_local; i < n_vs_list; i++)
+    if (!vs_partners_present(vs_list[i])) {
+      missing = 1;
+      break;
+    }
+  MPI_Allreduce(&missing, &sum, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  vs_ghosts_local = (sum == 0);
+
+  n_vs_update = vs_ghosts_local ? n_vs_list : n_local;
+#ifdef VIRTUAL_SITES_RELATIVE
+  setup_rigid_bodies(n_local);
+#endif
+#ifdef VIRTUAL_SITES_COM
+  setup_mol_com(n_vs_update);
+#endif
+  rebuild_vs_list = 0;
+}
+
 // The following four functions are independent of the specif
 // rules used to place virtual particles
 
@@ -28,36 +96,27 @@ void update_mol_vel_pos()
 void update_mol_vel()
 {
 #ifndef VIRTUAL_SITES_NO_VELOCITY
-  Particle *p;
-  int i, np, c;
-  Cell *cell;
-  for (c = 0; c < local_cells.n; c++) {
-    cell = local_cells.cell[c];
-    p  = cell->part;
-    np = cell->n;
-    for(i = 0; i < np; i++) {
-       if (ifParticleIsVirtual(&p[i]))
-        update_mol_vel_particle(&p[i]);
-    }
-  }
+  if (rebuild_vs_list)
+    update_vs_list();
+#ifdef VIRTUAL_SITES_RELATIVE
+  update_rigid_bodies_vel(n_vs_update);
+#endif
+#ifdef VIRTUAL_SITES_COM
+  update_mol_com_vel(n_vs_update);
+#endif
 #endif
 }
 
 void update_mol_pos()
 {
-  Particle *p;
-  int i, np, c;
-  Cell *cell;
-  for (c = 0; c < local_cells.n; c++) {
-    cell = local_cells.cell[c];
-    p  = cell->part;
-    np = cell->n;
-    for(i = 0; i < np; i++) {
-       if (ifParticleIsVirtual(&p[i]))
-        update_mol_pos_particle(&p[i]);
-    }
-    //only for real particles
-  }
+  if (rebuild_vs_list)
+    update_vs_list();
+#ifdef VIRTUAL_SITES_RELATIVE
+  update_rigid_bodies_pos(n_vs_update);
+#endif
+#ifdef VIRTUAL_SITES_COM
+  update_mol_com_pos(n_vs_update);
+#endif
 }
 
 int update_mol_pos_cfg(){
@@ -25,6 +25,17 @@
  */
 
 #ifdef VIRTUAL_SITES
+// If non-zero, the list of local virtual sites has to be rebuilt.
+// Set whenever the particles are resorted or changed.
+extern int rebuild_vs_list;
+
+// Non-zero, if on all nodes the virtual sites among the ghosts depend only
+// on particles present on the node. Then update_mol_pos(), update_mol_vel()
+// and distribute_mol_force() also handle the ghosts, so that neither the
+// virtual site positions have to be sent to the ghosts, nor the forces
+// have to be collected before distributing them.
+extern int vs_ghosts_local;
+
 // Recalculate position and velocity for all virtual particles
 void update_mol_vel_pos();
 // Recalc velocities for virtual particles
@@ -38,13 +49,17 @@ void update_mol_pos();
 int update_mol_pos_cfg();
 
 
-// The following three functions have to be provided by all implementations
+// The following four functions have to be provided by all implementations
 // of virtual sites
 // Update the vel/pos of the given virtual particle as defined by the real 
 // particles in the same molecule
 // void update_mol_pos_particle(Particle *);
 // void update_mol_vel_particle(Particle *);
 
+// Checks, if all real particles the given virtual particle depends on are
+// present on this node, either as real particles or as ghosts
+// int vs_partners_present(Particle *);
+
 // Distribute forces that have accumulated on virtual particles to the 
 // associated real particles
 //void distribute_mol_force();
@@ -15,6 +15,7 @@
 #ifdef VIRTUAL_SITES_COM
 void update_mol_vel_particle(Particle *p);
 void update_mol_pos_particle(Particle *p);
+int vs_partners_present(Particle *p_com);
 
 void calc_mol_vel(Particle *p_com,double v_com[3]);
 void calc_mol_pos(Particle *p_com,double r_com[3]);
@@ -48,23 +49,165 @@ void update_mol_pos_particle(Particle *p){
 }
 
 
-void distribute_mol_force()
+int vs_partners_present(Particle *p_com){
+   int i,mol_id;
+   mol_id=p_com->p.mol_id;
+   if (mol_id < 0 || mol_id >= n_molecules) return 0;
+   for (i=0;i<topology[mol_id].part.n;i++){
+      if (local_particles[topology[mol_id].part.e[i]]==NULL) return 0;
+   }
+   return 1;
+}
+
+// Molecules
+// ---------
+// For the integration, the real particles of the molecule of each virtual
+// site in vs_list are collected into one contiguous table of particle
+// pointers, together with the mass of the molecule. Then the center of mass
+// is calculated without going through the topology and local_particles for
+// every member in every time step. Like vs_list, the table is only valid
+// until the next resort.
+
+// The real particles of the molecule of site i of vs_list are
+// vs_mol_part[vs_mol_start[i]] ... vs_mol_part[vs_mol_start[i+1]-1]
+static Particle **vs_mol_part = NULL;
+static int max_vs_mol_part = 0;
+static int *vs_mol_start = NULL;
+static double *vs_mol_mass = NULL;
+static int max_vs_mol = 0;
+
+// Identity of the center of mass site of each molecule as found in the
+// last update of vs_list, -1 if there was none on this node
+static int *mol_com_site = NULL;
+static int n_mol_com_site = 0;
+
+// Set up the table of molecule members for the first n sites in vs_list and
+// the molecule to center of mass site cache for all of them
+void setup_mol_com(int n)
 {
-  Particle *p;
-  int i, np, c;
-  Cell *cell;
-  for (c = 0; c < local_cells.n; c++) {
-    cell = local_cells.cell[c];
-    p  = cell->part;
-    np = cell->n;
-    for(i = 0; i < np; i++) {
-      if (ifParticleIsVirtual(&p[i])) {
-         if (sqrlen(p[i].f.f)!=0){
-            put_mol_force_on_parts(&p[i]);
+   int i, j, k, mol_id;
+   Particle *p;
+
+   if (n_molecules > n_mol_com_site)
+      mol_com_site = (int *)realloc(mol_com_site, n_molecules*sizeof(int));
+   n_mol_com_site = n_molecules > 0 ? n_molecules : 0;
+   for (i = 0; i < n_mol_com_site; i++)
+      mol_com_site[i] = -1;
+   for (i = 0; i < n_vs_list; i++) {
+      mol_id = vs_list[i]->p.mol_id;
+      if (mol_id >= 0 && mol_id < n_mol_com_site)
+         mol_com_site[mol_id] = vs_list[i]->p.identity;
+   }
+
+   if (n + 1 > max_vs_mol) {
+      max_vs_mol = max_vs_list + 1;
+      vs_mol_start = (int *)realloc(vs_mol_start, max_vs_mol*sizeof(int));
+      vs_mol_mass = (double *)realloc(vs_mol_mass, max_vs_mol*sizeof(double));
+   }
+
+   k = 0;
+   for (i = 0; i < n; i++) {
+      vs_mol_start[i] = k;
+      vs_mol_mass[i] = 0;
+      mol_id = vs_list[i]->p.mol_id;
+      if (mol_id < 0 || mol_id >= n_molecules) {
+         char *errtxt = runtime_error(128 + 2*TCL_INTEGER_SPACE);
+         ERROR_SPRINTF(errtxt, "{117 virtual site %d: molecule %d does not exist} ", vs_list[i]->p.identity, mol_id);
+         continue;
+      }
+      if (k + topology[mol_id].part.n > max_vs_mol_part) {
+         max_vs_mol_part = k + topology[mol_id].part.n + VS_LIST_INCREMENT;
+         vs_mol_part = (Particle **)realloc(vs_mol_part, max_vs_mol_part*sizeof(Particle *));
+      }
+      for (j = 0; j < topology[mol_id].part.n; j++) {
+         p = local_particles[topology[mol_id].part.e[j]];
+         if (p == NULL) {
+            char *errtxt = runtime_error(128 + 3*TCL_INTEGER_SPACE);
+            ERROR_SPRINTF(errtxt, "{118 virtual site %d: particle %d of molecule %d not found} ", vs_list[i]->p.identity, topology[mol_id].part.e[j], mol_id);
+            continue;
          }
+         if (ifParticleIsVirtual(p)) {
+#ifdef VIRTUAL_SITES_DEBUG
+            if (p != vs_list[i]) {
+               char *errtxt = runtime_error(128 + 2*TCL_INTEGER_SPACE);
+               ERROR_SPRINTF(errtxt,"There is more than one COM in setup_mol_com! mol_id=%i\n",mol_id);
+            }
+#endif
+            continue;
+         }
+         vs_mol_part[k++] = p;
+         vs_mol_mass[i] += PMASS(*p);
       }
-    }
-  }
+   }
+   vs_mol_start[n] = k;
+}
+
+// Update the positions of the first n sites in vs_list. This is a local
+// version of the center of mass, because ghosts don't have image boxes.
+void update_mol_com_pos(int n)
+{
+   int i, k, j;
+   double r_com[3], vec12[3];
+   Particle *p_com, *p;
+
+   for (i = 0; i < n; i++) {
+      p_com = vs_list[i];
+      r_com[0] = r_com[1] = r_com[2] = 0.0;
+      for (k = vs_mol_start[i]; k < vs_mol_start[i+1]; k++) {
+         p = vs_mol_part[k];
+         get_mi_vector(vec12, p->r.p, p_com->r.p);
+         for (j = 0; j < 3; j++)
+            r_com[j] += PMASS(*p)*vec12[j];
+      }
+      for (j = 0; j < 3; j++)
+         p_com->r.p[j] += r_com[j]/vs_mol_mass[i];
+   }
+}
+
+// Update the velocities of the first n sites in vs_list
+void update_mol_com_vel(int n)
+{
+   int i, k, j;
+   double v_com[3];
+   Particle *p;
+
+   for (i = 0; i < n; i++) {
+      v_com[0] = v_com[1] = v_com[2] = 0.0;
+      for (k = vs_mol_start[i]; k < vs_mol_start[i+1]; k++) {
+         p = vs_mol_part[k];
+         for (j = 0; j < 3; j++)
+            v_com[j] += PMASS(*p)*p->m.v[j];
+      }
+      for (j = 0; j < 3; j++)
+         vs_list[i]->m.v[j] = v_com[j]/vs_mol_mass[i];
+   }
+}
+
+// Forces acting on the center of mass are distributed to the real
+// particles of the molecule according to their mass
+void distribute_mol_force()
+{
+   int i, k, j;
+   double force[3];
+   Particle *p_com, *p;
+
+   if (rebuild_vs_list)
+      update_vs_list();
+
+   for (i = 0; i < n_vs_update; i++) {
+      p_com = vs_list[i];
+      if (sqrlen(p_com->f.f) == 0)
+         continue;
+      for (j = 0; j < 3; j++) {
+         force[j] = p_com->f.f[j];
+         p_com->f.f[j] = 0.0;
+      }
+      for (k = vs_mol_start[i]; k < vs_mol_start[i+1]; k++) {
+         p = vs_mol_part[k];
+         for (j = 0; j < 3; j++)
+            p->f.f[j] += PMASS(*p)*force[j]/vs_mol_mass[i];
+      }
+   }
 }
 
 void calc_mol_vel(Particle *p_com,double v_com[3]){
@@ -189,6 +332,36 @@ int calc_mol_pos_cfg(Particle *p_com,double r_com[3]){
    return 1;
 }
 
+void update_mol_pos_cfg_fields(PartCfgFields *cfg){
+   int i,j,k,mol_id,*index;
+   double M,r_com[3];
+
+   index = (int *)malloc((max_seen_particle + 1)*sizeof(int));
+   for (i=0;i<=max_seen_particle;i++)
+      index[i] = -1;
+   for (i=0;i<cfg->n;i++)
+      index[cfg->identity[i]] = i;
+
+   for (i=0;i<cfg->n;i++){
+      mol_id=cfg->mol_id[i];
+      if (!cfg->isVirtual[i] || mol_id < 0 || mol_id >= n_molecules) continue;
+      M=0;
+      for (j=0;j<3;j++)
+         r_com[j]=0.0;
+      for (k=0;k<topology[mol_id].part.n;k++){
+         int p=index[topology[mol_id].part.e[k]];
+         if (p < 0 || cfg->isVirtual[p]) continue;
+         for (j=0;j<3;j++)
+            r_com[j] += cfg->mass[p]*cfg->pos[3*p+j];
+         M+=cfg->mass[p];
+      }
+      if (M > 0)
+         for (j=0;j<3;j++)
+            cfg->pos[3*i+j] = r_com[j]/M;
+   }
+   free(index);
+}
+
 void put_mol_force_on_parts(Particle *p_com){
    int i,j,mol_id;
    Particle *p;
@@ -251,6 +424,11 @@ Particle *get_mol_com_particle(Particle *calling_p){
    Particle *p;
 
    mol_id=calling_p->p.mol_id;
+   // the cache is valid as long as vs_list is
+   if (!rebuild_vs_list && mol_id >= 0 && mol_id < n_mol_com_site && mol_com_site[mol_id] >= 0) {
+      p=local_particles[mol_com_site[mol_id]];
+      if (p) return p;
+   }
    for (i=0;i<topology[mol_id].part.n;i++){
       p=local_particles[topology[mol_id].part.e[i]];
       #ifdef VIRTUAL_SITES_DEBUG
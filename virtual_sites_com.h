@@ -11,17 +11,30 @@
 
 #ifdef VIRTUAL_SITES_COM
 
-// The following three functions have to be provided by all implementations
+// The following four functions have to be provided by all implementations
 // of virtual sites
 // Update the vel/pos of the given virtual particle as defined by the real 
 // particles in the same molecule
 void update_mol_pos_particle(Particle *);
 void update_mol_vel_particle(Particle *);
 
+// Checks, if all real particles the given virtual particle depends on are
+// present on this node, either as real particles or as ghosts
+int vs_partners_present(Particle *);
+
 // Distribute forces that have accumulated on virtual particles to the 
 // associated real particles
 void distribute_mol_force();
 
+// Collect the real particles of the molecules of the first n virtual sites
+// in the list of virtual sites, and cache the center of mass site of each
+// molecule
+void setup_mol_com(int n);
+
+// Update the positions/velocities of the first n virtual sites in the list
+// of virtual sites from the collected molecule members
+void update_mol_com_pos(int n);
+void update_mol_com_vel(int n);
 
 // Gets the (first) virtual particle of the same molecule as the given (real)
 // particle
@@ -34,6 +47,11 @@ double get_mol_dist(Particle *p1,Particle *p2);
 //Distance between molecules in the partcfg data structure
 double get_mol_dist_partcfg(Particle *p1,Particle *p2);
 
+// Update the positions of the virtual sites in the compact particle data
+// from the real particles of their molecules. Needs the molecule ids,
+// masses and virtual flags besides the positions.
+void update_mol_pos_cfg_fields(PartCfgFields *cfg);
+
 
 // Unknown
 // Analyze the pressure on the molecule level
@@ -24,6 +24,13 @@ Particle* vs_relative_get_real_particle(Particle* p)
 
 
 
+// Checks, if the real particle of the given virtual particle is present
+// on this node, either as a real particle or as a ghost
+int vs_partners_present(Particle *p)
+{
+ return vs_relative_get_real_particle(p) != NULL;
+}
+
 // Update the pos of the given virtual particle as defined by the real 
 // particles in the same molecule
 void update_mol_pos_particle(Particle *p)
@@ -134,52 +141,187 @@ void update_mol_vel_particle(Particle *p)
 }
 
 
+// Rigid bodies
+// ------------
+// For the integration, the virtual sites in vs_list are grouped by their
+// real particle, so that the sites of one rigid body are contiguous. For
+// each site, the vector from the real particle to the site is stored in the
+// body-fixed frame, so that per body only one rotation matrix has to be
+// set up, instead of one quaternion multiplication per site.
+
+// Body-fixed offsets of the sites in vs_list, three per site
+static double *vs_body_offset = NULL;
+static int max_vs_body_offset = 0;
+
+static int compare_vs_body(const void *a, const void *b)
+{
+  Particle *p1 = *(Particle **)a, *p2 = *(Particle **)b;
+  if (p1->p.vs_relative_to_particle_id != p2->p.vs_relative_to_particle_id)
+    return p1->p.vs_relative_to_particle_id < p2->p.vs_relative_to_particle_id ? -1 : 1;
+  return p1->p.identity - p2->p.identity;
+}
+
+// Sort the local and the ghost part of vs_list by body, and calculate
+// the body-fixed offsets. The director of the product of the quaternions
+// of the real particle and of the site is the director of the site's
+// quaternion, rotated into the space-fixed frame of the real particle.
+void setup_rigid_bodies(int n_local)
+{
+  int i, j;
+  double u[3], l;
+
+  qsort(vs_list, n_local, sizeof(Particle *), compare_vs_body);
+  qsort(vs_list + n_local, n_vs_list - n_local, sizeof(Particle *), compare_vs_body);
+
+  if (3*n_vs_list > max_vs_body_offset) {
+    max_vs_body_offset = 3*max_vs_list;
+    vs_body_offset = (double *)realloc(vs_body_offset, max_vs_body_offset*sizeof(double));
+  }
+  for (i = 0; i < n_vs_list; i++) {
+    convert_quat_to_quatu(vs_list[i]->r.quat, u);
+    l = sqrt(sqrlen(u));
+    for (j = 0; j < 3; j++)
+      vs_body_offset[3*i + j] = u[j]/l*vs_list[i]->p.vs_relative_distance;
+  }
+}
+
+// Find the sites of the body starting at vs_list[first], and set up the
+// rotation matrix of its real particle. Returns the index after the last
+// site of the body, or -1 if the real particle is not available.
+static int get_rigid_body(int first, int n, Particle **p_real, double A[9], double *scale)
+{
+  int last, body = vs_list[first]->p.vs_relative_to_particle_id;
+  Particle *p = vs_list[first];
+  double *q;
+
+  for (last = first + 1; last < n; last++)
+    if (vs_list[last]->p.vs_relative_to_particle_id != body)
+      break;
+
+  *p_real = vs_relative_get_real_particle(p);
+  if (!*p_real) {
+    char *errtxt = runtime_error(128 + 2*TCL_INTEGER_SPACE);
+    ERROR_SPRINTF(errtxt, "{116 virtual site %d: real particle %d not found} ", p->p.identity, body);
+    return -1;
+  }
+
+  define_rotation_matrix(*p_real, A);
+  // the rotation matrix is not normalized
+  q = (*p_real)->r.quat;
+  *scale = 1.0/(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+
+  return last;
+}
+
+// Offset of site i from its real particle in the space-fixed frame
+MDINLINE void get_site_offset(int i, double A[9], double scale, double d[3])
+{
+  double *b = &vs_body_offset[3*i];
+  int j;
+  for (j = 0; j < 3; j++)
+    d[j] = scale*(A[0 + 3*j]*b[0] + A[1 + 3*j]*b[1] + A[2 + 3*j]*b[2]);
+}
+
+// Update the positions of the first n sites in vs_list
+void update_rigid_bodies_pos(int n)
+{
+  Particle *p, *p_real;
+  double A[9], scale, d[3], new_pos, tmp;
+  int first, last, i, j;
+
+  for (first = 0; first < n; first = last) {
+    last = get_rigid_body(first, n, &p_real, A, &scale);
+    if (last < 0)
+      return;
+
+    for (i = first; i < last; i++) {
+      p = vs_list[i];
+      get_site_offset(i, A, scale, d);
+      for (j = 0; j < 3; j++) {
+        new_pos = p_real->r.p[j] + d[j];
+        // Handle the case that one of the particles had gone over the periodic
+        // boundary and its coordinate has been folded
+#ifdef PARTIAL_PERIODIC
+        if (PERIODIC(j))
+#endif
+        {
+          tmp = p->r.p[j] - new_pos;
+          if (tmp > box_l[j]/2.)
+            new_pos += box_l[j];
+          else if (tmp < -box_l[j]/2.)
+            new_pos -= box_l[j];
+        }
+        p->r.p[j] = new_pos;
+      }
+    }
+  }
+}
+
+// Update the velocities of the first n sites in vs_list
+void update_rigid_bodies_vel(int n)
+{
+  Particle *p, *p_real;
+  double A[9], scale, d[3], omega[3];
+  int first, last, i, j;
+
+  for (first = 0; first < n; first = last) {
+    last = get_rigid_body(first, n, &p_real, A, &scale);
+    if (last < 0)
+      return;
+
+    // omega of the real particle in the space-fixed frame
+    for (j = 0; j < 3; j++)
+      omega[j] = A[0 + 3*j]*p_real->m.omega[0] + A[1 + 3*j]*p_real->m.omega[1] + A[2 + 3*j]*p_real->m.omega[2];
+
+    // v = v_real + omega_real \times d, espresso stores velocity * time_step
+    for (i = first; i < last; i++) {
+      p = vs_list[i];
+      get_site_offset(i, A, scale, d);
+      vector_product(omega, d, p->m.v);
+      for (j = 0; j < 3; j++)
+        p->m.v[j] = p->m.v[j]*time_step + p_real->m.v[j];
+    }
+  }
+}
+
 // Distribute forces that have accumulated on virtual particles to the 
 // associated real particles
 void distribute_mol_force()
 {
-  // Iterate over all the particles in the local cells
-  Particle *p;
-  int i, np, c;
-  Cell *cell;
-  for (c = 0; c < local_cells.n; c++) {
-    cell = local_cells.cell[c];
-    p  = cell->part;
-    np = cell->n;
-    for(i = 0; i < np; i++) {
-      // We only care about virtual particles
-      if (ifParticleIsVirtual(&p[i])) {
-       update_mol_pos(p[i]);
-
-       // First obtain the real particle responsible for this virtual particle:
-       Particle *p_real = vs_relative_get_real_particle(&p[i]);
-
-       // Get distance vector pointing from real to virtual particle, respecting periodic boundary i
-       // conditions
-       double d[3];
-       get_mi_vector(d,p[i].r.p,p_real->r.p);
-
-       // The rules for transfering forces are:
-       // F_realParticle +=F_virtualParticle
-       // T_realParticle +=f_realParticle \times (r_virtualParticle-r_realParticle)
-       
-       // Calculate torque to be added on real particle
-       double tmp[3];
-       vector_product(d,p[i].f.f,tmp);
-
-       // Add forces and torques
-       int j;
-//       printf("Particle %d gets torque from %f %f %f of particle %d\n",p_real->p.identity, p[i].f.f[0], p[i].f.f[1],p[i].f.f[2], p[i].p.identity);
-       for (j=0;j<3;j++) {
-         p_real->f.torque[j]+=tmp[j];
-//	 printf("%f ",tmp[j]);
-	 p_real->f.f[j]+=p[i].f.f[j];
-	 // Clear forces on virtual particle
-	 p[i].f.f[j]=0;
-
-       }
+  // The rules for transfering forces are:
+  // F_realParticle +=F_virtualParticle
+  // T_realParticle +=(r_virtualParticle-r_realParticle) \times F_virtualParticle
+  Particle *p, *p_real;
+  double A[9], scale, d[3], t[3], force[3], torque[3];
+  int first, last, i, j;
+
+  if (rebuild_vs_list)
+    update_vs_list();
+
+  for (first = 0; first < n_vs_update; first = last) {
+    last = get_rigid_body(first, n_vs_update, &p_real, A, &scale);
+    if (last < 0)
+      return;
+
+    for (j = 0; j < 3; j++)
+      force[j] = torque[j] = 0;
+
+    for (i = first; i < last; i++) {
+      p = vs_list[i];
+      get_site_offset(i, A, scale, d);
+      vector_product(d, p->f.f, t);
+      for (j = 0; j < 3; j++) {
+        force[j]  += p->f.f[j];
+        torque[j] += t[j];
+        // Clear forces on virtual particle
+        p->f.f[j] = 0;
       }
     }
+
+    for (j = 0; j < 3; j++) {
+      p_real->f.f[j]      += force[j];
+      p_real->f.torque[j] += torque[j];
+    }
   }
 }
 
@@ -10,17 +10,30 @@
 
 #ifdef VIRTUAL_SITES_RELATIVE
 
-// The following three functions have to be provided by all implementations
+// The following four functions have to be provided by all implementations
 // of virtual sites
 // Update the vel/pos of the given virtual particle as defined by the real 
 // particles in the same molecule
 void update_mol_pos_particle(Particle *);
 void update_mol_vel_particle(Particle *);
 
+// Checks, if all real particles the given virtual particle depends on are
+// present on this node, either as real particles or as ghosts
+int vs_partners_present(Particle *);
+
 // Distribute forces that have accumulated on virtual particles to the 
 // associated real particles
 void distribute_mol_force();
 
+// Group the virtual sites in the list of virtual sites by their real
+// particle (rigid body) and set up their body-fixed offsets
+void setup_rigid_bodies(int n_local);
+
+// Update the positions/velocities of the first n virtual sites in the list
+// of virtual sites, one rigid body at a time
+void update_rigid_bodies_pos(int n);
+void update_rigid_bodies_vel(int n);
+
 // Setup the virtual_sites_relative properties of a particle so that the given virtaul particle will follow the given real particle
 int vs_relate_to(int part_num, int relate_to);
 